@@ -1347,6 +1347,7 @@ typedef struct mz_zip_writer_staged_context
 } mz_zip_writer_staged_context;
 
 /* Adds a file to an archive piecewise. Minimum size of the raw data is 4 bytes. */
+/* Level 0 stores the data as raw deflate blocks, thus the file is still deflated, but not compressed. */
 /* Don't call mz_zip_writer_add_staged_finish() if mz_zip_writer_add_staged_open() or mz_zip_writer_add_staged_data() fails. */
 mz_bool mz_zip_writer_add_staged_open(mz_zip_archive* pZip, mz_zip_writer_staged_context* pContext, const char* pArchive_name, 
     mz_uint64 max_size, const MZ_TIME_T* pFile_time, const void* pComment, mz_uint16 comment_size, mz_uint level_and_flags,
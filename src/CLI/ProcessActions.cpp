@@ -24,7 +24,9 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Preset.hpp"
 #include <arrange-wrapper/ModelArrange.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 #include "libslic3r/Print.hpp"
+#include "libslic3r/PrintSnapshot.hpp"
 #include "libslic3r/SLAPrint.hpp"
 #include "libslic3r/Format/AMF.hpp"
 #include "libslic3r/Format/3mf.hpp"
@@ -150,7 +152,8 @@ static std::string output_filepath(const Model& model, IO::ExportFormat format,
     return proposed_path.string();
 }
 
-static bool export_models(std::vector<Model>& models, IO::ExportFormat format, const std::string& cmdline_param)
+static bool export_models(std::vector<Model>& models, IO::ExportFormat format, const std::string& cmdline_param,
+                          ThreeMFCompression compression = ThreeMFCompression::Default)
 {
     for (Model& model : models) {
         const std::string path = output_filepath(model, format, cmdline_param);
@@ -158,7 +161,7 @@ static bool export_models(std::vector<Model>& models, IO::ExportFormat format, c
         switch (format) {
         case IO::OBJ: success = Slic3r::store_obj(path.c_str(), &model);          break;
         case IO::STL: success = Slic3r::store_stl(path.c_str(), &model, true);    break;
-        case IO::TMF: success = Slic3r::store_3mf(path.c_str(), &model, nullptr, false); break;
+        case IO::TMF: success = Slic3r::store_3mf(path.c_str(), &model, nullptr, false, nullptr, true, compression); break;
         default: assert(false); break;
         }
         if (success)
@@ -315,7 +318,9 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
             return 1;
     }
     if (actions.has("export_3mf")) {
-        if (!export_models(models, IO::TMF, output))
+        const ThreeMFCompression compression = cli.misc_config.has("export_3mf_compression") ?
+            cli.misc_config.opt_enum<ThreeMFCompression>("export_3mf_compression") : ThreeMFCompression::Default;
+        if (!export_models(models, IO::TMF, output, compression))
             return 1;
     }
 
@@ -330,11 +335,23 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
             return 1;
         }
 
+        const std::string snapshot_in  = cli.input_config.has("from_snapshot") ? cli.input_config.opt_string("from_snapshot") : "";
+        const std::string snapshot_out = cli.misc_config.has("export_snapshot") ? cli.misc_config.opt_string("export_snapshot") : "";
+        if (printer_technology == ptSLA && ! (snapshot_in.empty() && snapshot_out.empty())) {
+            boost::nowide::cerr << "error: print snapshots are only supported for FFF configurations" << std::endl;
+            return 1;
+        }
+
         const Vec2crd           gap{ s_multiple_beds.get_bed_gap() };
         arr2::ArrangeBed        bed = arr2::to_arrange_bed(get_bed_shape(print_config), gap);
         arr2::ArrangeSettings   arrange_cfg;
         arrange_cfg.set_distance_from_objects(min_object_distance(print_config));
 
+        // Reuse the no-fit polygons calculated by the previous runs arranging the same parts.
+        const std::string nfp_cache = cli.misc_config.has("nfp_cache") ? cli.misc_config.opt_string("nfp_cache") : "";
+        if (! nfp_cache.empty())
+            arr2::NFPCache::instance().load(nfp_cache);
+
         for (Model& model : models) {
             // If all objects have defined instances, their relative positions will be
             // honored when printing (they will be only centered, unless --dont-arrange
@@ -347,6 +364,13 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
                 }
                 else
                     arrange_objects(model, bed, arrange_cfg);
+
+                if (! nfp_cache.empty())
+                    try {
+                        arr2::NFPCache::instance().save(nfp_cache);
+                    } catch (const std::exception &ex) {
+                        boost::nowide::cerr << "warning: " << ex.what() << std::endl;
+                    }
             }
 
             Print       fff_print;
@@ -365,10 +389,20 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
             }
 
             update_instances_outside_state(model, print_config);
-            MultipleBedsUtils::with_single_bed_model_fff(model, 0, [&print, &model, &print_config]()
-            {
-                print->apply(model, print_config);
-            });
+            try {
+                MultipleBedsUtils::with_single_bed_model_fff(model, 0, [&print, &model, &print_config, &snapshot_in, &fff_print]()
+                {
+                    if (snapshot_in.empty())
+                        print->apply(model, print_config);
+                    else
+                        // Restore the sliced objects, only the steps invalidated by the current configuration are recalculated.
+                        PrintSnapshot::load(snapshot_in, fff_print, model, print_config);
+                });
+            }
+            catch (const std::exception& ex) {
+                boost::nowide::cerr << ex.what() << std::endl;
+                return 1;
+            }
 
             std::string err = print->validate();
             if (!err.empty()) {
@@ -384,6 +418,8 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
                 try {
                 std::string outfile_final;
                 print->process();
+                if (printer_technology == ptFFF && ! snapshot_out.empty())
+                    PrintSnapshot::save(fff_print, snapshot_out);
                 if (printer_technology == ptFFF) {
                     // The outfile is processed by a PlaceholderParser.
                     const std::string input_file = fff_print.model().objects.empty() ? "" : fff_print.model().objects.front()->input_file;
@@ -68,6 +68,7 @@ struct SolverConfiguration
     
     void set_DecimationPrecision(DecimationPrecision decimation_precision);
     void set_ObjectGroupSize(int object_group_size);
+    void set_TimeLimit(int time_limit);
 
     void setup(const PrinterGeometry &printer_geometry);
 
@@ -86,7 +87,11 @@ struct SolverConfiguration
     int temporal_spread;
 
     DecimationPrecision decimation_precision;   
-    std::string optimization_timeout;    
+    std::string optimization_timeout;
+
+    // wall-clock limit of scheduling in milliseconds, 0 means no limit,
+    // objects not scheduled within the limit are left out of the schedule
+    int time_limit;
 };
 
     
@@ -181,6 +186,33 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 					const std::vector<ObjectToPrint> &objects_to_print,
 					std::vector<ScheduledPlate>      &scheduled_plates,
 					std::function<void(int)>          progress_callback = [](int progress){});
+
+/*
+  This is an incremental variant of the interface for sequential
+  scheduling/arranging.
+
+  The previous_plates are typically the result of an earlier scheduling of
+  the objects before some objects were added or changed. The objects keep
+  their positions and their printing order from the corresponding previous
+  plate as long as they remain sequentially printable there, the solver
+  then schedules only the other objects around them. Objects glued together
+  keep their placement only all together. Objects of the previous plates
+  that are not among objects_to_print are ignored.
+
+  If the time limit of the solver configuration is exceeded, the scheduling
+  stops and the scheduled plates contain the feasible schedule found so far,
+  the remaining objects are not scheduled at all. Returns true if all the
+  objects have been scheduled.
+
+  Failures are reported via exceptions as with the interface above.
+*/
+
+bool schedule_ObjectsForSequentialPrint(const SolverConfiguration         &solver_configuration,
+					const PrinterGeometry             &printer_geometry,
+					const std::vector<ObjectToPrint>  &objects_to_print,
+					const std::vector<ScheduledPlate> &previous_plates,
+					std::vector<ScheduledPlate>       &scheduled_plates,
+					std::function<void(int)>           progress_callback = [](int progress){});
     
     
 /*----------------------------------------------------------------*/
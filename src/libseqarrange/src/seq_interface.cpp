@@ -35,6 +35,8 @@ const int SEQ_MINIMUM_BOUNDING_BOX_SIZE           = 16;
 
 const int SEQ_MAX_REFINES                         =  2;
 
+const int SEQ_SCHEDULING_TIME_LIMIT               =  0;
+
 
 /*----------------------------------------------------------------*/
     
@@ -110,6 +112,7 @@ SolverConfiguration::SolverConfiguration()
     , temporal_spread(SEQ_SCHEDULING_TEMPORAL_SPREAD)
     , decimation_precision(SEQ_DECIMATION_PRECISION_LOW)
     , optimization_timeout(SEQ_Z3_SOLVER_TIMEOUT)
+    , time_limit(SEQ_SCHEDULING_TIME_LIMIT)
 {
 	/* nothing */
 }
@@ -124,6 +127,7 @@ SolverConfiguration::SolverConfiguration(const PrinterGeometry &printer_geometry
     , temporal_spread(SEQ_SCHEDULING_TEMPORAL_SPREAD)
     , decimation_precision(SEQ_DECIMATION_PRECISION_LOW)
     , optimization_timeout(SEQ_Z3_SOLVER_TIMEOUT)
+    , time_limit(SEQ_SCHEDULING_TIME_LIMIT)
 {
     setup(printer_geometry);
 }
@@ -173,6 +177,12 @@ void SolverConfiguration::set_ObjectGroupSize(int _object_group_size)
 {
     object_group_size = _object_group_size;
 }
+
+
+void SolverConfiguration::set_TimeLimit(int _time_limit)
+{
+    time_limit = _time_limit;
+}
     
     
 /*----------------------------------------------------------------*/
@@ -368,12 +378,207 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 					const std::vector<ObjectToPrint> &objects_to_print,
 					std::vector<ScheduledPlate>      &scheduled_plates,
 					std::function<void(int)>          progress_callback)
+{
+    schedule_ObjectsForSequentialPrint(solver_configuration,
+				       printer_geometry,
+				       objects_to_print,
+				       std::vector<ScheduledPlate>(),
+				       scheduled_plates,
+				       progress_callback);
+}
+
+
+/*
+  Places the objects of the previous plate at their previous positions
+  in their previous order as long as they remain sequentially printable.
+  Objects glued together are placed only all together. The placed objects
+  are moved to the front of solvable objects, returns their number.
+ */
+static unsigned int fix_PreviouslyScheduledObjects(const SolverConfiguration   &solver_configuration,
+						   const ScheduledPlate        &previous_plate,
+						   std::vector<SolvableObject> &solvable_objects,
+						   std::map<int, int>          &original_index_map,
+						   std::vector<Rational>       &dec_values_X,
+						   std::vector<Rational>       &dec_values_Y,
+						   std::vector<Rational>       &dec_values_T)
+{
+    std::map<int, int> solvable_index_map;
+    for (unsigned int i = 0; i < solvable_objects.size(); ++i)
+    {
+	solvable_index_map[solvable_objects[i].id] = i;
+    }
+
+    std::vector<unsigned int> glue_starts(solvable_objects.size());
+    for (unsigned int i = 0; i < solvable_objects.size(); ++i)
+    {
+	glue_starts[i] = (i > 0 && solvable_objects[i - 1].lepox_to_next) ? glue_starts[i - 1] : i;
+    }
+
+    std::vector<int> previous_indices;
+    std::vector<const ScheduledObject*> previous_objects;
+    
+    for (const auto& scheduled_object: previous_plate.scheduled_objects)
+    {
+	const auto& solvable_index = solvable_index_map.find(scheduled_object.id);
+	if (solvable_index != solvable_index_map.end())
+	{
+	    previous_indices.push_back(solvable_index->second);
+	    previous_objects.push_back(&scheduled_object);
+	}
+    }
+
+    /* groups of objects glued together (or single objects) that keep their placement */
+    std::vector<std::vector<unsigned int> > fixed_groups;
+    
+    for (unsigned int k = 0; k < previous_indices.size(); ++k)
+    {
+	unsigned int start = previous_indices[k];
+	if (glue_starts[start] != start)
+	{
+	    continue;
+	}
+	std::vector<unsigned int> fixed_group;
+	
+	for (unsigned int i = start; k + fixed_group.size() < previous_indices.size() && previous_indices[k + fixed_group.size()] == (int)i; ++i)
+	{
+	    fixed_group.push_back(k + fixed_group.size());
+	    
+	    if (!solvable_objects[i].lepox_to_next || i + 1 >= solvable_objects.size())
+	    {
+		break;
+	    }
+	}
+	unsigned int last = previous_indices[fixed_group.back()];
+
+	if (solvable_objects[last].lepox_to_next && last + 1 < solvable_objects.size())
+	{
+	    continue;
+	}
+	
+	bool within_plate = true;
+	for (unsigned int j = 0; j < fixed_group.size(); ++j)
+	{
+	    Slic3r::Polygon polygon = solvable_objects[previous_indices[fixed_group[j]]].polygon;
+	    polygon.scale(SEQ_SLICER_SCALE_FACTOR);
+
+	    if (!check_PolygonPositionWithinPlate(solver_configuration,
+						  SEQ_SLICER_SCALE_FACTOR,
+						  previous_objects[fixed_group[j]]->x,
+						  previous_objects[fixed_group[j]]->y,
+						  polygon))
+	    {
+		within_plate = false;
+		break;
+	    }
+	}
+	if (within_plate)
+	{
+	    fixed_groups.push_back(fixed_group);
+	}
+    }
+
+    while (!fixed_groups.empty())
+    {
+	std::vector<Slic3r::Polygon> fixed_polygons;
+	std::vector<std::vector<Slic3r::Polygon> > fixed_unreachable_polygons;
+	std::vector<Rational> fixed_X, fixed_Y, fixed_T;
+	std::vector<unsigned int> fixed_group_indices;
+	
+	int time = SEQ_GROUND_PRESENCE_TIME;
+	
+	for (unsigned int g = 0; g < fixed_groups.size(); ++g)
+	{
+	    for (unsigned int j = 0; j < fixed_groups[g].size(); ++j)
+	    {
+		const SolvableObject &solvable_object = solvable_objects[previous_indices[fixed_groups[g][j]]];
+		
+		fixed_polygons.push_back(solvable_object.polygon);
+		fixed_unreachable_polygons.push_back(solvable_object.unreachable_polygons);
+		
+		fixed_X.push_back(scaleDown_CoordinateForSequentialSolver(previous_objects[fixed_groups[g][j]]->x));
+		fixed_Y.push_back(scaleDown_CoordinateForSequentialSolver(previous_objects[fixed_groups[g][j]]->y));
+
+		time += 2 * solver_configuration.temporal_spread * solver_configuration.object_group_size;
+		fixed_T.push_back(Rational(time));
+		
+		fixed_group_indices.push_back(g);
+	    }
+	}
+
+	std::optional<std::pair<int, int> > conflict = check_PointsOutsidePolygons(fixed_X, fixed_Y, fixed_T, fixed_polygons, fixed_unreachable_polygons);
+	if (!conflict)
+	{
+	    conflict = check_PolygonLineIntersections(fixed_X, fixed_Y, fixed_T, fixed_polygons, fixed_unreachable_polygons);
+	}
+	
+	if (!conflict)
+	{
+	    std::vector<SolvableObject> next_solvable_objects;
+	    std::map<int, int> next_original_index_map;	    
+	    std::vector<bool> fixed(solvable_objects.size(), false);
+	    
+	    for (unsigned int g = 0; g < fixed_groups.size(); ++g)
+	    {
+		for (unsigned int j = 0; j < fixed_groups[g].size(); ++j)
+		{
+		    int index = previous_indices[fixed_groups[g][j]];
+		    
+		    next_original_index_map[next_solvable_objects.size()] = original_index_map[index];
+		    next_solvable_objects.push_back(solvable_objects[index]);
+		    fixed[index] = true;
+		}
+	    }
+	    dec_values_X = fixed_X;
+	    dec_values_Y = fixed_Y;
+	    dec_values_T = fixed_T;
+
+	    unsigned int fixed_objects = next_solvable_objects.size();
+	    
+	    for (unsigned int i = 0; i < solvable_objects.size(); ++i)
+	    {
+		if (!fixed[i])
+		{
+		    next_original_index_map[next_solvable_objects.size()] = original_index_map[i];
+		    next_solvable_objects.push_back(solvable_objects[i]);
+		}
+	    }
+	    solvable_objects = next_solvable_objects;
+	    original_index_map = next_original_index_map;
+
+	    return fixed_objects;
+	}
+	#ifdef DEBUG
+	{
+	    printf("Previously scheduled objects in conflict: %d, %d\n", conflict.value().first, conflict.value().second);
+	}
+	#endif
+
+	/* the later object of the conflicting pair is scheduled again */
+	fixed_groups.erase(fixed_groups.begin() + fixed_group_indices[std::max(conflict.value().first, conflict.value().second)]);
+    }
+    
+    return 0;
+}
+
+
+bool schedule_ObjectsForSequentialPrint(const SolverConfiguration         &solver_configuration,
+					const PrinterGeometry             &printer_geometry,
+					const std::vector<ObjectToPrint>  &objects_to_print,
+					const std::vector<ScheduledPlate> &previous_plates,
+					std::vector<ScheduledPlate>       &scheduled_plates,
+					std::function<void(int)>           progress_callback)
 {
     #ifdef PROFILE
     clock_t start, finish;
     start = clock();	
     #endif
 
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    if (solver_configuration.time_limit > 0)
+    {
+	deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(solver_configuration.time_limit);
+    }
+
     #ifdef DEBUG
     {
 	printf("Sequential scheduling/arranging ...\n");
@@ -440,6 +645,8 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
     int progress_object_phases_total = SEQ_MAKE_EXTRA_PROGRESS((objects_to_print.size() * SEQ_PROGRESS_PHASES_PER_OBJECT));
 
     bool trans_bed_lepox = false;
+    bool time_limit_exceeded = false;
+    unsigned int plate_index = 0;
     
     do
     {
@@ -448,6 +655,26 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 	decided_polygons.clear();
 	remaining_polygons.clear();
 
+	unsigned int fixed_objects = 0;
+
+	if (!trans_bed_lepox && plate_index < previous_plates.size())
+	{
+	    fixed_objects = fix_PreviouslyScheduledObjects(solver_configuration,
+							   previous_plates[plate_index],
+							   solvable_objects,
+							   original_index_map,
+							   poly_positions_X,
+							   poly_positions_Y,
+							   times_T);
+	    progress_object_phases_done = std::min(progress_object_phases_total,
+						   progress_object_phases_done + (int)fixed_objects * SEQ_PROGRESS_PHASES_PER_OBJECT);
+	    #ifdef DEBUG
+	    {
+		printf("  Previously scheduled objects kept: %d\n", fixed_objects);
+	    }
+	    #endif
+	}
+
 	#ifdef DEBUG
 	{
 	    printf("  Object scheduling/arranging ...\n");
@@ -461,11 +688,13 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 										       poly_positions_Y,
 										       times_T,
 										       solvable_objects,
+										       fixed_objects,
 										       trans_bed_lepox,
 										       decided_polygons,
 										       remaining_polygons,
 										       progress_object_phases_done,
 										       progress_object_phases_total,
+										       deadline,
 										       progress_callback);
 	
 	#ifdef DEBUG
@@ -539,6 +768,17 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 	}
 	else
 	{
+	    if (std::chrono::steady_clock::now() >= deadline)
+	    {
+		#ifdef DEBUG
+		{
+		    printf("Time limit exceeded, objects remaining unscheduled: %ld\n", solvable_objects.size());
+		}
+		#endif
+		time_limit_exceeded = true;
+		break;
+	    }
+	    
 	    #ifdef DEBUG
 	    {	    	    
 		printf("Polygon sequential schedule optimization FAILED.\n");
@@ -576,6 +816,7 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 	original_index_map = next_original_index_map;
 
 	scheduled_plates.push_back(scheduled_plate);
+	++plate_index;
     }
     while (!remaining_polygons.empty());
 
@@ -597,7 +838,9 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
     {
 	printf("Total CPU time: %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
     }
-    #endif   
+    #endif
+
+    return !time_limit_exceeded;
 }
 
     
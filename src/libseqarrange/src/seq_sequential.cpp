@@ -11370,6 +11370,36 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 									int                               &progress_object_phases_done,
 									int                                progress_total_object_phases,
 									std::function<void(int)>           progress_callback)
+{
+    return optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(solver_configuration,
+									      dec_values_X,
+									      dec_values_Y,
+									      dec_values_T,
+									      solvable_objects,
+									      0,
+									      trans_bed_lepox,
+									      decided_polygons,
+									      remaining_polygons,
+									      progress_object_phases_done,
+									      progress_total_object_phases,
+									      std::chrono::steady_clock::time_point::max(),
+									      progress_callback);
+}
+
+
+bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const SolverConfiguration             &solver_configuration,
+									std::vector<Rational>                 &dec_values_X,
+									std::vector<Rational>                 &dec_values_Y,
+									std::vector<Rational>                 &dec_values_T,
+									const std::vector<SolvableObject>     &solvable_objects,
+									unsigned int                           fixed_objects,
+									bool                                   trans_bed_lepox,
+									std::vector<int>                      &decided_polygons,
+									std::vector<int>                      &remaining_polygons,
+									int                                   &progress_object_phases_done,
+									int                                    progress_total_object_phases,
+									std::chrono::steady_clock::time_point  deadline,
+									std::function<void(int)>               progress_callback)
 {
     std::vector<int> undecided;
 
@@ -11380,6 +11410,18 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
     dec_values_Y.resize(solvable_objects.size());
     dec_values_T.resize(solvable_objects.size());
 
+    assert(fixed_objects <= solvable_objects.size());
+
+    /* positions and times of the fixed objects are given by the caller */
+    for (unsigned int i = 0; i < fixed_objects; ++i)
+    {
+	decided_polygons.push_back(i);
+    }
+    if (!decided_polygons.empty())
+    {
+	augment_TemporalSpread(solver_configuration, dec_values_T, decided_polygons);
+    }
+
     BoundingBox inner_half_box;
     Polygon inner_half_polygon;    
 
@@ -11420,10 +11462,32 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 	lepox_to_next.push_back(solvable_object.lepox_to_next);
     }
     
-    for (unsigned int curr_polygon = 0; curr_polygon < solvable_objects.size(); /* nothing */)
+    for (unsigned int curr_polygon = fixed_objects; curr_polygon < solvable_objects.size(); /* nothing */)
     {	
 	bool optimized = false;
-	z3::set_param("timeout", solver_configuration.optimization_timeout.c_str());
+
+	std::string optimization_timeout = solver_configuration.optimization_timeout;
+	if (deadline != std::chrono::steady_clock::time_point::max())
+	{
+	    int64_t remaining_time = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+
+	    if (remaining_time <= 0)
+	    {
+		#ifdef DEBUG
+		{
+		    printf("Time limit exceeded, remaining polygons from: %d\n", curr_polygon);
+		}
+		#endif
+		for (; curr_polygon < solvable_objects.size(); ++curr_polygon)
+		{
+		    remaining_polygons.push_back(curr_polygon);
+		}
+		return !decided_polygons.empty();
+	    }
+	    /* a single solver call must not exceed the remaining time */
+	    optimization_timeout = std::to_string(std::min<int64_t>(std::stoll(solver_configuration.optimization_timeout), remaining_time));
+	}
+	z3::set_param("timeout", optimization_timeout.c_str());
 	    
 	z3::context z_context;
 	z3::solver z_solver(z_context);
@@ -11504,7 +11568,18 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 	std::vector<int> remaining_local;	
     
 	while(object_group_size > 0)
-	{	    
+	{
+	    if (std::chrono::steady_clock::now() >= deadline)
+	    {
+		/* the untried objects of the group remain */
+		while (!undecided.empty())
+		{
+		    remaining_local.push_back(undecided.back());
+		    undecided.pop_back();
+		}
+		break;
+	    }
+	    
 	    z3::expr_vector presence_assumptions(z_context);
 	    assume_ConsequentialObjectPresence(z_context, local_dec_vars_T, undecided, missing, presence_assumptions);
 	    
@@ -11659,7 +11734,7 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 	
 	if (!optimized)
 	{
-	    if (curr_polygon <= 0)
+	    if (decided_polygons.empty())
 	    {
 		return false;
 	    }
@@ -20,6 +20,7 @@
 #include <time.h>
 
 #include <vector>
+#include <chrono>
 
 #include <unordered_map>
 
@@ -1678,6 +1679,26 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 									int                                               progress_total_object_phases,
 									std::function<void(int)>                          progress_callback = [](int progress){});    
 
+/*
+  The first fixed_objects of solvable_objects are placed at the positions and
+  times given in dec_values_X, dec_values_Y, and dec_values_T, the remaining
+  objects are scheduled around them. No further group of objects is scheduled
+  once the deadline is reached, unscheduled objects are returned as remaining.
+ */
+bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const SolverConfiguration                        &solver_configuration,
+									std::vector<Rational>                            &dec_values_X,
+									std::vector<Rational>                            &dec_values_Y,
+									std::vector<Rational>                            &dec_values_T,
+									const std::vector<SolvableObject>                &solvable_objects,
+									unsigned int                                      fixed_objects,
+									bool                                              trans_bed_lepox,
+									std::vector<int>                                 &decided_polygons,
+									std::vector<int>                                 &remaining_polygons,
+									int                                              &progress_object_phases_done,
+									int                                               progress_total_object_phases,
+									std::chrono::steady_clock::time_point             deadline,
+									std::function<void(int)>                          progress_callback = [](int progress){});
+
 /*----------------------------------------------------------------*/
 
 } // namespace Sequential
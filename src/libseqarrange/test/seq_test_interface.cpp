@@ -17,6 +17,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/ExPolygon.hpp"
@@ -1247,6 +1248,125 @@ TEST_CASE("Interface test 6", "[Sequential Arrangement Interface]")
 }
 
 
+TEST_CASE("Interface test 7", "[Sequential Arrangement Interface]")
+//void interface_test_7(void)
+{
+    #ifdef DEBUG
+    clock_t start, finish;
+    #endif
+    
+    INFO("Testing interface 7 ...");
+
+    SolverConfiguration solver_configuration;
+    solver_configuration.decimation_precision = SEQ_DECIMATION_PRECISION_LOW;
+    solver_configuration.object_group_size = 4;
+
+    std::vector<ObjectToPrint> objects_to_print = load_exported_data_from_text(arrange_data_export_text);
+    REQUIRE(objects_to_print.size() > 1);
+
+    PrinterGeometry printer_geometry;
+    int result = load_printer_geometry_from_text(printer_geometry_mk4_compatibility_text, printer_geometry);
+    REQUIRE(result == 0);
+    
+    solver_configuration.setup(printer_geometry);
+
+    /* the plate before the last object has been added */
+    std::vector<ObjectToPrint> previous_objects_to_print(objects_to_print.begin(), objects_to_print.end() - 1);
+
+    #ifdef DEBUG
+    start = clock();
+    #endif
+    
+    std::vector<ScheduledPlate> previous_plates = schedule_ObjectsForSequentialPrint(solver_configuration,
+										      printer_geometry,
+										      previous_objects_to_print);
+    REQUIRE(previous_plates.size() > 0);
+
+    #ifdef DEBUG
+    finish = clock();
+    {
+	printf("Solving time (previous objects): %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
+    }
+    start = clock();
+    #endif
+
+    std::vector<ScheduledPlate> scheduled_plates;
+    bool complete = schedule_ObjectsForSequentialPrint(solver_configuration,
+						       printer_geometry,
+						       objects_to_print,
+						       previous_plates,
+						       scheduled_plates);
+    REQUIRE(complete);
+
+    #ifdef DEBUG
+    finish = clock();
+    {
+	printf("Solving time (incremental): %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
+    }
+    #endif
+
+    unsigned int scheduled_objects = 0;
+    for (const auto& scheduled_plate: scheduled_plates)
+    {
+	scheduled_objects += scheduled_plate.scheduled_objects.size();
+    }
+    REQUIRE(scheduled_objects == objects_to_print.size());
+    
+    REQUIRE(check_ScheduledObjectsForSequentialPrintability(solver_configuration,
+							    printer_geometry,
+							    objects_to_print,
+							    scheduled_plates));
+
+    /* previously scheduled objects keep their placement and their order */
+    std::vector<int> previous_order, kept_order;
+    
+    for (const auto& previous_object: previous_plates[0].scheduled_objects)
+    {
+	for (const auto& scheduled_object: scheduled_plates[0].scheduled_objects)
+	{
+	    if (scheduled_object.id == previous_object.id)
+	    {
+		REQUIRE(scheduled_object.x == previous_object.x);
+		REQUIRE(scheduled_object.y == previous_object.y);
+	    }
+	}
+	previous_order.push_back(previous_object.id);
+    }
+    for (const auto& scheduled_object: scheduled_plates[0].scheduled_objects)
+    {
+	if (std::find(previous_order.begin(), previous_order.end(), scheduled_object.id) != previous_order.end())
+	{
+	    kept_order.push_back(scheduled_object.id);
+	}
+    }
+    REQUIRE(kept_order == previous_order);
+
+    /* the time limit leaves some objects out, the rest remains printable */
+    solver_configuration.set_TimeLimit(1);
+    
+    scheduled_plates.clear();
+    complete = schedule_ObjectsForSequentialPrint(solver_configuration,
+						  printer_geometry,
+						  objects_to_print,
+						  std::vector<ScheduledPlate>(),
+						  scheduled_plates);
+
+    scheduled_objects = 0;
+    for (const auto& scheduled_plate: scheduled_plates)
+    {
+	scheduled_objects += scheduled_plate.scheduled_objects.size();
+    }
+    REQUIRE(complete == (scheduled_objects == objects_to_print.size()));
+    
+    REQUIRE(check_ScheduledObjectsForSequentialPrintability(solver_configuration,
+							    printer_geometry,
+							    objects_to_print,
+							    scheduled_plates));
+    
+    INFO("Testing interface 7 ... finished");
+}
+
+
 /*----------------------------------------------------------------*/
 
 
@@ -8,6 +8,7 @@
 #include <libslic3r/TriangleMesh.hpp>
 #include <igl/Hit.h>
 #include <algorithm>
+#include <array>
 
 #include "admesh/stl.h"
 #include "libslic3r/Point.hpp"
@@ -46,6 +47,16 @@ public:
                                                   m_tree, s, dir, hit, m_triangle_ray_epsilon);
     }
 
+    void intersect_ray_packet(const indexed_triangle_set &its,
+                              const Vec3d *               sources,
+                              const Vec3d *               dirs,
+                              size_t                      num_rays,
+                              igl::Hit *                  hits)
+    {
+        AABBTreeIndirect::intersect_ray_packet_first_hit<RayPacketSize>(its.vertices, its.indices,
+                                                  m_tree, sources, dirs, num_rays, hits, m_triangle_ray_epsilon);
+    }
+
     void intersect_ray(const indexed_triangle_set &its,
                        const Vec3d &               s,
                        const Vec3d &               dir,
@@ -183,6 +194,46 @@ AABBMesh::query_ray_hit(const Vec3d &s, const Vec3d &dir) const
     return ret;
 }
 
+void AABBMesh::query_ray_hit_batch(const Vec3d *sources, const Vec3d *dirs, size_t num_rays, hit_result *out) const
+{
+#ifdef SLIC3R_HOLE_RAYCASTER
+    if (! m_holes.empty()) {
+        for (size_t i = 0; i < num_rays; ++ i)
+            out[i] = query_ray_hit(sources[i], dirs[i]);
+        return;
+    }
+#endif
+
+    std::array<igl::Hit, RayPacketSize> hits;
+    for (size_t packet_begin = 0; packet_begin < num_rays; packet_begin += RayPacketSize) {
+        const size_t packet_size = std::min(RayPacketSize, num_rays - packet_begin);
+        m_aabb->intersect_ray_packet(*m_tm, sources + packet_begin, dirs + packet_begin, packet_size, hits.data());
+        for (size_t i = 0; i < packet_size; ++ i) {
+            const size_t    iray = packet_begin + i;
+            const igl::Hit &hit  = hits[i];
+            assert(is_approx(dirs[iray].norm(), 1.));
+            hit_result ret(*this);
+            ret.m_t = double(hit.t);
+            ret.m_dir = dirs[iray];
+            ret.m_source = sources[iray];
+            if(!std::isinf(hit.t) && !std::isnan(hit.t)) {
+                ret.m_normal = this->normal_by_face_id(hit.id);
+                ret.m_face_id = hit.id;
+            }
+            out[iray] = ret;
+        }
+    }
+}
+
+std::vector<AABBMesh::hit_result>
+AABBMesh::query_ray_hit_batch(const std::vector<Vec3d> &sources, const std::vector<Vec3d> &dirs) const
+{
+    assert(sources.size() == dirs.size());
+    std::vector<hit_result> out(sources.size());
+    query_ray_hit_batch(sources.data(), dirs.data(), sources.size(), out.data());
+    return out;
+}
+
 std::vector<AABBMesh::hit_result>
 AABBMesh::query_ray_hits(const Vec3d &s, const Vec3d &dir) const
 {
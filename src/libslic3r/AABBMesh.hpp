@@ -126,6 +126,15 @@ public:
     // Casting a ray on the mesh, returns the distance where the hit occures.
     hit_result query_ray_hit(const Vec3d &s, const Vec3d &dir) const;
     
+    // Rays passed to query_ray_hit_batch() are cast on the mesh in packets of this size.
+    static constexpr size_t RayPacketSize = 8;
+
+    // Casting num_rays rays on the mesh at once, out[i] is the same as query_ray_hit(sources[i], dirs[i]) would return.
+    // Each packet of consecutive rays traverses the AABB tree together, which pays off if the rays of a packet
+    // are coherent, for example if they start close to each other and their directions are similar.
+    void query_ray_hit_batch(const Vec3d *sources, const Vec3d *dirs, size_t num_rays, hit_result *out) const;
+    std::vector<hit_result> query_ray_hit_batch(const std::vector<Vec3d> &sources, const std::vector<Vec3d> &dirs) const;
+
     // Casts a ray on the mesh and returns all hits
     std::vector<hit_result> query_ray_hits(const Vec3d &s, const Vec3d &dir) const;
 
@@ -11,6 +11,7 @@
 #define slic3r_AABBTreeIndirect_hpp_
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <type_traits>
 #include <vector>
@@ -666,6 +667,106 @@ namespace detail {
         }
     }
 
+	// Rays of a packet traversing the AABB tree together, see intersect_ray_packet_first_hit().
+	// The origins and the inverse directions are stored as a structure of arrays,
+	// so that testing a bounding box against all rays of the packet vectorizes.
+	template<size_t PacketSize, typename Scalar>
+	struct RayPacket {
+		std::array<Scalar, PacketSize> origin[3];
+		std::array<Scalar, PacketSize> invdir[3];
+		// Ray parameter of the closest hit found so far.
+		std::array<Scalar, PacketSize> tmax;
+	};
+
+	// Slab test of a box against all rays of a packet, returning a bit mask of the rays intersecting
+	// the box in the (0, tmax) interval. This is a branchless variant of ray_box_intersect_invdir()
+	// evaluating the same comparisons, thus producing the same results including the corner cases.
+	template<size_t PacketSize, typename Scalar, typename BoxType>
+	inline uint32_t ray_packet_box_intersect(const RayPacket<PacketSize, Scalar> &packet, const BoxType &box)
+	{
+		const Scalar bmin[3] = { Scalar(box.min().x()), Scalar(box.min().y()), Scalar(box.min().z()) };
+		const Scalar bmax[3] = { Scalar(box.max().x()), Scalar(box.max().y()), Scalar(box.max().z()) };
+		std::array<uint8_t, PacketSize> hit;
+		for (size_t i = 0; i < PacketSize; ++ i) {
+			Scalar tnear[3], tfar[3];
+			for (int axis = 0; axis < 3; ++ axis) {
+				const Scalar o   = packet.origin[axis][i];
+				const Scalar inv = packet.invdir[axis][i];
+				tnear[axis] = ((inv < 0 ? bmax[axis] : bmin[axis]) - o) * inv;
+				tfar[axis]  = ((inv < 0 ? bmin[axis] : bmax[axis]) - o) * inv;
+			}
+			bool   ret  = ! (tnear[0] > tfar[1]) & ! (tnear[1] > tfar[0]);
+			Scalar tmin = tnear[1] > tnear[0] ? tnear[1] : tnear[0];
+			Scalar tmax = tfar[1] < tfar[0] ? tfar[1] : tfar[0];
+			ret &= ! (tnear[2] > tmax) & ! (tmin > tfar[2]);
+			tmin = tnear[2] > tmin ? tnear[2] : tmin;
+			tmax = tfar[2] < tmax ? tfar[2] : tmax;
+			hit[i] = ret & (tmin < packet.tmax[i]) & (tmax > Scalar(0));
+		}
+		uint32_t mask = 0;
+		for (size_t i = 0; i < PacketSize; ++ i)
+			mask |= uint32_t(hit[i]) << i;
+		return mask;
+	}
+
+	template<size_t PacketSize, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+	inline void intersect_ray_packet_first_hit(
+		const std::vector<VertexType> 		&vertices,
+		const std::vector<IndexedFaceType> 	&faces,
+		const TreeType 						&tree,
+		const VectorType 					*origins,
+		const VectorType 					*dirs,
+		size_t 								 num_rays,
+		igl::Hit 							*hits,
+		const double 						 eps)
+	{
+		using Scalar = typename VectorType::Scalar;
+		RayPacket<PacketSize, Scalar> packet;
+		for (size_t i = 0; i < PacketSize; ++ i) {
+			// The unused lanes repeat the first ray, they are masked out.
+			const size_t iray = i < num_rays ? i : 0;
+			const VectorType invdir = dirs[iray].cwiseInverse();
+			for (int axis = 0; axis < 3; ++ axis) {
+				packet.origin[axis][i] = origins[iray][axis];
+				packet.invdir[axis][i] = invdir[axis];
+			}
+			packet.tmax[i] = std::numeric_limits<Scalar>::infinity();
+		}
+		for (size_t i = 0; i < num_rays; ++ i)
+			hits[i] = igl::Hit { -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() };
+
+		// Depth first traversal visiting the left child first, the same order as intersect_ray_recursive_first_hit()
+		// visits the nodes in. Each node is pushed with the mask of rays that intersected its parent.
+		std::array<std::pair<size_t, uint32_t>, 64> stack;
+		size_t stack_size = 0;
+		stack[stack_size ++] = { 0, num_rays == 32 ? ~uint32_t(0) : (uint32_t(1) << num_rays) - 1 };
+		while (stack_size > 0) {
+			auto [node_idx, mask] = stack[-- stack_size];
+			const auto &node = tree.node(node_idx);
+			assert(node.is_valid());
+			mask &= ray_packet_box_intersect(packet, node.bbox);
+			if (mask == 0)
+				continue;
+			if (node.is_leaf()) {
+				auto face = faces[node.idx];
+				for (size_t i = 0; i < num_rays; ++ i)
+					if (mask & (uint32_t(1) << i)) {
+						double t, u, v;
+						// The hit parameter is compared in the precision of igl::Hit::t as in intersect_ray_recursive_first_hit().
+						if (intersect_triangle(origins[i], dirs[i], vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps) &&
+							t > 0. && float(t) < packet.tmax[i]) {
+							hits[i]        = igl::Hit { int(node.idx), -1, float(u), float(v), float(t) };
+							packet.tmax[i] = Scalar(float(t));
+						}
+					}
+			} else {
+				assert(stack_size + 2 <= stack.size());
+				stack[stack_size ++] = { node_idx * 2 + 2, mask };
+				stack[stack_size ++] = { node_idx * 2 + 1, mask };
+			}
+		}
+	}
+
 } // namespace detail
 
 // Build a balanced AABB Tree over an indexed triangles set, balancing the tree
@@ -750,6 +851,42 @@ inline bool intersect_ray_first_hit(
         ray_intersector, size_t(0), std::numeric_limits<Scalar>::infinity(), hit);
 }
 
+// Find first intersections of a packet of up to PacketSize rays with indexed triangle set.
+// The rays traverse the AABB tree together: A bounding box is tested against all the rays of the packet at once
+// and the traversal descends into it if any of the rays intersects it. This pays off for coherent rays,
+// for example for rays starting close to each other and having similar directions.
+// The hits are the same as returned by intersect_ray_first_hit() for each of the rays, a ray not intersecting
+// the indexed triangle set gets a hit with id == -1 and t == infinity.
+template<size_t PacketSize, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline void intersect_ray_packet_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of num_rays rays.
+	const VectorType					*origins,
+	// Directions of num_rays rays.
+	const VectorType 					*dirs,
+	// Number of rays, at most PacketSize.
+	size_t 								 num_rays,
+	// First intersections of the rays with the indexed triangle set, num_rays items.
+	igl::Hit 							*hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+	static_assert(PacketSize <= 32, "Ray packet mask is limited to 32 rays");
+	assert(num_rays <= PacketSize);
+	if (num_rays == 0)
+		return;
+	if (tree.empty()) {
+		for (size_t i = 0; i < num_rays; ++ i)
+			hits[i] = igl::Hit { -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() };
+	} else
+		detail::intersect_ray_packet_first_hit<PacketSize>(vertices, faces, tree, origins, dirs, num_rays, hits, eps);
+}
+
 // Find all intersections of a ray with indexed triangle set.
 // Intersection test is calculated with the accuracy of VectorType::Scalar
 // even if the triangle mesh and the AABB Tree are built with floats.
@@ -92,6 +92,9 @@ void AppConfig::set_defaults()
         if (get("export_sources_full_pathnames").empty())
             set("export_sources_full_pathnames", "0");
 
+        if (get("export_3mf_compression").empty())
+            set("export_3mf_compression", "default");
+
 #ifdef _WIN32
         if (get("associate_3mf").empty())
             set("associate_3mf", "0");
@@ -5,11 +5,19 @@
 #ifndef PERFORMCSGMESHBOOLEANS_HPP
 #define PERFORMCSGMESHBOOLEANS_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stack>
+#include <utility>
 #include <vector>
 
 #include "CSGMesh.hpp"
 
+#include "libslic3r/BoundingBox.hpp"
+
 #include "libslic3r/Execution/ExecutionTBB.hpp"
 //#include "libslic3r/Execution/ExecutionSeq.hpp"
 #include "libslic3r/MeshBoolean.hpp"
@@ -42,6 +50,77 @@ MeshBoolean::cgal::CGALMeshPtr get_cgalmesh(const CSGPartT &csgpart)
     return ret;
 }
 
+// Store of the CGAL meshes of CSG parts, so that each part is converted only
+// once by the checks and the booleans of a CSG collection. The meshes are
+// keyed by the address of the part's mesh and the part's transformation, thus
+// the meshes of the parts have to outlive the cache or the cache has to be
+// cleared when they change.
+class CGALMeshCache
+{
+public:
+    // Get the CGAL mesh of a part, converted on the first request. Returns
+    // nullptr if the conversion failed. The mesh is owned by the cache and
+    // stays valid until clear() is called. Thread safe.
+    template<class CSGPartT>
+    const MeshBoolean::cgal::CGALMesh *get(const CSGPartT &csgpart)
+    {
+        Key key{csg::get_mesh(csgpart), csg::get_transform(csgpart).matrix()};
+
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto it = m_meshes.find(key);
+            if (it != m_meshes.end()) {
+                ++m_hits;
+                return it->second.get();
+            }
+
+            ++m_misses;
+        }
+
+        // Convert without holding the lock. If another thread converted the
+        // same part in the meantime, its mesh is kept.
+        MeshBoolean::cgal::CGALMeshPtr m = get_cgalmesh(csgpart);
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_meshes.emplace(std::move(key), std::move(m)).first->second.get();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_meshes.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_meshes.size();
+    }
+
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+private:
+    struct Key
+    {
+        const indexed_triangle_set *its;
+        Matrix4f                    trafo;
+
+        bool operator<(const Key &k) const
+        {
+            if (its != k.its)
+                return std::less<const indexed_triangle_set *>{}(its, k.its);
+
+            return std::lexicographical_compare(trafo.data(), trafo.data() + trafo.size(),
+                                                k.trafo.data(), k.trafo.data() + k.trafo.size());
+        }
+    };
+
+    mutable std::mutex                              m_mutex;
+    std::map<Key, MeshBoolean::cgal::CGALMeshPtr>   m_meshes;
+    std::atomic<size_t>                             m_hits{0}, m_misses{0};
+};
+
 namespace detail_cgal {
 
 using MeshBoolean::cgal::CGALMeshPtr;
@@ -69,95 +148,200 @@ inline void perform_csg(CSGType op, CGALMeshPtr &dst, CGALMeshPtr &src)
     }
 }
 
-template<class Ex, class It>
-std::vector<CGALMeshPtr> get_cgalptrs(Ex policy, const Range<It> &csgrange)
+// Operand of a CSG operation with a conservative bounding box of its volume.
+// An undefined bounding box means an empty volume.
+struct CSGOperand {
+    CGALMeshPtr   cgalptr;
+    BoundingBoxf3 bb;
+};
+
+// Same as perform_csg, but the operations which can not change the result
+// based on the bounding boxes of the operands are skipped.
+inline void perform_csg(CSGType op, CSGOperand &dst, CSGOperand &src)
 {
-    std::vector<CGALMeshPtr> ret(csgrange.size());
-    execution::for_each(policy, size_t(0), csgrange.size(),
-                        [&csgrange, &ret](size_t i) {
-        auto it = csgrange.begin();
-        std::advance(it, i);
-        auto &csgpart = *it;
-        ret[i]        = get_cgalmesh(csgpart);
-    });
+    if (!dst.cgalptr || !src.cgalptr)
+        return;
 
-    return ret;
-}
+    bool overlap = dst.bb.defined && src.bb.defined && dst.bb.intersects(src.bb);
 
-} // namespace detail
+    switch (op) {
+    case CSGType::Union:
+        if (!src.bb.defined)
+            return;
 
-// Process the sequence of CSG parts with CGAL.
-template<class It>
-void perform_csgmesh_booleans(MeshBoolean::cgal::CGALMeshPtr &cgalm,
-                              const Range<It>                &csgrange)
-{
-    using MeshBoolean::cgal::CGALMesh;
-    using MeshBoolean::cgal::CGALMeshPtr;
-    using namespace detail_cgal;
+        if (!dst.bb.defined) {
+            dst = std::move(src);
+            return;
+        }
 
-    struct Frame {
-        CSGType op; CGALMeshPtr cgalptr;
-        explicit Frame(CSGType csgop = CSGType::Union)
-            : op{csgop}
-            , cgalptr{MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{})}
-        {}
-    };
+        dst.bb.merge(src.bb);
+        break;
+    case CSGType::Difference:
+        if (!overlap)
+            return;
 
-    std::stack opstack{std::vector<Frame>{}};
+        break;
+    case CSGType::Intersection:
+        if (!overlap) {
+            dst.cgalptr = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
+            dst.bb      = {};
+            return;
+        }
 
-    opstack.push(Frame{});
+        dst.bb.min = dst.bb.min.cwiseMax(src.bb.min);
+        dst.bb.max = dst.bb.max.cwiseMin(src.bb.max);
+        break;
+    }
+
+    perform_csg(op, dst.cgalptr, src.cgalptr);
+}
 
-    std::vector<CGALMeshPtr> cgalmeshes = get_cgalptrs(ex_tbb, csgrange);
+// Node of the CSG expression built from the stack operations of the parts.
+// A leaf refers to a part, the other nodes are the parenthesized
+// subexpressions. The operations of the children are performed in order
+// starting from an empty mesh.
+struct CSGNode {
+    CSGType              op      = CSGType::Union;
+    size_t               partidx = 0;
+    std::vector<CSGNode> children;
+    bool                 is_leaf = false;
+};
+
+template<class It>
+CSGNode build_csg_tree(const Range<It> &csgrange)
+{
+    std::stack opstack{std::vector<CSGNode>{}};
+    opstack.push(CSGNode{});
 
     size_t csgidx = 0;
     for (auto &csgpart : csgrange) {
-
-        auto op = get_operation(csgpart);
-        CGALMeshPtr &cgalptr = cgalmeshes[csgidx++];
+        CSGNode leaf;
+        leaf.op      = get_operation(csgpart);
+        leaf.partidx = csgidx++;
+        leaf.is_leaf = true;
 
         if (get_stack_operation(csgpart) == CSGStackOp::Push) {
-            opstack.push(Frame{op});
-            op = CSGType::Union;
+            CSGNode group;
+            group.op = get_operation(csgpart);
+            opstack.push(std::move(group));
         }
 
-        Frame *top = &opstack.top();
+        opstack.top().children.emplace_back(std::move(leaf));
 
-        perform_csg(get_operation(csgpart), top->cgalptr, cgalptr);
-
-        if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
-            CGALMeshPtr src = std::move(top->cgalptr);
-            auto popop = opstack.top().op;
+        if (get_stack_operation(csgpart) == CSGStackOp::Pop && opstack.size() > 1) {
+            CSGNode group = std::move(opstack.top());
             opstack.pop();
-            CGALMeshPtr &dst = opstack.top().cgalptr;
-            perform_csg(popop, dst, src);
+            opstack.top().children.emplace_back(std::move(group));
         }
     }
 
-    cgalm = std::move(opstack.top().cgalptr);
+    // Groups without a pop are closed at the end of the range
+    while (opstack.size() > 1) {
+        CSGNode group = std::move(opstack.top());
+        opstack.pop();
+        opstack.top().children.emplace_back(std::move(group));
+    }
+
+    return std::move(opstack.top());
+}
+
+// Evaluate a node of the CSG expression. The subexpressions are independent
+// of each other, thus they are evaluated concurrently. The operands of the
+// leaves are taken from the operands vector.
+template<class Ex>
+CSGOperand perform_csg_node(Ex policy, CSGNode &node, std::vector<CSGOperand> &operands)
+{
+    std::vector<CSGOperand> subresults(node.children.size());
+    execution::for_each(policy, size_t(0), node.children.size(),
+                        [policy, &node, &operands, &subresults](size_t i) {
+        if (!node.children[i].is_leaf)
+            subresults[i] = perform_csg_node(policy, node.children[i], operands);
+    }, 1);
+
+    CSGOperand ret{MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{}), {}};
+
+    for (size_t i = 0; i < node.children.size(); ++i) {
+        CSGNode    &child = node.children[i];
+        CSGOperand &src   = child.is_leaf ? operands[child.partidx] : subresults[i];
+
+        perform_csg(child.op, ret, src);
+    }
+
+    return ret;
+}
+
+} // namespace detail
+
+// Process the sequence of CSG parts with CGAL. The CGAL meshes of the parts
+// are taken from the cache, converting the parts which are not cached yet.
+template<class It>
+void perform_csgmesh_booleans(MeshBoolean::cgal::CGALMeshPtr &cgalm,
+                              const Range<It>                &csgrange,
+                              CGALMeshCache                  &cache)
+{
+    using MeshBoolean::cgal::CGALMesh;
+    using namespace detail_cgal;
+
+    std::vector<CSGOperand> operands(csgrange.size());
+    execution::for_each(ex_tbb, size_t(0), csgrange.size(),
+                        [&csgrange, &cache, &operands](size_t i) {
+        auto it = csgrange.begin();
+        std::advance(it, i);
+        auto &csgpart = *it;
+
+        // The parts of stack pushes and pops may have no mesh, these all
+        // share the same key, so they are not looked up in the cache.
+        const indexed_triangle_set *its = csg::get_mesh(csgpart);
+        if (!its) {
+            operands[i].cgalptr = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
+            return;
+        }
+
+        // The booleans modify both of their operands
+        if (const CGALMesh *m = cache.get(csgpart))
+            operands[i].cgalptr = MeshBoolean::cgal::clone(*m);
+
+        operands[i].bb = bounding_box(*its, csg::get_transform(csgpart));
+    });
+
+    CSGNode tree = build_csg_tree(csgrange);
+
+    cgalm = perform_csg_node(ex_tbb, tree, operands).cgalptr;
+}
+
+// Process the sequence of CSG parts with CGAL.
+template<class It>
+void perform_csgmesh_booleans(MeshBoolean::cgal::CGALMeshPtr &cgalm,
+                              const Range<It>                &csgrange)
+{
+    CGALMeshCache cache;
+    perform_csgmesh_booleans(cgalm, csgrange, cache);
 }
 
 // Check if all requirements for doing mesh booleans are met by the input csgrange.
 // Returns the iterator to the first part which breaks criteria or csgrange.end() if all the parts
 // are ok. The Visitor vfn is called for each "bad" part.
+// The CGAL meshes of the parts are stored into the cache to be reused by
+// perform_csgmesh_booleans.
 template<class It, class Visitor>
-It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
+It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn, CGALMeshCache &cache)
 {
-    using namespace detail_cgal;
-
-    std::vector<CGALMeshPtr> cgalmeshes(csgrange.size());
-    auto check_part = [&csgrange, &cgalmeshes](size_t i)
+    // std::vector<bool> can not be written concurrently
+    std::vector<char> valid(csgrange.size(), false);
+    auto check_part = [&csgrange, &valid, &cache](size_t i)
     {
         auto it = csgrange.begin();
         std::advance(it, i);
         auto &csgpart = *it;
-        auto m = get_cgalmesh(csgpart);
 
         // mesh can be nullptr if this is a stack push or pull
         if (!get_mesh(csgpart) && get_stack_operation(csgpart) != CSGStackOp::Continue) {
-            cgalmeshes[i] = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
+            valid[i] = true;
             return;
         }
 
+        auto m = cache.get(csgpart);
+
         try {
             if (!m || MeshBoolean::cgal::empty(*m))
                 return;
@@ -170,13 +354,14 @@ It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
         }
         catch (...) { return; }
 
-        cgalmeshes[i] = std::move(m);
+        valid[i] = true;
     };
+
     execution::for_each(ex_tbb, size_t(0), csgrange.size(), check_part);
 
     It ret = csgrange.end();
     for (size_t i = 0; i < csgrange.size(); ++i) {
-        if (!cgalmeshes[i]) {
+        if (!valid[i]) {
             auto it = csgrange.begin();
             std::advance(it, i);
             vfn(it);
@@ -189,7 +374,21 @@ It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
     return ret;
 }
 
-// Overload of the previous check_csgmesh_booleans without the visitor argument
+// Overload of the previous check_csgmesh_booleans without the cache argument
+template<class It, class Visitor>
+It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
+{
+    CGALMeshCache cache;
+    return check_csgmesh_booleans(csgrange, vfn, cache);
+}
+
+// Overloads of the previous check_csgmesh_booleans without the visitor argument
+template<class It>
+It check_csgmesh_booleans(const Range<It> &csgrange, CGALMeshCache &cache)
+{
+    return check_csgmesh_booleans(csgrange, [](auto &) {}, cache);
+}
+
 template<class It>
 It check_csgmesh_booleans(const Range<It> &csgrange)
 {
@@ -197,15 +396,23 @@ It check_csgmesh_booleans(const Range<It> &csgrange)
 }
 
 template<class It>
-MeshBoolean::cgal::CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgparts)
+MeshBoolean::cgal::CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgparts,
+                                                        CGALMeshCache   &cache)
 {
     auto ret = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
     if (ret)
-        perform_csgmesh_booleans(ret, csgparts);
+        perform_csgmesh_booleans(ret, csgparts, cache);
 
     return ret;
 }
 
+template<class It>
+MeshBoolean::cgal::CGALMeshPtr perform_csgmesh_booleans(const Range<It> &csgparts)
+{
+    CGALMeshCache cache;
+    return perform_csgmesh_booleans(csgparts, cache);
+}
+
 } // namespace csg
 } // namespace Slic3r
 
@@ -11,12 +11,14 @@
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/ThumbnailData.hpp"
 #include "libslic3r/Semver.hpp"
+#include "libslic3r/Thread.hpp"
 #include "libslic3r/Time.hpp"
 
 #include "libslic3r/I18N.hpp"
 
 #include "3mf.hpp"
 
+#include <atomic>
 #include <limits>
 #include <stdexcept>
 #include <optional>
@@ -36,6 +38,19 @@
 namespace pt = boost::property_tree;
 
 #include <expat.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
 #include <Eigen/Dense>
 #include <LocalesUtils.hpp>
 
@@ -551,7 +566,9 @@ namespace Slic3r {
 
         bool _load_model_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions);
         bool _extract_relationships_from_archive(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
+        bool _create_model_xml_parser();
         bool _extract_model_from_archive(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
+        bool _extract_model_from_buffer(const mz_zip_archive_file_stat &stat, const std::vector<char> &buffer);
         bool _is_svg_shape_file(const std::string &filename) const;
         void _extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions);
         void _extract_layer_heights_profile_config_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat);
@@ -640,7 +657,12 @@ namespace Slic3r {
         bool _handle_start_config_metadata(const char** attributes, unsigned int num_attributes);
         bool _handle_end_config_metadata();
 
+        // Splits the meshes of the volumes out of the imported geometry, optionally baking the instance transformation into them.
+        // Does not modify the importer nor the model, thus the meshes of multiple objects may be created in parallel.
+        // Returns an empty string on success, otherwise the error message.
+        std::string _create_volume_meshes(const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, const Transform3d* bake_transformation, std::vector<TriangleMesh>& meshes) const;
         bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions);
+        bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, std::vector<TriangleMesh>&& meshes, ConfigSubstitutionContext& config_substitutions);
 
         // callbacks to parse the .rels file
         static void XMLCALL _handle_start_relationships_element(void *userData, const char *name, const char **attributes);
@@ -718,6 +740,35 @@ namespace Slic3r {
         XML_StopParser(m_xml_parser, false);
     }
 
+    // Maximum total size of the .model files inflated into memory at once by _load_model_from_file().
+    static constexpr mz_uint64 MAX_INFLATED_MODELS_BATCH_SIZE = 256 * 1024 * 1024;
+
+    // Inflates the archive entries stats[begin, end) into memory. A miniz reader must not be shared between threads,
+    // thus each worker opens its own reader of the archive. Returns false and clears the buffers on failure.
+    static bool inflate_archive_entries(const std::string& filename, const std::vector<mz_zip_archive_file_stat>& stats, size_t begin, size_t end, std::vector<std::vector<char>>& buffers)
+    {
+        buffers.assign(end - begin, std::vector<char>());
+        std::atomic<bool> failed(false);
+        tbb::parallel_for(tbb::blocked_range<size_t>(begin, end, 1), [&filename, &stats, begin, &buffers, &failed](const tbb::blocked_range<size_t>& range) {
+            mz_zip_archive archive;
+            mz_zip_zero_struct(&archive);
+            if (!open_zip_reader(&archive, filename)) {
+                failed = true;
+                return;
+            }
+            for (size_t i = range.begin(); i < range.end() && !failed; ++ i) {
+                std::vector<char>& buffer = buffers[i - begin];
+                buffer.resize(size_t(stats[i].m_uncomp_size));
+                if (!mz_zip_reader_extract_to_mem(&archive, stats[i].m_file_index, buffer.data(), buffer.size(), 0))
+                    failed = true;
+            }
+            close_zip_reader(&archive);
+        });
+        if (failed)
+            buffers.clear();
+        return !failed;
+    }
+
     bool _3MF_Importer::_load_model_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions)
     {
         mz_zip_archive archive;
@@ -743,35 +794,61 @@ namespace Slic3r {
         _extract_relationships_from_archive(archive, stat);
         bool found_model = false;
 
-        // we first loop the entries to read from the .model files which are not root
+        // we first loop the entries to collect the .model files which are not root
+        std::vector<mz_zip_archive_file_stat> model_stats;
         for (mz_uint i = 0; i < num_entries; ++i) {
             if (mz_zip_reader_file_stat(&archive, i, &stat)) {
                 std::string name(stat.m_filename);
                 std::replace(name.begin(), name.end(), '\\', '/');
 
                 if (boost::algorithm::iends_with(name, MODEL_EXTENSION)) {
-                    // valid model name -> extract model
-                    m_model_path = "/" + name;
-                    if (m_model_path == m_start_part_path) {
+                    if ("/" + name == m_start_part_path)
                         start_part_stat = stat;
-                        continue;
-                    }
-                    try {
-                        if (!_extract_model_from_archive(archive, stat)) {
-                            close_zip_reader(&archive);
-                            add_error("Archive does not contain a valid model");
-                            return false;
-                        }
-                    }
-                    catch (const std::exception& e)
-                    {
-                        // ensure the zip archive is closed and rethrow the exception
+                    else
+                        model_stats.emplace_back(stat);
+                }
+            }
+        }
+
+        // then read them in the order of the archive. Batches of them are inflated in parallel into memory
+        // (the XML parser fills the importer's state, thus the parsing itself stays sequential),
+        // single entries are streamed from the archive into the XML parser.
+        for (size_t begin = 0; begin < model_stats.size();) {
+            size_t end = begin + 1;
+            for (mz_uint64 batch_size = model_stats[begin].m_uncomp_size; 
+                 batch_size > 0 && end < model_stats.size() && model_stats[end].m_uncomp_size > 0 && batch_size + model_stats[end].m_uncomp_size <= MAX_INFLATED_MODELS_BATCH_SIZE; 
+                 ++ end)
+                batch_size += model_stats[end].m_uncomp_size;
+
+            std::vector<std::vector<char>> buffers;
+            if (end - begin > 1)
+                // On failure the buffers are cleared and the entries are streamed, which reports the error.
+                inflate_archive_entries(filename, model_stats, begin, end, buffers);
+
+            for (size_t i = begin; i < end; ++ i) {
+                // valid model name -> extract model
+                std::string name(model_stats[i].m_filename);
+                std::replace(name.begin(), name.end(), '\\', '/');
+                m_model_path = "/" + name;
+                try {
+                    if (!(buffers.empty() ? _extract_model_from_archive(archive, model_stats[i]) : _extract_model_from_buffer(model_stats[i], buffers[i - begin]))) {
                         close_zip_reader(&archive);
-                        throw Slic3r::FileIOError(e.what());
+                        add_error("Archive does not contain a valid model");
+                        return false;
                     }
-                    found_model = true;
                 }
+                catch (const std::exception& e)
+                {
+                    // ensure the zip archive is closed and rethrow the exception
+                    close_zip_reader(&archive);
+                    throw Slic3r::FileIOError(e.what());
+                }
+                found_model = true;
+                if (!buffers.empty())
+                    // release the inflated data as soon as possible
+                    std::vector<char>().swap(buffers[i - begin]);
             }
+            begin = end;
         }
 
         // Initialize the wipe tower position (see the end of this function):
@@ -920,7 +997,45 @@ namespace Slic3r {
             }
         }
 
-        for (const IdToModelObjectMap::value_type& object : m_objects) {
+        // Selects the volumes of an object: either those detected from the config data if this model was saved using slic3r pe,
+        // or the entire geometry as a single volume.
+        auto object_volumes = [this](const IdToModelObjectMap::value_type& object, const Geometry& geometry, ObjectMetadata::VolumeMetadataList& default_volumes)
+            -> const ObjectMetadata::VolumeMetadataList& {
+            if (IdToMetadataMap::const_iterator obj_metadata = m_objects_metadata.find(object.first.second); obj_metadata != m_objects_metadata.end())
+                return obj_metadata->second.volumes;
+            default_volumes.assign(1, ObjectMetadata::VolumeMetadata(0, (int)geometry.triangles.size() - 1));
+            return default_volumes;
+        };
+
+        // Splitting the geometry into volumes and calculating the statistics of their meshes is the expensive part
+        // of generating the volumes, while it does not modify the model. Create the meshes of all objects in parallel,
+        // then generate the volumes sequentially.
+        std::vector<const IdToModelObjectMap::value_type*> objects;
+        objects.reserve(m_objects.size());
+        for (const IdToModelObjectMap::value_type& object : m_objects)
+            objects.emplace_back(&object);
+        std::vector<std::vector<TriangleMesh>> objects_meshes(objects.size());
+        std::vector<std::string>               objects_errors(objects.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, objects.size(), 1), [this, &objects, &objects_meshes, &objects_errors, &object_volumes](const tbb::blocked_range<size_t>& range) {
+            for (size_t object_idx = range.begin(); object_idx < range.end(); ++ object_idx) {
+                const IdToModelObjectMap::value_type& object = *objects[object_idx];
+                IdToGeometryMap::const_iterator obj_geometry = m_geometries.find(object.first);
+                // Missing objects and geometries are reported by the loop below.
+                if (object.second >= int(m_model->objects.size()) || obj_geometry == m_geometries.end())
+                    continue;
+                // see _generate_volumes()
+                const ModelObject& model_object = *m_model->objects[object.second];
+                std::optional<Transform3d> bake_transformation;
+                if (m_version == 0 && model_object.instances.size() == 1)
+                    bake_transformation = model_object.instances.front()->get_transformation().get_matrix();
+                ObjectMetadata::VolumeMetadataList default_volumes;
+                objects_errors[object_idx] = _create_volume_meshes(obj_geometry->second, object_volumes(object, obj_geometry->second, default_volumes),
+                    bake_transformation ? &(*bake_transformation) : nullptr, objects_meshes[object_idx]);
+            }
+        });
+
+        for (size_t object_idx = 0; object_idx < objects.size(); ++ object_idx) {
+            const IdToModelObjectMap::value_type& object = *objects[object_idx];
             if (object.second >= int(m_model->objects.size())) {
                 add_error("Unable to find object");
                 return false;
@@ -954,9 +1069,6 @@ namespace Slic3r {
                 model_object->sla_drain_holes = std::move(obj_drain_holes->second);
             }
 
-            ObjectMetadata::VolumeMetadataList volumes;
-            ObjectMetadata::VolumeMetadataList* volumes_ptr = nullptr;
-
             IdToMetadataMap::iterator obj_metadata = m_objects_metadata.find(object.first.second);
             if (obj_metadata != m_objects_metadata.end()) {
                 // config data has been found, this model was saved using slic3r pe
@@ -968,21 +1080,16 @@ namespace Slic3r {
                     else
                         model_object->config.set_deserialize(metadata.key, metadata.value, config_substitutions);
                 }
-
-                // select object's detected volumes
-                volumes_ptr = &obj_metadata->second.volumes;
             }
-            else {
-                // config data not found, this model was not saved using slic3r pe
-
-                // add the entire geometry as the single volume to generate
-                volumes.emplace_back(0, (int)obj_geometry->second.triangles.size() - 1);
 
-                // select as volumes
-                volumes_ptr = &volumes;
+            if (! objects_errors[object_idx].empty()) {
+                add_error(objects_errors[object_idx]);
+                return false;
             }
 
-            if (!_generate_volumes(*model_object, obj_geometry->second, *volumes_ptr, config_substitutions))
+            ObjectMetadata::VolumeMetadataList default_volumes;
+            if (!_generate_volumes(*model_object, obj_geometry->second, object_volumes(object, obj_geometry->second, default_volumes),
+                    std::move(objects_meshes[object_idx]), config_substitutions))
                 return false;
 
             // Apply cut information for object if any was loaded
@@ -1095,13 +1202,8 @@ namespace Slic3r {
         return boost::starts_with(name, MODEL_FOLDER) && boost::ends_with(name, ".svg");
     }
 
-    bool _3MF_Importer::_extract_model_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat)
+    bool _3MF_Importer::_create_model_xml_parser()
     {
-        if (stat.m_uncomp_size == 0) {
-            add_error("Found invalid size");
-            return false;
-        }
-
         _destroy_xml_parser();
 
         m_xml_parser = XML_ParserCreate(nullptr);
@@ -1113,6 +1215,18 @@ namespace Slic3r {
         XML_SetUserData(m_xml_parser, (void*)this);
         XML_SetElementHandler(m_xml_parser, _3MF_Importer::_handle_start_model_xml_element, _3MF_Importer::_handle_end_model_xml_element);
         XML_SetCharacterDataHandler(m_xml_parser, _3MF_Importer::_handle_model_xml_characters);
+        return true;
+    }
+
+    bool _3MF_Importer::_extract_model_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat)
+    {
+        if (stat.m_uncomp_size == 0) {
+            add_error("Found invalid size");
+            return false;
+        }
+
+        if (!_create_model_xml_parser())
+            return false;
 
         struct CallbackData
         {
@@ -1159,6 +1273,43 @@ namespace Slic3r {
         return true;
     }
 
+    bool _3MF_Importer::_extract_model_from_buffer(const mz_zip_archive_file_stat& stat, const std::vector<char>& buffer)
+    {
+        if (buffer.empty()) {
+            add_error("Found invalid size");
+            return false;
+        }
+
+        if (!_create_model_xml_parser())
+            return false;
+
+        try
+        {
+            // The buffer is fed to expat in chunks, as XML_Parse() accepts the length as int.
+            static constexpr size_t chunk_size = 1 << 30;
+            for (size_t offset = 0; offset < buffer.size(); offset += chunk_size) {
+                const size_t n = std::min(chunk_size, buffer.size() - offset);
+                if (!XML_Parse(m_xml_parser, buffer.data() + offset, (int)n, (offset + n == buffer.size()) ? 1 : 0) || parse_error()) {
+                    char error_buf[1024];
+                    ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", parse_error_message(), stat.m_filename, (int)XML_GetCurrentLineNumber(m_xml_parser));
+                    throw Slic3r::FileIOError(error_buf);
+                }
+            }
+        }
+        catch (const version_error& e)
+        {
+            // rethrow the exception
+            throw Slic3r::FileIOError(e.what());
+        }
+        catch (std::exception& e)
+        {
+            add_error(e.what());
+            return false;
+        }
+
+        return true;
+    }
+
     void _3MF_Importer::_extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions)
     {
         if (stat.m_uncomp_size > 0) {
@@ -1802,7 +1953,12 @@ namespace Slic3r {
         bool res = true;
         unsigned int num_attributes = (unsigned int)XML_GetSpecifiedAttributeCount(m_xml_parser);
 
-        if (::strcmp(MODEL_TAG, name) == 0)
+        // vertices and triangles are by far the most frequent elements, test for them first
+        if (::strcmp(VERTEX_TAG, name) == 0)
+            res = _handle_start_vertex(attributes, num_attributes);
+        else if (::strcmp(TRIANGLE_TAG, name) == 0)
+            res = _handle_start_triangle(attributes, num_attributes);
+        else if (::strcmp(MODEL_TAG, name) == 0)
             res = _handle_start_model(attributes, num_attributes);
         else if (::strcmp(RESOURCES_TAG, name) == 0)
             res = _handle_start_resources(attributes, num_attributes);
@@ -1812,12 +1968,8 @@ namespace Slic3r {
             res = _handle_start_mesh(attributes, num_attributes);
         else if (::strcmp(VERTICES_TAG, name) == 0)
             res = _handle_start_vertices(attributes, num_attributes);
-        else if (::strcmp(VERTEX_TAG, name) == 0)
-            res = _handle_start_vertex(attributes, num_attributes);
         else if (::strcmp(TRIANGLES_TAG, name) == 0)
             res = _handle_start_triangles(attributes, num_attributes);
-        else if (::strcmp(TRIANGLE_TAG, name) == 0)
-            res = _handle_start_triangle(attributes, num_attributes);
         else if (::strcmp(COMPONENTS_TAG, name) == 0)
             res = _handle_start_components(attributes, num_attributes);
         else if (::strcmp(COMPONENT_TAG, name) == 0)
@@ -1840,7 +1992,11 @@ namespace Slic3r {
 
         bool res = true;
 
-        if (::strcmp(MODEL_TAG, name) == 0)
+        if (::strcmp(VERTEX_TAG, name) == 0)
+            res = _handle_end_vertex();
+        else if (::strcmp(TRIANGLE_TAG, name) == 0)
+            res = _handle_end_triangle();
+        else if (::strcmp(MODEL_TAG, name) == 0)
             res = _handle_end_model();
         else if (::strcmp(RESOURCES_TAG, name) == 0)
             res = _handle_end_resources();
@@ -1850,12 +2006,8 @@ namespace Slic3r {
             res = _handle_end_mesh();
         else if (::strcmp(VERTICES_TAG, name) == 0)
             res = _handle_end_vertices();
-        else if (::strcmp(VERTEX_TAG, name) == 0)
-            res = _handle_end_vertex();
         else if (::strcmp(TRIANGLES_TAG, name) == 0)
             res = _handle_end_triangles();
-        else if (::strcmp(TRIANGLE_TAG, name) == 0)
-            res = _handle_end_triangle();
         else if (::strcmp(COMPONENTS_TAG, name) == 0)
             res = _handle_end_components();
         else if (::strcmp(COMPONENT_TAG, name) == 0)
@@ -2073,10 +2225,19 @@ namespace Slic3r {
     {
         // appends the vertex coordinates
         // missing values are set equal to ZERO
-        m_curr_object.geometry.vertices.emplace_back(
-            m_unit_factor * get_attribute_value_float(attributes, num_attributes, X_ATTR),
-            m_unit_factor * get_attribute_value_float(attributes, num_attributes, Y_ATTR),
-            m_unit_factor * get_attribute_value_float(attributes, num_attributes, Z_ATTR));
+        // The vertices make up most of a model file, thus the attributes are scanned just once
+        // instead of being looked up by get_attribute_value_float() for each coordinate.
+        Vec3f vertex = Vec3f::Zero();
+        if (num_attributes % 2 == 0) {
+            for (unsigned int a = 0; a < num_attributes; a += 2) {
+                const char* key = attributes[a];
+                if (key[0] >= X_ATTR[0] && key[0] <= Z_ATTR[0] && key[1] == '\0') {
+                    const char* text = attributes[a + 1];
+                    fast_float::from_chars(text, text + strlen(text), vertex[key[0] - X_ATTR[0]]);
+                }
+            }
+        }
+        m_curr_object.geometry.vertices.emplace_back(m_unit_factor * vertex);
         return true;
     }
 
@@ -2110,22 +2271,41 @@ namespace Slic3r {
 
         // appends the triangle's vertices indices
         // missing values are set equal to ZERO
-        m_curr_object.geometry.triangles.emplace_back(
-            get_attribute_value_int(attributes, num_attributes, V1_ATTR),
-            get_attribute_value_int(attributes, num_attributes, V2_ATTR),
-            get_attribute_value_int(attributes, num_attributes, V3_ATTR));
-
-        m_curr_object.geometry.custom_supports.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SUPPORTS_ATTR));
-        m_curr_object.geometry.custom_seam.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SEAM_ATTR));
-        m_curr_object.geometry.fuzzy_skin.push_back(get_attribute_value_string(attributes, num_attributes, FUZZY_SKIN_ATTR));
-
-        // Now load MM segmentation data. Unfortunately, BambuStudio has changed the attribute name after they forked us,
+        // The triangles make up most of a model file, thus the attributes are scanned just once
+        // instead of being looked up by get_attribute_value_xxx() one by one.
+        Vec3i       triangle        = Vec3i::Zero();
+        const char* custom_supports = "";
+        const char* custom_seam     = "";
+        const char* fuzzy_skin      = "";
+        const char* mm_segmentation = "";
+        // Unfortunately, BambuStudio has changed the MM segmentation attribute name after they forked us,
         // leading to https://github.com/prusa3d/PrusaSlicer/issues/12502. Let's try to load both keys if the usual
         // one that PrusaSlicer uses is not present.
-        std::string mm_segmentation_serialized = get_attribute_value_string(attributes, num_attributes, MM_SEGMENTATION_ATTR);
-        if (mm_segmentation_serialized.empty())
-            mm_segmentation_serialized = get_attribute_value_string(attributes, num_attributes, "paint_color");
-        m_curr_object.geometry.mm_segmentation.push_back(mm_segmentation_serialized);
+        const char* paint_color     = "";
+        if (num_attributes % 2 == 0) {
+            for (unsigned int a = 0; a < num_attributes; a += 2) {
+                const char* key  = attributes[a];
+                const char* text = attributes[a + 1];
+                if (key[0] == V1_ATTR[0] && key[1] >= V1_ATTR[1] && key[1] <= V3_ATTR[1] && key[2] == '\0')
+                    boost::spirit::qi::parse(text, text + strlen(text), boost::spirit::qi::int_, triangle[key[1] - V1_ATTR[1]]);
+                else if (::strcmp(key, CUSTOM_SUPPORTS_ATTR) == 0)
+                    custom_supports = text;
+                else if (::strcmp(key, CUSTOM_SEAM_ATTR) == 0)
+                    custom_seam = text;
+                else if (::strcmp(key, FUZZY_SKIN_ATTR) == 0)
+                    fuzzy_skin = text;
+                else if (::strcmp(key, MM_SEGMENTATION_ATTR) == 0)
+                    mm_segmentation = text;
+                else if (::strcmp(key, "paint_color") == 0)
+                    paint_color = text;
+            }
+        }
+
+        m_curr_object.geometry.triangles.emplace_back(triangle);
+        m_curr_object.geometry.custom_supports.emplace_back(custom_supports);
+        m_curr_object.geometry.custom_seam.emplace_back(custom_seam);
+        m_curr_object.geometry.fuzzy_skin.emplace_back(fuzzy_skin);
+        m_curr_object.geometry.mm_segmentation.emplace_back(*mm_segmentation != '\0' ? mm_segmentation : paint_color);
 
         return true;
     }
@@ -2538,51 +2718,29 @@ namespace Slic3r {
         return true;
     }
 
-    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions)
+    std::string _3MF_Importer::_create_volume_meshes(const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, const Transform3d* bake_transformation, std::vector<TriangleMesh>& meshes) const
     {
-        if (!object.volumes.empty()) {
-            add_error("Found invalid volumes count");
-            return false;
-        }
-
         unsigned int geo_tri_count = (unsigned int)geometry.triangles.size();
-        unsigned int renamed_volumes_count = 0;
 
+        meshes.clear();
+        meshes.reserve(volumes.size());
         for (const ObjectMetadata::VolumeMetadata& volume_data : volumes) {
-            if (geo_tri_count <= volume_data.first_triangle_id || geo_tri_count <= volume_data.last_triangle_id || volume_data.last_triangle_id < volume_data.first_triangle_id) {
-                add_error("Found invalid triangle id");
-                return false;
-            }
-
-            Transform3d volume_matrix_to_object = Transform3d::Identity();
-            bool        has_transform 		    = false;
-            // extract the volume transformation from the volume's metadata, if present
-            for (const Metadata& metadata : volume_data.metadata) {
-                if (metadata.key == MATRIX_KEY) {
-                    volume_matrix_to_object = Slic3r::Geometry::transform3d_from_string(metadata.value);
-                    has_transform 			= ! volume_matrix_to_object.isApprox(Transform3d::Identity(), 1e-10);
-                    break;
-                }
-            }
+            if (geo_tri_count <= volume_data.first_triangle_id || geo_tri_count <= volume_data.last_triangle_id || volume_data.last_triangle_id < volume_data.first_triangle_id)
+                return "Found invalid triangle id";
 
             // splits volume out of imported geometry
             indexed_triangle_set its;
             its.indices.assign(geometry.triangles.begin() + volume_data.first_triangle_id, geometry.triangles.begin() + volume_data.last_triangle_id + 1);
-            const size_t triangles_count = its.indices.size();
-            if (triangles_count == 0) {
-                add_error("An empty triangle mesh found");
-                return false;
-            }
+            if (its.indices.empty())
+                return "An empty triangle mesh found";
 
             {
                 int min_id = its.indices.front()[0];
                 int max_id = min_id;
                 for (const Vec3i& face : its.indices) {
                     for (const int tri_id : face) {
-                        if (tri_id < 0 || tri_id >= int(geometry.vertices.size())) {
-                            add_error("Found invalid vertex id");
-                            return false;
-                        }
+                        if (tri_id < 0 || tri_id >= int(geometry.vertices.size()))
+                            return "Found invalid vertex id";
                         min_id = std::min(min_id, tri_id);
                         max_id = std::max(max_id, tri_id);
                     }
@@ -2603,21 +2761,65 @@ namespace Slic3r {
                 its_compactify_vertices(its, true);
 
             TriangleMesh triangle_mesh(std::move(its), volume_data.mesh_stats);
+            // The transformation is only baked into the first volume, as the instance transformation is reset
+            // right after that, see _generate_volumes().
+            if (bake_transformation != nullptr && meshes.empty())
+                //FIXME do the mesh fixing?
+                triangle_mesh.transform(*bake_transformation, false);
+            if (triangle_mesh.volume() < 0)
+                triangle_mesh.flip_triangles();
+            meshes.emplace_back(std::move(triangle_mesh));
+        }
+
+        return {};
+    }
+
+    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions)
+    {
+        // if the 3mf was not produced by PrusaSlicer and there is only one instance,
+        // bake the transformation into the geometry to allow the reload from disk command
+        // to work properly
+        std::optional<Transform3d> bake_transformation;
+        if (m_version == 0 && object.instances.size() == 1)
+            bake_transformation = object.instances.front()->get_transformation().get_matrix();
+
+        std::vector<TriangleMesh> meshes;
+        if (std::string error = _create_volume_meshes(geometry, volumes, bake_transformation ? &(*bake_transformation) : nullptr, meshes); ! error.empty()) {
+            add_error(error);
+            return false;
+        }
+        return _generate_volumes(object, geometry, volumes, std::move(meshes), config_substitutions);
+    }
+
+    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, std::vector<TriangleMesh>&& meshes, ConfigSubstitutionContext& config_substitutions)
+    {
+        if (!object.volumes.empty() || meshes.size() != volumes.size()) {
+            add_error("Found invalid volumes count");
+            return false;
+        }
 
-            if (m_version == 0) {
-                // if the 3mf was not produced by PrusaSlicer and there is only one instance,
-                // bake the transformation into the geometry to allow the reload from disk command
-                // to work properly
-                if (object.instances.size() == 1) {
-                    triangle_mesh.transform(object.instances.front()->get_transformation().get_matrix(), false);
-                    object.instances.front()->set_transformation(Slic3r::Geometry::Transformation());
-                    //FIXME do the mesh fixing?
+        // The instance transformation has been baked into the mesh of the first volume by _create_volume_meshes().
+        if (m_version == 0 && object.instances.size() == 1)
+            object.instances.front()->set_transformation(Slic3r::Geometry::Transformation());
+
+        unsigned int renamed_volumes_count = 0;
+
+        for (size_t volume_idx = 0; volume_idx < volumes.size(); ++ volume_idx) {
+            const ObjectMetadata::VolumeMetadata& volume_data = volumes[volume_idx];
+            const size_t triangles_count = meshes[volume_idx].its.indices.size();
+
+            Transform3d volume_matrix_to_object = Transform3d::Identity();
+            bool        has_transform 		    = false;
+            // extract the volume transformation from the volume's metadata, if present
+            for (const Metadata& metadata : volume_data.metadata) {
+                if (metadata.key == MATRIX_KEY) {
+                    volume_matrix_to_object = Slic3r::Geometry::transform3d_from_string(metadata.value);
+                    has_transform 			= ! volume_matrix_to_object.isApprox(Transform3d::Identity(), 1e-10);
+                    break;
                 }
             }
-            if (triangle_mesh.volume() < 0)
-                triangle_mesh.flip_triangles();
 
-			ModelVolume* volume = object.add_volume(std::move(triangle_mesh));
+			ModelVolume* volume = object.add_volume(std::move(meshes[volume_idx]));
             // stores the volume matrix taken from the metadata, if present
             if (has_transform)
                 volume->source.transform = Slic3r::Geometry::Transformation(volume_matrix_to_object);
@@ -2773,9 +2975,11 @@ namespace Slic3r {
 
         bool m_fullpath_sources{ true };
         bool m_zip64 { true };
+        // Compression level or MZ_DEFAULT_COMPRESSION, passed to miniz for all the files stored into the archive.
+        int  m_compression_level { MZ_DEFAULT_COMPRESSION };
 
     public:
-        bool save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64);
+        bool save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64, ThreeMFCompression compression);
         static void add_transformation(std::stringstream &stream, const Transform3d &tr);
     private:
         void _publish(Model &model);
@@ -2798,11 +3002,18 @@ namespace Slic3r {
         bool _add_wipe_tower_information_file_to_archive( mz_zip_archive& archive, Model& model);
     };
 
-    bool _3MF_Exporter::save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64)
+    bool _3MF_Exporter::save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64, ThreeMFCompression compression)
     {
         clear_errors();
         m_fullpath_sources = fullpath_sources;
         m_zip64 = zip64;
+        switch (compression) {
+        case ThreeMFCompression::Store:   m_compression_level = MZ_NO_COMPRESSION; break;
+        case ThreeMFCompression::Fast:    m_compression_level = MZ_BEST_SPEED; break;
+        case ThreeMFCompression::Best:    m_compression_level = MZ_BEST_COMPRESSION; break;
+        case ThreeMFCompression::Default:
+        default:                          m_compression_level = MZ_DEFAULT_COMPRESSION; break;
+        }
         return _save_model_to_file(filename, model, config, thumbnail_data);
     }
 
@@ -2955,7 +3166,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, CONTENT_TYPES_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, CONTENT_TYPES_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add content types file to archive");
             return false;
         }
@@ -2968,9 +3179,9 @@ namespace Slic3r {
         bool res = false;
 
         size_t png_size = 0;
-        void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_LEVEL, 1);
+        void* png_data = write_png_to_memory_parallel((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_LEVEL, true);
         if (png_data != nullptr) {
-            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, MZ_DEFAULT_COMPRESSION);
+            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, m_compression_level);
             mz_free(png_data);
         }
 
@@ -2991,7 +3202,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, RELATIONSHIPS_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, RELATIONSHIPS_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add relationships file to archive");
             return false;
         }
@@ -3021,7 +3232,7 @@ namespace Slic3r {
                 // Maximum expected 3MF file size is 4GB-1. This is a workaround for interoperability with Windows 10 3D model fixing API, see
                 // GH issue #6193.
                 (uint64_t(1) << 32) - 1,
-            nullptr, nullptr, 0, MZ_DEFAULT_COMPRESSION, nullptr, 0, nullptr, 0)) {
+            nullptr, nullptr, 0, m_compression_level, nullptr, 0, nullptr, 0)) {
             add_error("Unable to add model file to archive");
             return false;
         }
@@ -3178,23 +3389,26 @@ namespace Slic3r {
 
     bool _3MF_Exporter::_add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets)
     {
-        std::string output_buffer;
-        output_buffer += "   <";
-        output_buffer += MESH_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n";
-
-        auto flush = [this, &output_buffer, &context](bool force = false) {
-            if ((force && ! output_buffer.empty()) || output_buffer.size() >= 65536 * 16) {
-                if (! mz_zip_writer_add_staged_data(&context, output_buffer.data(), output_buffer.size())) {
-                    add_error("Error during writing or compression");
-                    return false;
-                }
-                output_buffer.clear();
+        // Store geometry of all ModelVolumes into a single indexed triangle set, calculate offsets of the ModelVolumes in there.
+        unsigned int vertices_count  = 0;
+        unsigned int triangles_count = 0;
+        for (ModelVolume* volume : object.volumes) {
+            if (volume == nullptr)
+                continue;
+
+            const indexed_triangle_set &its = volume->mesh().its;
+            if (its.vertices.empty()) {
+                add_error("Found invalid mesh");
+                return false;
             }
-            return true;
-        };
+
+            Offsets &offsets = volumes_offsets.insert({ volume, Offsets(vertices_count) }).first->second;
+            vertices_count += (int)its.vertices.size();
+            // updates triangle offsets
+            offsets.first_triangle_id = triangles_count;
+            triangles_count += (int)its.indices.size();
+            offsets.last_triangle_id = triangles_count - 1;
+        }
 
         auto format_coordinate = [](float f, char *buf) -> char* {
             assert(is_decimal_separator_point());
@@ -3226,25 +3440,23 @@ namespace Slic3r {
 #endif
         };
 
-        char buf[256];
-        unsigned int vertices_count = 0;
-        for (ModelVolume* volume : object.volumes) {
-            if (volume == nullptr)
-                continue;
-
-            volumes_offsets.insert({ volume, Offsets(vertices_count) });
-
-            const indexed_triangle_set &its = volume->mesh().its;
-            if (its.vertices.empty()) {
-                add_error("Found invalid mesh");
-                return false;
-            }
-
-            vertices_count += (int)its.vertices.size();
+        // The vertices and triangles are exported in chunks of a bounded size. The XML of the chunks is generated in parallel,
+        // while the chunks are compressed in their order by a single thread, as a zip stream could only be written sequentially.
+        struct Chunk
+        {
+            const ModelVolume *volume;
+            const Offsets     *offsets;
+            // Range of vertices or triangles of the volume.
+            int                begin;
+            int                end;
+        };
 
-            const Transform3d& matrix = volume->get_matrix();
-            for (const auto& vertex: its.vertices) {
-                Vec3f v = (matrix * vertex.cast<double>()).cast<float>();
+        auto add_vertices_xml = [&format_coordinate](const Chunk &chunk, std::string &out) {
+            char buf[256];
+            const indexed_triangle_set &its = chunk.volume->mesh().its;
+            const Transform3d& matrix = chunk.volume->get_matrix();
+            for (int i = chunk.begin; i < chunk.end; ++ i) {
+                Vec3f v = (matrix * its.vertices[i].cast<double>()).cast<float>();
                 char *ptr = buf;
                 boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << VERTEX_TAG << " x=\"");
                 ptr = format_coordinate(v.x(), ptr);
@@ -3254,100 +3466,105 @@ namespace Slic3r {
                 ptr = format_coordinate(v.z(), ptr);
                 boost::spirit::karma::generate(ptr, "\"/>\n");
                 *ptr = '\0';
-                output_buffer += buf;
-                if (! flush())
-                    return false;
+                out += buf;
             }
-        }
-
-        output_buffer += "    </";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n";
-
-        unsigned int triangles_count = 0;
-        for (ModelVolume* volume : object.volumes) {
-            if (volume == nullptr)
-                continue;
-
-            bool is_left_handed = volume->is_left_handed();
-            VolumeToOffsetsMap::iterator volume_it = volumes_offsets.find(volume);
-            assert(volume_it != volumes_offsets.end());
-
-            const indexed_triangle_set &its = volume->mesh().its;
-
-            // updates triangle offsets
-            volume_it->second.first_triangle_id = triangles_count;
-            triangles_count += (int)its.indices.size();
-            volume_it->second.last_triangle_id = triangles_count - 1;
-
-            for (int i = 0; i < int(its.indices.size()); ++ i) {
-                {
-                    const Vec3i &idx = its.indices[i];
-                    char *ptr = buf;
-                    boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << TRIANGLE_TAG <<
-                        " v1=\"" << boost::spirit::int_ <<
-                        "\" v2=\"" << boost::spirit::int_ <<
-                        "\" v3=\"" << boost::spirit::int_ << "\"",
-                        idx[is_left_handed ? 2 : 0] + volume_it->second.first_vertex_id,
-                        idx[1] + volume_it->second.first_vertex_id,
-                        idx[is_left_handed ? 0 : 2] + volume_it->second.first_vertex_id);
-                    *ptr = '\0';
-                    output_buffer += buf;
-                }
-
-                std::string custom_supports_data_string = volume->supported_facets.get_triangle_as_string(i);
-                if (! custom_supports_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SUPPORTS_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_supports_data_string;
-                    output_buffer += "\"";
-                }
-
-                std::string custom_seam_data_string = volume->seam_facets.get_triangle_as_string(i);
-                if (! custom_seam_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SEAM_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_seam_data_string;
-                    output_buffer += "\"";
-                }
+        };
 
-                std::string mm_painting_data_string = volume->mm_segmentation_facets.get_triangle_as_string(i);
-                if (! mm_painting_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += MM_SEGMENTATION_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += mm_painting_data_string;
-                    output_buffer += "\"";
+        auto add_triangles_xml = [](const Chunk &chunk, std::string &out) {
+            char buf[256];
+            const ModelVolume          *volume         = chunk.volume;
+            const indexed_triangle_set &its            = volume->mesh().its;
+            const bool                  is_left_handed = volume->is_left_handed();
+            const unsigned int          first_vertex_id = chunk.offsets->first_vertex_id;
+            auto add_attribute = [&out](const char *name, const std::string &value) {
+                if (! value.empty()) {
+                    out += " ";
+                    out += name;
+                    out += "=\"";
+                    out += value;
+                    out += "\"";
                 }
+            };
+            for (int i = chunk.begin; i < chunk.end; ++ i) {
+                const Vec3i &idx = its.indices[i];
+                char *ptr = buf;
+                boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << TRIANGLE_TAG <<
+                    " v1=\"" << boost::spirit::int_ <<
+                    "\" v2=\"" << boost::spirit::int_ <<
+                    "\" v3=\"" << boost::spirit::int_ << "\"",
+                    idx[is_left_handed ? 2 : 0] + first_vertex_id,
+                    idx[1] + first_vertex_id,
+                    idx[is_left_handed ? 0 : 2] + first_vertex_id);
+                *ptr = '\0';
+                out += buf;
+                add_attribute(CUSTOM_SUPPORTS_ATTR,  volume->supported_facets.get_triangle_as_string(i));
+                add_attribute(CUSTOM_SEAM_ATTR,      volume->seam_facets.get_triangle_as_string(i));
+                add_attribute(MM_SEGMENTATION_ATTR,  volume->mm_segmentation_facets.get_triangle_as_string(i));
+                add_attribute(FUZZY_SKIN_ATTR,       volume->fuzzy_skin_facets.get_triangle_as_string(i));
+                out += "/>\n";
+            }
+        };
 
-                std::string fuzzy_skin_data_string = volume->fuzzy_skin_facets.get_triangle_as_string(i);
-                if (!fuzzy_skin_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += FUZZY_SKIN_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += fuzzy_skin_data_string;
-                    output_buffer += "\"";
-                }
+        auto add_data = [this, &context](const std::string &data) {
+            if (! data.empty() && ! mz_zip_writer_add_staged_data(&context, data.data(), data.size())) {
+                add_error("Error during writing or compression");
+                return false;
+            }
+            return true;
+        };
 
-                output_buffer += "/>\n";
+        // Generates the XML of the chunks in parallel and writes it into the archive in the order of the chunks.
+        auto add_chunks = [&add_data](const std::vector<Chunk> &chunks, const auto &add_xml) {
+            size_t next_chunk = 0;
+            bool   failed     = false;
+            tbb::parallel_pipeline(size_t(std::max(2, 2 * tbb::this_task_arena::max_concurrency())),
+                tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+                    [&chunks, &next_chunk, &failed](tbb::flow_control &fc) -> size_t {
+                        if (failed || next_chunk == chunks.size()) {
+                            fc.stop();
+                            return 0;
+                        }
+                        return next_chunk ++;
+                    }) &
+                tbb::make_filter<size_t, std::string>(slic3r_tbb_filtermode::parallel,
+                    [&chunks, &add_xml](size_t chunk_idx) {
+                        const Chunk &chunk = chunks[chunk_idx];
+                        std::string out;
+                        out.reserve(size_t(chunk.end - chunk.begin) * 64);
+                        add_xml(chunk, out);
+                        return out;
+                    }) &
+                tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
+                    [&add_data, &failed](std::string out) {
+                        if (! failed && ! add_data(out))
+                            failed = true;
+                    }));
+            return ! failed;
+        };
 
-                if (! flush())
-                    return false;
-            }
+        // Split the vertices and triangles of the volumes into chunks of roughly 1MB of XML each.
+        static constexpr int chunk_size = 16384;
+        std::vector<Chunk> vertex_chunks;
+        std::vector<Chunk> triangle_chunks;
+        for (const ModelVolume* volume : object.volumes) {
+            if (volume == nullptr)
+                continue;
+            const Offsets              &offsets = volumes_offsets.find(volume)->second;
+            const indexed_triangle_set &its     = volume->mesh().its;
+            for (int begin = 0; begin < int(its.vertices.size()); begin += chunk_size)
+                vertex_chunks.push_back({ volume, &offsets, begin, std::min(begin + chunk_size, int(its.vertices.size())) });
+            for (int begin = 0; begin < int(its.indices.size()); begin += chunk_size)
+                triangle_chunks.push_back({ volume, &offsets, begin, std::min(begin + chunk_size, int(its.indices.size())) });
         }
 
-        output_buffer += "    </";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n   </";
-        output_buffer += MESH_TAG;
-        output_buffer += ">\n";
-
-        // Force flush.
-        return flush(true);
+        // The worker threads format the coordinates with sprintf(), which has to use the "C" locales.
+        TBBLocalesSetter locales_setter;
+        return 
+            add_data(std::string("   <") + MESH_TAG + ">\n    <" + VERTICES_TAG + ">\n") &&
+            add_chunks(vertex_chunks, add_vertices_xml) &&
+            add_data(std::string("    </") + VERTICES_TAG + ">\n    <" + TRIANGLES_TAG + ">\n") &&
+            add_chunks(triangle_chunks, add_triangles_xml) &&
+            add_data(std::string("    </") + TRIANGLES_TAG + ">\n   </" + MESH_TAG + ">\n");
     }
 
     void _3MF_Exporter::add_transformation(std::stringstream &stream, const Transform3d &tr)
@@ -3435,7 +3652,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, CUT_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, CUT_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add cut information file to archive");
                 return false;
             }
@@ -3469,7 +3686,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, LAYER_HEIGHTS_PROFILE_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, LAYER_HEIGHTS_PROFILE_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
@@ -3527,7 +3744,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
@@ -3575,7 +3792,7 @@ namespace Slic3r {
             // Adds version header at the beginning:
             out = std::string("support_points_format_version=") + std::to_string(support_points_format_version) + std::string("\n") + out;
 
-            if (!mz_zip_writer_add_mem(&archive, SLA_SUPPORT_POINTS_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, SLA_SUPPORT_POINTS_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add sla support points file to archive");
                 return false;
             }
@@ -3626,7 +3843,7 @@ namespace Slic3r {
             // Adds version header at the beginning:
             out = std::string("drain_holes_format_version=") + std::to_string(drain_holes_format_version) + std::string("\n") + out;
             
-            if (!mz_zip_writer_add_mem(&archive, SLA_DRAIN_HOLES_FILE.c_str(), static_cast<const void*>(out.data()), out.length(), mz_uint(MZ_DEFAULT_COMPRESSION))) {
+            if (!mz_zip_writer_add_mem(&archive, SLA_DRAIN_HOLES_FILE.c_str(), static_cast<const void*>(out.data()), out.length(), mz_uint(m_compression_level))) {
                 add_error("Unable to add sla support points file to archive");
                 return false;
             }
@@ -3669,7 +3886,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, PRINT_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, PRINT_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
                 add_error("Unable to add print config file to archive");
                 return false;
             }
@@ -3804,7 +4021,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, MODEL_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, MODEL_CONFIG_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add model config file to archive");
             return false;
         }
@@ -3864,7 +4081,7 @@ bool _3MF_Exporter::_add_custom_gcode_per_print_z_file_to_archive( mz_zip_archiv
     } 
 
     if (!out.empty()) {
-        if (!mz_zip_writer_add_mem(&archive, CUSTOM_GCODE_PER_PRINT_Z_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, CUSTOM_GCODE_PER_PRINT_Z_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add custom Gcodes per print_z file to archive");
             return false;
         }
@@ -3900,7 +4117,7 @@ bool _3MF_Exporter::_add_wipe_tower_information_file_to_archive( mz_zip_archive&
     boost::replace_all(out, "><", ">\n<");
     
     if (!out.empty()) {
-        if (!mz_zip_writer_add_mem(&archive, WIPE_TOWER_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, WIPE_TOWER_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), m_compression_level)) {
             add_error("Unable to add wipe tower information file to archive");
             return false;
         }
@@ -4011,7 +4228,7 @@ bool load_3mf(
     return res;
 }
 
-bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64)
+bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64, ThreeMFCompression compression)
 {
     // All export should use "C" locales for number formatting.
     CNumericLocalesSetter locales_setter;
@@ -4020,7 +4237,7 @@ bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config,
         return false;
 
     _3MF_Exporter exporter;
-    bool res = exporter.save_model_to_file(path, *model, config, fullpath_sources, thumbnail_data, zip64);
+    bool res = exporter.save_model_to_file(path, *model, config, fullpath_sources, thumbnail_data, zip64, compression);
     if (!res)
         exporter.log_errors();
 
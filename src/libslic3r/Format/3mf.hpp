@@ -59,9 +59,22 @@ namespace Slic3r {
         boost::optional<Semver> &prusaslicer_generator_version
     );
 
+    // Compression of the files stored into a 3mf file.
+    enum class ThreeMFCompression {
+        // No compression, the fastest export, for example for backups.
+        Store,
+        // The fastest deflate level.
+        Fast,
+        // The default deflate level.
+        Default,
+        // The best deflate level, the smallest file.
+        Best
+    };
+
     // Save the given model and the config data contained in the given Print into a 3mf file.
     // The model could be modified during the export process if meshes are not repaired or have no shared vertices
-    extern bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data = nullptr, bool zip64 = true);
+    extern bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data = nullptr, bool zip64 = true,
+        ThreeMFCompression compression = ThreeMFCompression::Default);
 
 } // namespace Slic3r
 
@@ -411,8 +411,11 @@ std::unique_ptr<sla::RasterBase> AnycubicSLAArchive::create_raster() const
     sla::RasterBase::Trafo tr{orientation, mirror};
 
     double gamma = m_cfg.gamma_correction.getFloat();
+    sla::RasterBackend backend = m_cfg.sla_rasterizer.value == slarScanline ?
+                                     sla::RasterBackend::Scanline :
+                                     sla::RasterBackend::AGG;
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr, backend);
 }
 
 sla::RasterEncoder AnycubicSLAArchive::get_encoder() const
@@ -513,7 +516,7 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
                                const ThumbnailsList &thumbnails,
                                const std::string    &/*projectname*/)
 {
-    std::uint32_t layer_count = m_layers.size();
+    std::uint32_t layer_count = m_layer_source.size();
 
     anycubicsla_format_intro         intro = {};
     anycubicsla_format_header        header = {};
@@ -553,12 +556,16 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
         //layers
         layer_images.reserve(layer_count * LAYER_SIZE_ESTIMATE);
         image_offset = intro.image_data_offset;
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+        // Offsets of the images already written, the layers identical to the layer below share its image.
+        std::vector<std::uint32_t> image_offsets(layer_count);
+        for (size_t i = 0; i < layer_count; ++ i) {
+            const sla::EncodedRaster &rst = layer(i);
+            const bool duplicate = layer_source(i) != i;
             anycubicsla_format_layer l;
             std::memset(&l, 0, sizeof(l));
-            l.image_offset = image_offset;
+            l.image_offset = duplicate ? image_offsets[layer_source(i)] : image_offset;
             l.image_size = rst.size();
+            image_offsets[i] = l.image_offset;
             if (i < header.bottom_layer_count) {
                 l.exposure_time_s = header.bottom_exposure_time_s;
                 l.layer_height_mm = misc.bottom_layer_height_mm;
@@ -570,13 +577,14 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
                 l.lift_distance_mm = header.lift_distance_mm;
                 l.lift_speed_mms = header.lift_speed_mms;
             }
-            image_offset += l.image_size;
             anycubicsla_write_layer(out, l);
-            // add the rle encoded layer image into the buffer
-            const char* img_start = reinterpret_cast<const char*>(rst.data());
-            const char* img_end = img_start + rst.size();
-            std::copy(img_start, img_end, std::back_inserter(layer_images));
-            i++;
+            if (! duplicate) {
+                image_offset += l.image_size;
+                // add the rle encoded layer image into the buffer
+                const char* img_start = reinterpret_cast<const char*>(rst.data());
+                const char* img_end = img_start + rst.size();
+                std::copy(img_start, img_end, std::back_inserter(layer_images));
+            }
         }
         const char* img_buffer = reinterpret_cast<const char*>(layer_images.data());
         out.write(img_buffer, layer_images.size());
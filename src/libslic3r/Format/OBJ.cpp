@@ -7,11 +7,17 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <cassert>
 #include <cstring>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "libslic3r/Model.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "OBJ.hpp"
@@ -38,64 +44,108 @@ bool load_obj(const char *path, TriangleMesh *meshptr)
         return false;
     }
     
-    // Count the faces and verify, that all faces are triangular.
-    size_t num_faces = 0;
-    size_t num_quads = 0;
-    for (size_t i = 0; i < data.vertices.size(); ++ i) {
-        // Find the end of face.
-        size_t j = i;
-        for (; j < data.vertices.size() && data.vertices[j].coordIdx != -1; ++ j) ;
-        if (size_t num_face_vertices = j - i; num_face_vertices > 0) {
-            if (num_face_vertices > 4) {
-                // Non-triangular and non-quad faces are not supported as of now.
-                BOOST_LOG_TRIVIAL(error) << "load_obj: failed to parse " << path << ". The file contains polygons with more than 4 vertices.";
-                return false;
-            } else if (num_face_vertices < 3) {
-                // Non-triangular and non-quad faces are not supported as of now.
-                BOOST_LOG_TRIVIAL(error) << "load_obj: failed to parse " << path << ". The file contains polygons with less than 2 vertices.";
-                return false;
+    // Only the coordinates and the faces are used, release the rest as early as possible.
+    auto release = [](auto &v) { std::vector<std::decay_t<decltype(v.front())>>().swap(v); };
+    release(data.textureCoordinates);
+    release(data.normals);
+    release(data.parameters);
+
+    // The faces are delimited by an ObjVertex with coordIdx == -1. The vertex references are split into blocks
+    // processed in parallel, each face belongs to the block containing its first vertex reference.
+    static constexpr size_t block_size = 65536;
+    const size_t num_refs   = data.vertices.size();
+    const size_t num_blocks = (num_refs + block_size - 1) / block_size;
+    auto for_each_face = [&data, num_refs](size_t block_idx, auto &&fn) {
+        size_t i = block_idx * block_size;
+        // Skip the tail of a face started in the previous block.
+        while (i > 0 && i < num_refs && data.vertices[i - 1].coordIdx != -1)
+            ++ i;
+        for (const size_t block_end = std::min(num_refs, (block_idx + 1) * block_size); i < block_end;)
+            if (data.vertices[i].coordIdx == -1)
+                ++ i;
+            else {
+                // Find the end of face.
+                size_t j = i;
+                for (; j < num_refs && data.vertices[j].coordIdx != -1; ++ j) ;
+                fn(i, j);
+                i = j;
             }
-            if (num_face_vertices == 4)
-                ++ num_quads;
-            ++ num_faces;
-            i = j;
+    };
+
+    // Count the triangles and verify, that all faces are triangles or quads referencing valid vertices.
+    struct Block {
+        size_t num_triangles     { 0 };
+        // Position and size of the first face, which is neither a triangle nor a quad.
+        size_t invalid_face      { std::numeric_limits<size_t>::max() };
+        size_t invalid_face_size { 0 };
+        bool   invalid_index     { false };
+    };
+    std::vector<Block> blocks(num_blocks);
+    const int num_vertices = int(data.coordinates.size() / 4);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&data, &blocks, &for_each_face, num_vertices](const tbb::blocked_range<size_t> &range) {
+        for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+            Block &block = blocks[block_idx];
+            for_each_face(block_idx, [&data, &block, num_vertices](size_t begin, size_t end) {
+                if (size_t num_face_vertices = end - begin; num_face_vertices < 3 || num_face_vertices > 4) {
+                    if (begin < block.invalid_face) {
+                        block.invalid_face      = begin;
+                        block.invalid_face_size = num_face_vertices;
+                    }
+                } else {
+                    block.num_triangles += num_face_vertices - 2;
+                    for (size_t i = begin; i < end; ++ i)
+                        if (int idx = data.vertices[i].coordIdx; idx < 0 || idx >= num_vertices)
+                            block.invalid_index = true;
+                }
+            });
+        }
+    });
+
+    size_t num_triangles = 0;
+    for (Block &block : blocks) {
+        if (block.invalid_face_size > 4) {
+            // Non-triangular and non-quad faces are not supported as of now.
+            BOOST_LOG_TRIVIAL(error) << "load_obj: failed to parse " << path << ". The file contains polygons with more than 4 vertices.";
+            return false;
+        } else if (block.invalid_face != std::numeric_limits<size_t>::max()) {
+            // Non-triangular and non-quad faces are not supported as of now.
+            BOOST_LOG_TRIVIAL(error) << "load_obj: failed to parse " << path << ". The file contains polygons with less than 2 vertices.";
+            return false;
         }
+        // Convert the triangle counts to offsets into the indexed triangle set.
+        std::swap(num_triangles, block.num_triangles);
+        num_triangles += block.num_triangles;
     }
-    
+    if (std::any_of(blocks.begin(), blocks.end(), [](const Block &block) { return block.invalid_index; })) {
+        BOOST_LOG_TRIVIAL(error) << "load_obj: failed to parse " << path << ". The file contains invalid vertex index.";
+        return false;
+    }
+
     // Convert ObjData into indexed triangle set.
     indexed_triangle_set its;
-    size_t num_vertices = data.coordinates.size() / 4;
-    its.vertices.reserve(num_vertices);
-    its.indices.reserve(num_faces + num_quads);
-    for (size_t i = 0; i < num_vertices; ++ i) {
-        size_t j = i << 2;
-        its.vertices.emplace_back(data.coordinates[j], data.coordinates[j + 1], data.coordinates[j + 2]);
-    }
-    int indices[4];
-    for (size_t i = 0; i < data.vertices.size();)
-        if (data.vertices[i].coordIdx == -1)
-            ++ i;
-        else {
-            int cnt = 0;
-            while (i < data.vertices.size())
-                if (const ObjParser::ObjVertex &vertex = data.vertices[i ++]; vertex.coordIdx == -1) {
-                    break;
-                } else {
-                    assert(cnt < 4);
-                    if (vertex.coordIdx < 0 || vertex.coordIdx >= int(its.vertices.size())) {
-                        BOOST_LOG_TRIVIAL(error) << "load_obj: failed to parse " << path << ". The file contains invalid vertex index.";
-                        return false;
-                    }
-                    indices[cnt ++] = vertex.coordIdx;
-                }
-            if (cnt) {
-                assert(cnt == 3 || cnt == 4);
+    its.vertices.assign(num_vertices, Vec3f::Zero());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, size_t(num_vertices)), [&data, &its](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            size_t j = i << 2;
+            its.vertices[i] = Vec3f(data.coordinates[j], data.coordinates[j + 1], data.coordinates[j + 2]);
+        }
+    });
+    release(data.coordinates);
+
+    its.indices.assign(num_triangles, Vec3i::Zero());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&data, &its, &blocks, &for_each_face](const tbb::blocked_range<size_t> &range) {
+        for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+            size_t triangle_idx = blocks[block_idx].num_triangles;
+            for_each_face(block_idx, [&data, &its, &triangle_idx](size_t begin, size_t end) {
+                const ObjParser::ObjVertex *face = data.vertices.data() + begin;
                 // Insert one or two faces (triangulate a quad).
-                its.indices.emplace_back(indices[0], indices[1], indices[2]);
-                if (cnt == 4)
-                    its.indices.emplace_back(indices[0], indices[2], indices[3]);
-            }
+                its.indices[triangle_idx ++] = Vec3i(face[0].coordIdx, face[1].coordIdx, face[2].coordIdx);
+                if (end - begin == 4)
+                    its.indices[triangle_idx ++] = Vec3i(face[0].coordIdx, face[2].coordIdx, face[3].coordIdx);
+            });
         }
+    });
+    release(data.vertices);
 
     *meshptr = TriangleMesh(std::move(its));
     if (meshptr->empty()) {
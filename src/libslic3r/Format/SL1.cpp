@@ -272,8 +272,11 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
     sla::RasterBase::Trafo tr{orientation, mirror};
 
     double gamma = m_cfg.gamma_correction.getFloat();
+    sla::RasterBackend backend = m_cfg.sla_rasterizer.value == slarScanline ?
+                                     sla::RasterBackend::Scanline :
+                                     sla::RasterBackend::AGG;
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr, backend);
 }
 
 sla::RasterEncoder SL1Archive::get_encoder() const
@@ -285,9 +288,9 @@ static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
 {
     size_t png_size = 0;
 
-    void  *png_data = tdefl_write_image_to_png_file_in_memory_ex(
+    void  *png_data = write_png_to_memory_parallel(
          (const void *) data.pixels.data(), data.width, data.height, 4,
-         &png_size, MZ_DEFAULT_LEVEL, 1);
+         &png_size, MZ_DEFAULT_LEVEL, true);
 
     if (png_data != nullptr) {
         zipper.add_entry("thumbnail/thumbnail" + std::to_string(data.width) +
@@ -325,14 +328,12 @@ void SL1Archive::export_print(Zipper               &zipper,
         zipper.add_entry("config.json");
         zipper << to_json(print, iniconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
-
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+        stream_layers([&zipper, &project](size_t i, const sla::EncodedRaster &rst) {
+            std::string imgname = project + string_printf("%.5d", i) + "." +
                                   rst.extension();
 
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        }, [&print]() { return print.canceled(); }, m_export_statusfn);
 
         for (const ThumbnailData& data : thumbnails)
             if (data.is_valid())
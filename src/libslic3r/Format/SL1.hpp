@@ -40,6 +40,8 @@ public:
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname = "") override;
+
+    bool rasterizes_on_export() const override { return true; }
 };
 
 class SL1Reader: public SLAArchiveReader {
@@ -170,6 +170,7 @@ public:
             "xmlns=\"http://www.w3.org/2000/svg\" xmlns:svg=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n";
     }
 
+    using RasterBase::draw;
     void draw(const ExPolygon& poly) override
     {
         auto cpoly = poly;
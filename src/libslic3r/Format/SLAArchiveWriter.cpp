@@ -7,6 +7,19 @@
 
 #include "SLAArchiveFormatRegistry.hpp"
 #include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/PrintBase.hpp"
+
+#include <tbb/task_arena.h>
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
 
 namespace Slic3r {
 
@@ -22,4 +35,70 @@ SLAArchiveWriter::create(const std::string &archtype, const SLAPrinterConfig &cf
     return ret;
 }
 
+void SLAArchiveWriter::find_duplicate_layers(size_t layer_num, const SameLayerFn &same_as_previous)
+{
+    m_layer_source.resize(layer_num);
+    for (size_t idx = 0; idx < layer_num; ++ idx)
+        m_layer_source[idx] = idx > 0 && same_as_previous && same_as_previous(idx) ? m_layer_source[idx - 1] : idx;
+}
+
+void SLAArchiveWriter::stream_layers(const std::function<void(size_t, const sla::EncodedRaster &)> &writefn,
+                                     const std::function<bool()>                                 &cancelfn,
+                                     const ExportStatusFn                                        &statusfn) const
+{
+    size_t layer_num = m_drawfn ? m_layer_num : m_layers.size();
+    int    status    = -1;
+    auto   report    = [layer_num, &status, &statusfn](size_t written) {
+        int st = int(100 * written / std::max<size_t>(layer_num, 1));
+        if (statusfn && st != status) {
+            status = st;
+            statusfn(st);
+        }
+    };
+
+    if (! m_drawfn) {
+        // Layers were rasterized in advance.
+        for (size_t idx = 0; idx < m_layers.size(); ++ idx) {
+            if (cancelfn && cancelfn())
+                throw CanceledException();
+            writefn(idx, layer(idx));
+            report(idx + 1);
+        }
+        return;
+    }
+
+    // Image of the last layer, which was not a duplicate.
+    sla::EncodedRaster source_layer;
+    size_t next_layer = 0;
+    bool   canceled   = false;
+    tbb::parallel_pipeline(size_t(std::max(2, 2 * tbb::this_task_arena::max_concurrency())),
+        tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+            [this, &next_layer, &canceled, &cancelfn](tbb::flow_control &fc) -> size_t {
+                if (next_layer < m_layer_num && cancelfn && cancelfn())
+                    canceled = true;
+                if (next_layer == m_layer_num || canceled)
+                    fc.stop();
+                return next_layer ++;
+            }) &
+        tbb::make_filter<size_t, std::pair<size_t, sla::EncodedRaster>>(slic3r_tbb_filtermode::parallel,
+            [this](size_t idx) {
+                if (m_layer_source[idx] != idx)
+                    // The image of the source layer is reused by the last stage.
+                    return std::make_pair(idx, sla::EncodedRaster{});
+                auto rst = create_raster();
+                m_drawfn(*rst, idx);
+                return std::make_pair(idx, rst->encode(get_encoder()));
+            }) &
+        tbb::make_filter<std::pair<size_t, sla::EncodedRaster>, void>(slic3r_tbb_filtermode::serial_in_order,
+            [this, &writefn, &source_layer, &report](std::pair<size_t, sla::EncodedRaster> layer) {
+                if (m_layer_source[layer.first] == layer.first)
+                    source_layer = std::move(layer.second);
+                writefn(layer.first, source_layer);
+                report(layer.first + 1);
+            }));
+
+    if (canceled)
+        throw CanceledException();
+}
+
 } // namespace Slic3r
@@ -10,6 +10,7 @@
 #include <memory>
 #include <string>
 #include <cstddef>
+#include <functional>
 
 #include "libslic3r/SLA/RasterBase.hpp"
 #include "libslic3r/Execution/ExecutionTBB.hpp"
@@ -22,28 +23,86 @@ class SLAPrint;
 class SLAPrinterConfig;
 
 class SLAArchiveWriter {
+public:
+    // Draws a single layer, has to be thread safe.
+    using DrawLayerFn = std::function<void(sla::RasterBase &raster, size_t lyrid)>;
+    // Returns true if the layer would be rasterized into the same image as the previous one.
+    using SameLayerFn = std::function<bool(size_t lyrid)>;
+    // Reports the progress of writing the layers into the archive in percent.
+    using ExportStatusFn = std::function<void(int percent)>;
+
 protected:
     std::vector<sla::EncodedRaster> m_layers;
 
+    // Index of the layer, which is rasterized in place of each layer. The images of
+    // duplicate layers are not stored in m_layers, see layer().
+    std::vector<size_t> m_layer_source;
+
+    // Layers to be rasterized on export, see set_layer_drawer().
+    size_t      m_layer_num = 0;
+    DrawLayerFn m_drawfn;
+
+    // See set_export_status().
+    ExportStatusFn m_export_statusfn;
+
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
+    void find_duplicate_layers(size_t layer_num, const SameLayerFn &same_as_previous);
+
+    size_t layer_count() const { return m_layer_source.size(); }
+    // Index of the layer, whose image is reused for layer lyrid.
+    size_t layer_source(size_t lyrid) const { return m_layer_source[lyrid]; }
+    // Encoded image of a layer rasterized in advance by draw_layers().
+    const sla::EncodedRaster& layer(size_t lyrid) const { return m_layers[m_layer_source[lyrid]]; }
+
+    // Passes the encoded layers to writefn in their order. If the layers were not rasterized in advance
+    // by draw_layers(), they are rasterized and encoded in parallel in a pipeline with writefn, keeping only
+    // a bounded number of the encoded layers in memory. Duplicate layers are passed the image of their source layer.
+    // cancelfn is checked before each layer, if it returns true, no more layers are written and CanceledException
+    // is thrown. statusfn is called from a single thread at a time whenever the percentage of the written layers
+    // changes.
+    void stream_layers(const std::function<void(size_t lyrid, const sla::EncodedRaster &)> &writefn,
+                       const std::function<bool()> &cancelfn,
+                       const ExportStatusFn        &statusfn) const;
+
 public:
     virtual ~SLAArchiveWriter() = default;
 
+    // True if the archive format is written sequentially, thus the layers may be rasterized while
+    // the archive is being written, see set_layer_drawer().
+    virtual bool rasterizes_on_export() const { return false; }
+
+    // Instead of rasterizing all the layers in advance by draw_layers(), store the function drawing them.
+    // The layers are then rasterized by export_print() on demand. drawfn may be called after the print was
+    // changed, thus it has to own the data it draws. same_as_previous is only called from within this function.
+    void set_layer_drawer(size_t layer_num, DrawLayerFn drawfn, const SameLayerFn &same_as_previous = nullptr)
+    {
+        m_layers.clear();
+        find_duplicate_layers(layer_num, same_as_previous);
+        m_layer_num = layer_num;
+        m_drawfn    = std::move(drawfn);
+    }
+
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
+    // drawfn is not called for the layers identified as duplicates by same_as_previous.
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
         size_t     layer_num,
         Fn &&      drawfn,
+        const SameLayerFn &same_as_previous = nullptr,
         CancelFn cancelfn = []() { return false; },
         const EP & ep       = {})
     {
+        m_layer_num = 0;
+        m_drawfn    = nullptr;
+        m_layers.clear();
+        find_duplicate_layers(layer_num, same_as_previous);
         m_layers.resize(layer_num);
         execution::for_each(
             ep, size_t(0), m_layers.size(),
             [this, &drawfn, &cancelfn](size_t idx) {
-                if (cancelfn()) return;
+                if (cancelfn() || m_layer_source[idx] != idx) return;
 
                 sla::EncodedRaster &enc = m_layers[idx];
                 auto                rst = create_raster();
@@ -53,6 +112,9 @@ public:
             execution::max_concurrency(ep));
     }
 
+    // Function reporting the progress of the following exports, which rasterize the layers on export.
+    void set_export_status(ExportStatusFn fn) { m_export_statusfn = std::move(fn); }
+
     // Export the print into an archive using the provided filename.
     virtual void export_print(const std::string     fname,
                               const SLAPrint       &print,
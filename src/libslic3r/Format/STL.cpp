@@ -7,10 +7,25 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/predef/other/endian.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_sort.h>
+#include <fast_float.h>
 #include <string>
 #include <utility>
+#include <atomic>
+#include <cassert>
 #include <cstring>
+#include <cstdint>
+#include <exception>
+#include <numeric>
+#include <vector>
 
+#include "admesh/stl.h"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "STL.hpp"
@@ -23,10 +38,235 @@
 
 namespace Slic3r {
 
+// Size of a chunk of an ASCII STL file parsed by a single thread.
+static constexpr const size_t STL_ASCII_CHUNK_SIZE = 1 << 20;
+
+static inline bool stl_is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+
+// Is there a keyword starting at it, separated by white spaces from the surrounding text?
+static inline bool stl_is_keyword(const char *begin, const char *it, const char *end, const char *keyword, size_t keyword_len)
+{
+    return size_t(end - it) > keyword_len && (it == begin || stl_is_space(it[-1])) &&
+           memcmp(it, keyword, keyword_len) == 0 && stl_is_space(it[keyword_len]);
+}
+
+// Parse three floats separated by white spaces, it is advanced behind the last one.
+static inline bool stl_parse_floats(const char *&it, const char *end, Vec3f &out)
+{
+    for (int i = 0; i < 3; ++ i) {
+        while (it < end && stl_is_space(*it))
+            ++ it;
+        if (it < end && *it == '+')
+            ++ it;
+        auto [ptr, ec] = fast_float::from_chars(it, end, out(i));
+        if (ec != std::errc())
+            return false;
+        it = ptr;
+    }
+    return true;
+}
+
+// Parse facets of an ASCII STL file chunk starting at a beginning of a facet. Only the "facet normal x y z" lines and
+// the "vertex x y z" triplets are considered, all the other text (names, text after "endloop" and "endfacet") is ignored.
+// A normal which is not a number is stored as zero, as admesh does.
+// Returns false if the chunk does not consist of complete facets with three vertices each.
+static bool stl_parse_ascii_chunk(const char *file_begin, const char *begin, const char *end, std::vector<stl_vertex> &out, std::vector<stl_normal> &normals)
+{
+    for (const char *it = begin; it < end; ++ it) {
+        if (*it == 'f' && stl_is_keyword(file_begin, it, end, "facet", 5)) {
+            it += 5;
+            while (it < end && stl_is_space(*it))
+                ++ it;
+            stl_normal n = stl_normal::Zero();
+            if (stl_is_keyword(file_begin, it, end, "normal", 6)) {
+                it += 6;
+                if (! stl_parse_floats(it, end, n))
+                    n = stl_normal::Zero();
+            }
+            normals.emplace_back(n);
+            -- it;
+        } else if (*it == 'v' && stl_is_keyword(file_begin, it, end, "vertex", 6)) {
+            it += 6;
+            stl_vertex v;
+            if (! stl_parse_floats(it, end, v))
+                return false;
+            out.emplace_back(v);
+            -- it;
+        }
+    }
+    return normals.size() * 3 == out.size();
+}
+
+// Parse an ASCII STL file in chunks aligned to the beginnings of facets in parallel.
+static bool stl_read_ascii(const char *data, size_t size, indexed_triangle_set &its, std::vector<stl_normal> &normals)
+{
+    const char *end = data + size;
+    std::vector<const char*> chunk_begins { data };
+    for (const char *it = data + STL_ASCII_CHUNK_SIZE; it < end; it += STL_ASCII_CHUNK_SIZE) {
+        it = std::max(it, chunk_begins.back() + 1);
+        while (it < end && ! (*it == 'f' && stl_is_keyword(data, it, end, "facet", 5)))
+            ++ it;
+        if (it == end)
+            break;
+        chunk_begins.emplace_back(it);
+    }
+    chunk_begins.emplace_back(end);
+
+    const size_t                         num_chunks = chunk_begins.size() - 1;
+    std::vector<std::vector<stl_vertex>> chunk_vertices(num_chunks);
+    std::vector<std::vector<stl_normal>> chunk_normals(num_chunks);
+    std::vector<char>                    chunk_valid(num_chunks, false);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [data, &chunk_begins, &chunk_vertices, &chunk_normals, &chunk_valid](const tbb::blocked_range<size_t> &range) {
+        for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+            chunk_vertices[chunk_idx].reserve((chunk_begins[chunk_idx + 1] - chunk_begins[chunk_idx]) / 64);
+            chunk_normals[chunk_idx].reserve((chunk_begins[chunk_idx + 1] - chunk_begins[chunk_idx]) / 192);
+            chunk_valid[chunk_idx] = stl_parse_ascii_chunk(data, chunk_begins[chunk_idx], chunk_begins[chunk_idx + 1], chunk_vertices[chunk_idx], chunk_normals[chunk_idx]);
+        }
+    });
+    if (std::find(chunk_valid.begin(), chunk_valid.end(), false) != chunk_valid.end())
+        return false;
+
+    std::vector<size_t> chunk_offsets(num_chunks + 1, 0);
+    for (size_t chunk_idx = 0; chunk_idx < num_chunks; ++ chunk_idx)
+        chunk_offsets[chunk_idx + 1] = chunk_offsets[chunk_idx] + chunk_vertices[chunk_idx].size();
+    its.vertices.resize(chunk_offsets.back());
+    normals.resize(chunk_offsets.back() / 3);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [&its, &normals, &chunk_offsets, &chunk_vertices, &chunk_normals](const tbb::blocked_range<size_t> &range) {
+        for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+            std::copy(chunk_vertices[chunk_idx].begin(), chunk_vertices[chunk_idx].end(), its.vertices.begin() + chunk_offsets[chunk_idx]);
+            std::copy(chunk_normals[chunk_idx].begin(), chunk_normals[chunk_idx].end(), normals.begin() + chunk_offsets[chunk_idx] / 3);
+            chunk_vertices[chunk_idx] = {};
+            chunk_normals[chunk_idx]  = {};
+        }
+    });
+    return true;
+}
+
+static bool stl_read_binary(const char *data, size_t size, indexed_triangle_set &its, std::vector<stl_normal> &normals)
+{
+#if BOOST_ENDIAN_BIG_BYTE
+    // Leave the conversion from little endian to admesh.
+    return false;
+#else // BOOST_ENDIAN_BIG_BYTE
+    if ((size - HEADER_SIZE) % SIZEOF_STL_FACET != 0 || size < STL_MIN_FILE_SIZE)
+        return false;
+    const size_t num_facets = (size - HEADER_SIZE) / SIZEOF_STL_FACET;
+    its.vertices.resize(num_facets * 3);
+    normals.resize(num_facets);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_facets), [data, &its, &normals](const tbb::blocked_range<size_t> &range) {
+        for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
+            const char *facet = data + HEADER_SIZE + facet_idx * SIZEOF_STL_FACET;
+            memcpy(normals[facet_idx].data(), facet, 3 * sizeof(float));
+            memcpy(its.vertices[facet_idx * 3].data(), facet + 3 * sizeof(float), 9 * sizeof(float));
+        }
+    });
+    return true;
+#endif // BOOST_ENDIAN_BIG_BYTE
+}
+
+// The normals of the facets are only needed if the mesh is to be repaired by admesh.
+static bool read_stl(const char *path, indexed_triangle_set &out, std::vector<stl_normal> &normals)
+{
+    out.clear();
+    normals.clear();
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(boost::filesystem::path(path));
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(info) << "read_stl: Failed to map " << path << " into memory: " << ex.what();
+        return false;
+    }
+    if (! file.is_open() || file.size() < HEADER_SIZE + 128)
+        return false;
+
+    // Detect a binary file the same way as admesh does.
+    const char *data   = file.data();
+    bool        binary = false;
+    for (size_t i = HEADER_SIZE; i < HEADER_SIZE + 128 && ! binary; ++ i)
+        binary = static_cast<unsigned char>(data[i]) > 127;
+    if (! (binary ? stl_read_binary(data, file.size(), out, normals) : stl_read_ascii(data, file.size(), out, normals))) {
+        out.clear();
+        normals.clear();
+        return false;
+    }
+
+    // Triangle soup: Each facet references its own three vertices.
+    out.indices.resize(out.vertices.size() / 3);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, out.indices.size()), [&out](const tbb::blocked_range<size_t> &range) {
+        for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx)
+            out.indices[facet_idx] = stl_triangle_vertex_indices(int(facet_idx * 3), int(facet_idx * 3 + 1), int(facet_idx * 3 + 2));
+    });
+    its_merge_vertices(out);
+    return true;
+}
+
+bool read_stl(const char *path, indexed_triangle_set &out)
+{
+    std::vector<stl_normal> normals;
+    return read_stl(path, out, normals);
+}
+
+// Facets of a mesh read by read_stl() in the order and with the normals of the file, as admesh would read them.
+static std::vector<stl_facet> stl_facets(const indexed_triangle_set &its, const std::vector<stl_normal> &normals)
+{
+    assert(its.indices.size() == normals.size());
+    std::vector<stl_facet> facets(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, facets.size()), [&its, &normals, &facets](const tbb::blocked_range<size_t> &range) {
+        for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
+            stl_facet &facet = facets[facet_idx];
+            facet.normal = normals[facet_idx];
+            for (int i = 0; i < 3; ++ i)
+                facet.vertex[i] = its.vertices[its.indices[facet_idx](i)];
+            facet.extra[0] = facet.extra[1] = 0;
+        }
+    });
+    return facets;
+}
+
+// Would admesh repair modify the mesh? Returns true if the mesh contains a degenerate face, a non-manifold or an open edge,
+// a pair of neighbor faces with inconsistent orientation or if the mesh has negative volume.
+static bool stl_has_defects(const indexed_triangle_set &its)
+{
+    std::vector<uint64_t> half_edges(its.indices.size() * 3);
+    std::atomic<bool>     degenerate { false };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()), [&its, &half_edges, &degenerate](const tbb::blocked_range<size_t> &range) {
+        for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
+            const stl_triangle_vertex_indices &face = its.indices[facet_idx];
+            if (face(0) == face(1) || face(1) == face(2) || face(2) == face(0))
+                degenerate = true;
+            for (int i = 0; i < 3; ++ i)
+                half_edges[facet_idx * 3 + i] = (uint64_t(uint32_t(face(i))) << 32) | uint64_t(uint32_t(face((i + 1) % 3)));
+        }
+    });
+    if (degenerate)
+        return true;
+
+    // Each half edge has to be unique and it has to have its opposite half edge.
+    tbb::parallel_sort(half_edges.begin(), half_edges.end());
+    std::atomic<bool> defect { false };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, half_edges.size()), [&half_edges, &defect](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end() && ! defect; ++ i) {
+            const uint64_t opposite = (half_edges[i] << 32) | (half_edges[i] >> 32);
+            if ((i + 1 < half_edges.size() && half_edges[i] == half_edges[i + 1]) ||
+                ! std::binary_search(half_edges.begin(), half_edges.end(), opposite))
+                defect = true;
+        }
+    });
+    return defect || its_volume(its) < 0;
+}
+
 bool load_stl(const char *path, Model *model, const char *object_name_in)
 {
     TriangleMesh mesh;
-    if (! mesh.ReadSTLFile(path)) {
+    // Try the memory mapped parallel reader first. If the mesh has defects, the parsed facets are repaired by admesh
+    // the same way as if admesh read the file. admesh reads the file only if the parallel reader could not.
+    std::vector<stl_normal> normals;
+    if (indexed_triangle_set its; read_stl(path, its, normals) && ! its.empty()) {
+        if (stl_has_defects(its))
+            mesh.from_stl_facets(stl_facets(its, normals));
+        else
+            mesh = TriangleMesh(std::move(its));
+    } else if (! mesh.ReadSTLFile(path)) {
 //    die "Failed to open $file\n" if !-e $path;
         return false;
     }
@@ -10,6 +10,8 @@
 #ifndef slic3r_Format_STL_hpp_
 #define slic3r_Format_STL_hpp_
 
+struct indexed_triangle_set;
+
 namespace Slic3r {
 
 class TriangleMesh;
@@ -18,6 +20,10 @@ class Model;
 
 // Load an STL file into a provided model.
 extern bool load_stl(const char *path, Model *model, const char *object_name = nullptr);
+// Read a binary or ASCII STL file into an indexed triangle set, merging vertices with exactly matching coordinates.
+// The file is memory mapped and parsed in parallel, the mesh is not repaired.
+// Returns false if the file could not be read, it may still be readable by admesh, which is more tolerant to malformed ASCII files.
+extern bool read_stl(const char *path, indexed_triangle_set &out);
 
 extern bool store_stl(const char *path, TriangleMesh *mesh, bool binary);
 extern bool store_stl(const char *path, ModelObject *model_object, bool binary);
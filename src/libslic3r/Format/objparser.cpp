@@ -4,8 +4,23 @@
 ///|/
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <LocalesUtils.hpp>
 #include <fast_float.h>
+#include <tbb/task_arena.h>
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
+#include <algorithm>
+#include <memory>
 #include <new>
 #include <system_error>
 #include <utility>
@@ -15,9 +30,25 @@
 #include <cstring>
 
 #include "objparser.hpp"
+#include "libslic3r/Thread.hpp"
 
 namespace ObjParser {
 
+// Face vertex, which references a coordinate, normal or texture coordinate relative to the end of the respective list.
+// When a file is parsed in chunks, such references are resolved against the chunk only and they are rebased
+// when the chunks are merged.
+struct ObjRelativeVertex
+{
+	enum Mask : unsigned char {
+		Coord			= 1,
+		Normal			= 2,
+		TextureCoord	= 4,
+	};
+	// Index into ObjData::vertices.
+	size_t			vertexIdx;
+	unsigned char	mask;
+};
+
 // To fix issues with obj loading on macOS Sonoma, we use the following function instead of strtod that
 // was used before. Apparently the locales are not handled as they should. We already saw this before in
 // https://github.com/prusa3d/PrusaSlicer/issues/10380.
@@ -32,7 +63,7 @@ static double strtod_clocale(const char* str, char const** str_end)
 	return val;
 }
 
-static bool obj_parseline(const char *line, ObjData &data)
+static bool obj_parseline(const char *line, ObjData &data, std::vector<ObjRelativeVertex> *relative_vertices = nullptr)
 {
 #define EATWS() while (*line == ' ' || *line == '\t') ++ line
 
@@ -239,18 +270,24 @@ static bool obj_parseline(const char *line, ObjData &data)
 					line = endptr;
 				}
 			}
-			if (vertex.coordIdx < 0)
+			unsigned char relative_mask = 0;
+			if (vertex.coordIdx < 0) {
                 vertex.coordIdx += (int)data.coordinates.size() / 4;
-            else
+				relative_mask |= ObjRelativeVertex::Coord;
+			} else
 				-- vertex.coordIdx;
-			if (vertex.normalIdx < 0)
+			if (vertex.normalIdx < 0) {
                 vertex.normalIdx += (int)data.normals.size() / 3;
-            else
+				relative_mask |= ObjRelativeVertex::Normal;
+			} else
 				-- vertex.normalIdx;
-			if (vertex.textureCoordIdx < 0)
+			if (vertex.textureCoordIdx < 0) {
                 vertex.textureCoordIdx += (int)data.textureCoordinates.size() / 3;
-            else
+				relative_mask |= ObjRelativeVertex::TextureCoord;
+			} else
 				-- vertex.textureCoordIdx;
+			if (relative_mask != 0 && relative_vertices != nullptr)
+				relative_vertices->push_back({ data.vertices.size(), relative_mask });
 			data.vertices.push_back(vertex);
 			EATWS();
 		}
@@ -346,10 +383,8 @@ static bool obj_parseline(const char *line, ObjData &data)
 	return true;
 }
 
-bool objparse(const char *path, ObjData &data)
+static bool objparse_sequential(const char *path, ObjData &data)
 {
-    Slic3r::CNumericLocalesSetter locales_setter;
-
 	FILE *pFile = boost::nowide::fopen(path, "rt");
 	if (pFile == 0)
 		return false;
@@ -400,6 +435,136 @@ bool objparse(const char *path, ObjData &data)
 	return true;
 }
 
+// Part of an OBJ file parsed independently of the other parts.
+struct ObjChunk
+{
+	ObjData							data;
+	std::vector<ObjRelativeVertex>	relative_vertices;
+};
+
+static void obj_parsechunk(const char *begin, const char *end, ObjChunk &chunk)
+{
+	std::string line;
+	while (begin < end) {
+		const char *line_end = std::find_if(begin, end, [](char c) { return c == '\r' || c == '\n'; });
+		// obj_parseline() expects a zero terminated line.
+		line.assign(begin, line_end);
+		const char *c = line.c_str();
+		while (*c == ' ' || *c == '\t')
+			++ c;
+		//FIXME check the return value and exit on error?
+		// Will it break parsing of some obj files?
+		obj_parseline(c, chunk.data, &chunk.relative_vertices);
+		begin = line_end + 1;
+	}
+}
+
+// Appends a chunk parsed by obj_parsechunk() to data, rebasing the indices of the chunk.
+static void obj_appendchunk(ObjData &data, ObjChunk &chunk)
+{
+	const int coord_offset			= int(data.coordinates.size() / 4);
+	const int normal_offset			= int(data.normals.size() / 3);
+	const int texture_coord_offset	= int(data.textureCoordinates.size() / 3);
+	const int vertex_offset			= int(data.vertices.size());
+
+	for (const ObjRelativeVertex &relative : chunk.relative_vertices) {
+		ObjVertex &vertex = chunk.data.vertices[relative.vertexIdx];
+		if (relative.mask & ObjRelativeVertex::Coord)
+			vertex.coordIdx += coord_offset;
+		if (relative.mask & ObjRelativeVertex::Normal)
+			vertex.normalIdx += normal_offset;
+		if (relative.mask & ObjRelativeVertex::TextureCoord)
+			vertex.textureCoordIdx += texture_coord_offset;
+	}
+	auto append = [](auto &dst, const auto &src) { dst.insert(dst.end(), src.begin(), src.end()); };
+	auto append_rebased = [vertex_offset](auto &dst, auto &src) {
+		for (auto &item : src) {
+			item.vertexIdxFirst += vertex_offset;
+			dst.push_back(std::move(item));
+		}
+	};
+	append(data.coordinates,			chunk.data.coordinates);
+	append(data.textureCoordinates,		chunk.data.textureCoordinates);
+	append(data.normals,				chunk.data.normals);
+	append(data.parameters,				chunk.data.parameters);
+	append(data.mtllibs,				chunk.data.mtllibs);
+	append_rebased(data.usemtls,		chunk.data.usemtls);
+	append_rebased(data.objects,		chunk.data.objects);
+	append_rebased(data.groups,			chunk.data.groups);
+	append_rebased(data.smoothingGroups,chunk.data.smoothingGroups);
+	append(data.vertices,				chunk.data.vertices);
+}
+
+// The file is memory mapped and split into chunks at line boundaries. The chunks are parsed in parallel
+// and appended to data in their order. Only a limited number of the parsed chunks is kept in memory.
+static bool objparse_chunked(const char *path, ObjData &data)
+{
+	boost::iostreams::mapped_file_source file;
+	try {
+		file.open(boost::filesystem::path(path));
+	} catch (const std::exception &ex) {
+		BOOST_LOG_TRIVIAL(info) << "ObjParser: Failed to map " << path << " into memory: " << ex.what();
+		return false;
+	}
+	if (! file.is_open())
+		return false;
+
+	static constexpr size_t chunk_size = 4 * 1024 * 1024;
+	const char *file_begin	= file.data();
+	const char *file_end	= file_begin + file.size();
+	const char *next_chunk	= file_begin;
+	bool		first_chunk	= true;
+	try {
+		// It registers a handler that sets locales to "C" before any TBB thread starts participating in tbb::parallel_pipeline.
+		Slic3r::TBBLocalesSetter locales_setter;
+		tbb::parallel_pipeline(size_t(std::max(2, 2 * tbb::this_task_arena::max_concurrency())),
+			tbb::make_filter<void, std::pair<const char*, const char*>>(slic3r_tbb_filtermode::serial_in_order,
+				[&next_chunk, file_end](tbb::flow_control &fc) -> std::pair<const char*, const char*> {
+					if (next_chunk == file_end) {
+						fc.stop();
+						return { file_end, file_end };
+					}
+					// Extend the chunk up to the end of the line.
+					const char *begin = next_chunk;
+					const char *end   = std::find_if(begin + std::min(chunk_size, size_t(file_end - begin)), file_end, [](char c) { return c == '\r' || c == '\n'; });
+					next_chunk = end == file_end ? file_end : end + 1;
+					return { begin, next_chunk };
+				}) &
+			tbb::make_filter<std::pair<const char*, const char*>, std::shared_ptr<ObjChunk>>(slic3r_tbb_filtermode::parallel,
+				[](std::pair<const char*, const char*> range) {
+					auto chunk = std::make_shared<ObjChunk>();
+					obj_parsechunk(range.first, range.second, *chunk);
+					return chunk;
+				}) &
+			tbb::make_filter<std::shared_ptr<ObjChunk>, void>(slic3r_tbb_filtermode::serial_in_order,
+				[&data, &first_chunk, file_begin, file_end](std::shared_ptr<ObjChunk> chunk) {
+					if (first_chunk) {
+						// Estimate the size of the data from the first chunk, to avoid reallocations of the huge vectors.
+						first_chunk = false;
+						if (size_t(file_end - file_begin) > chunk_size) {
+							const double scale = 1.05 * double(file_end - file_begin) / double(chunk_size);
+							auto reserve = [scale](auto &dst, const auto &src) { dst.reserve(size_t(scale * double(src.size()))); };
+							reserve(data.coordinates, chunk->data.coordinates);
+							reserve(data.textureCoordinates, chunk->data.textureCoordinates);
+							reserve(data.normals, chunk->data.normals);
+							reserve(data.vertices, chunk->data.vertices);
+						}
+					}
+					obj_appendchunk(data, *chunk);
+				}));
+	} catch (std::bad_alloc&) {
+		BOOST_LOG_TRIVIAL(error) << "ObjParser: Out of memory";
+	}
+	return true;
+}
+
+bool objparse(const char *path, ObjData &data)
+{
+    Slic3r::CNumericLocalesSetter locales_setter;
+	// Fall back to reading the file sequentially if it could not be mapped into memory, for example if it is empty.
+	return objparse_chunked(path, data) || objparse_sequential(path, data);
+}
+
 bool objparse(std::istream &stream, ObjData &data)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
@@ -239,11 +239,11 @@ PerimeterPoints classify_points(
             continue;
         }
         // This is an optimization avoiding distance_from_lines<true> which is expensive.
-        const double embedding_distance{layer_info.distancer.distance_from_lines<false>(point.position)};
+        const double embedding_distance{layer_info.distancer->distance_from_lines<false>(point.position)};
         if (embedding_distance < embedding_threshold) {
             continue;
         }
-        if (layer_info.distancer.outside(point.position) == 1) {
+        if (layer_info.distancer->outside(point.position) == 1) {
             continue;
         }
 
@@ -355,19 +355,10 @@ LayerInfo LayerInfo::create(
     const std::size_t index,
     const double elephant_foot_compensation
 ) {
-    AABBTreeLines::LinesDistancer<Linef> perimeter_distancer{
-        to_unscaled_linesf({object_layer.lslices})};
-
-    using PreviousLayerDistancer = std::optional<AABBTreeLines::LinesDistancer<Linef>>;
-    PreviousLayerDistancer previous_layer_perimeter_distancer;
-    if (object_layer.lower_layer != nullptr) {
-        previous_layer_perimeter_distancer = PreviousLayerDistancer{
-            to_unscaled_linesf(object_layer.lower_layer->lslices)};
-    }
-
+    // The AABB trees over lslices are shared with the other steps querying the same layers.
     return {
-        std::move(perimeter_distancer),
-        std::move(previous_layer_perimeter_distancer),
+        &object_layer.lslices_distancer(),
+        object_layer.lower_layer != nullptr ? &object_layer.lower_layer->lslices_distancer() : nullptr,
         index,
         object_layer.height,
         object_layer.slice_z,
@@ -50,8 +50,10 @@ struct LayerInfo
         const Slic3r::Layer &object_layer, std::size_t index, const double elephant_foot_compensation
     );
 
-    AABBTreeLines::LinesDistancer<Linef> distancer;
-    std::optional<AABBTreeLines::LinesDistancer<Linef>> previous_distancer;
+    // Owned by the layer, see Layer::lslices_distancer().
+    const AABBTreeLines::LinesDistancer<Linef> *distancer;
+    // nullptr for the first layer.
+    const AABBTreeLines::LinesDistancer<Linef> *previous_distancer;
     std::size_t index;
     double height{};
     double slice_z{};
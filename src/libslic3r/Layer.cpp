@@ -14,10 +14,12 @@
 #include <clipper/clipper_z.hpp>
 #include <cstdint>
 #include <iterator>
+#include <mutex>
 #include <numeric>
 #include <tuple>
 #include <cassert>
 
+#include "AABBTreeLines.hpp"
 #include "ClipperZUtils.hpp"
 #include "ClipperUtils.hpp"
 #include "Point.hpp"
@@ -38,6 +40,19 @@
 
 namespace Slic3r {
 
+struct Layer::SpatialIndex
+{
+    std::once_flag                          lslices_distancer_once;
+    AABBTreeLines::LinesDistancer<Linef>    lslices_distancer;
+};
+
+Layer::Layer(size_t id, PrintObject *object, coordf_t height, coordf_t print_z, coordf_t slice_z) :
+    upper_layer(nullptr), lower_layer(nullptr),
+    //slicing_errors(false),
+    slice_z(slice_z), print_z(print_z), height(height),
+    m_id(id), m_object(object), m_spatial_index(std::make_unique<SpatialIndex>())
+{}
+
 Layer::~Layer()
 {
     this->lower_layer = this->upper_layer = nullptr;
@@ -62,6 +77,19 @@ LayerRegion* Layer::add_region(const PrintRegion *print_region)
     return m_regions.back();
 }
 
+const AABBTreeLines::LinesDistancer<Linef>& Layer::lslices_distancer() const
+{
+    std::call_once(m_spatial_index->lslices_distancer_once, [this]() {
+        m_spatial_index->lslices_distancer = AABBTreeLines::LinesDistancer<Linef>{ to_unscaled_linesf(this->lslices) };
+    });
+    return m_spatial_index->lslices_distancer;
+}
+
+void Layer::invalidate_spatial_index()
+{
+    m_spatial_index = std::make_unique<SpatialIndex>();
+}
+
 // merge all regions' slices to get islands
 void Layer::make_slices()
 {
@@ -81,6 +109,7 @@ void Layer::make_slices()
     }
 
     this->lslice_indices_sorted_by_print_order = chain_expolygons(this->lslices);
+    this->invalidate_spatial_index();
 }
 
 // used by Layer::build_up_down_graph()
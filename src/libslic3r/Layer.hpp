@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -55,6 +56,10 @@ namespace FillLightning {
     class Generator;
 };
 
+namespace AABBTreeLines {
+    template<typename LineType> class LinesDistancer;
+};
+
 // Range of extrusions, referencing the source region by an index.
 class LayerExtrusionRange : public ExtrusionRange
 {
@@ -194,6 +199,15 @@ public:
     std::vector<size_t>     lslice_indices_sorted_by_print_order;
     LayerSlices             lslices_ex;
 
+    // Spatial indices over the layer geometry shared by all the steps querying the same geometry
+    // (overhang detection, support spots, curled extrusions, seam placement).
+    // The indices are built lazily on the first request, requesting them from multiple threads is safe.
+    // AABB tree over the unscaled lines of lslices.
+    const AABBTreeLines::LinesDistancer<Linef>& lslices_distancer() const;
+    // To be called whenever lslices are modified to drop the spatial indices built over the old lslices.
+    // Not thread safe, the returned spatial indices must not be used anymore.
+    void                    invalidate_spatial_index();
+
     size_t                  region_count() const { return m_regions.size(); }
     const LayerRegion*      get_region(int idx) const { return m_regions[idx]; }
     LayerRegion*            get_region(int idx) { return m_regions[idx]; }
@@ -241,14 +255,11 @@ public:
 
 protected:
     friend class PrintObject;
+    friend class PrintSnapshot;
     friend std::vector<Layer*> new_layers(PrintObject*, const std::vector<coordf_t>&);
     friend std::string fix_slicing_errors(LayerPtrs&, const std::function<void()>&);
 
-    Layer(size_t id, PrintObject *object, coordf_t height, coordf_t print_z, coordf_t slice_z) :
-        upper_layer(nullptr), lower_layer(nullptr), 
-        //slicing_errors(false),
-        slice_z(slice_z), print_z(print_z), height(height),
-        m_id(id), m_object(object) {}
+    Layer(size_t id, PrintObject *object, coordf_t height, coordf_t print_z, coordf_t slice_z);
     virtual ~Layer();
     // Clear fill extrusions, remove them from layer islands.
     void clear_fills();
@@ -274,6 +285,10 @@ private:
     size_t              m_id;
     PrintObject        *m_object;
     LayerRegionPtrs     m_regions;
+
+    // Lazily built spatial indices, see lslices_distancer().
+    struct SpatialIndex;
+    mutable std::unique_ptr<SpatialIndex> m_spatial_index;
 };
 
 class SupportLayer : public Layer 
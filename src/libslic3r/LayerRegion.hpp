@@ -151,6 +151,7 @@ public:
 protected:
     friend class Layer;
     friend class PrintObject;
+    friend class PrintSnapshot;
 
     LayerRegion(Layer *layer, const PrintRegion *region) : m_layer(layer), m_region(region) {}
     ~LayerRegion() = default;
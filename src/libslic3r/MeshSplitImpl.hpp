@@ -27,7 +27,7 @@ template<> struct ItsWithNeighborsIndex_<indexed_triangle_set> {
     static const indexed_triangle_set &get_its(const indexed_triangle_set &its) noexcept { return its; }
     static Index get_index(const indexed_triangle_set &its) noexcept
     {
-        return create_face_neighbors_index(ex_tbb, its);
+        return its_face_neighbors_par(its);
     }
 };
 
@@ -32,6 +32,8 @@
 
 #include <tbb/concurrent_vector.h>
 
+#include <atomic>
+
 #include "SVG.hpp"
 #include <Eigen/Dense>
 #include "libslic3r/GCode/GCodeWriter.hpp"
@@ -823,7 +825,7 @@ const BoundingBoxf3& ModelObject::raw_mesh_bounding_box() const
         m_raw_mesh_bounding_box.reset();
         for (const ModelVolume *v : this->volumes)
             if (v->is_model_part())
-                m_raw_mesh_bounding_box.merge(v->mesh().transformed_bounding_box(v->get_matrix()));
+                m_raw_mesh_bounding_box.merge(v->transformed_bounding_box(v->get_matrix()));
     }
     return m_raw_mesh_bounding_box;
 }
@@ -832,7 +834,7 @@ BoundingBoxf3 ModelObject::full_raw_mesh_bounding_box() const
 {
 	BoundingBoxf3 bb;
 	for (const ModelVolume *v : this->volumes)
-		bb.merge(v->mesh().transformed_bounding_box(v->get_matrix()));
+		bb.merge(v->transformed_bounding_box(v->get_matrix()));
 	return bb;
 }
 
@@ -849,7 +851,7 @@ const BoundingBoxf3& ModelObject::raw_bounding_box() const
         const Transform3d inst_matrix = this->instances.front()->get_transformation().get_matrix_no_offset();
         for (const ModelVolume *v : this->volumes)
             if (v->is_model_part())
-                m_raw_bounding_box.merge(v->mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
+                m_raw_bounding_box.merge(v->transformed_bounding_box(inst_matrix * v->get_matrix()));
     }
 	return m_raw_bounding_box;
 }
@@ -864,7 +866,7 @@ BoundingBoxf3 ModelObject::instance_bounding_box(size_t instance_idx, bool dont_
 
     for (ModelVolume *v : this->volumes) {
         if (v->is_model_part())
-            bb.merge(v->mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
+            bb.merge(v->transformed_bounding_box(inst_matrix * v->get_matrix()));
     }
     return bb;
 }
@@ -880,7 +882,7 @@ Polygon ModelObject::convex_hull_2d(const Transform3d& trafo_instance) const
         for (size_t i = range.begin(); i < range.end(); ++i) {
             const ModelVolume* v = volumes[i];
             if (v->is_model_part())
-                chs.emplace_back(its_convex_hull_2d_above(v->mesh().its, (trafo_instance * v->get_matrix()).cast<float>(), 0.0f));
+                chs.emplace_back(v->transformed_convex_hull_2d(trafo_instance * v->get_matrix()));
         }
     });
 
@@ -1163,10 +1165,7 @@ double ModelObject::get_instance_min_z(size_t instance_idx) const
             continue;
 
         const Transform3d mv = mi * v->get_matrix();
-        const TriangleMesh& hull = v->get_convex_hull();
-        for (const stl_triangle_vertex_indices& facet : hull.its.indices)
-			for (int i = 0; i < 3; ++ i)
-				min_z = std::min(min_z, (mv * hull.its.vertices[facet[i]].cast<double>()).z());
+        min_z = std::min(min_z, v->transformed_convex_hull_bounding_box(mv).min.z());
     }
 
     return min_z + inst->get_offset(Z);
@@ -1184,10 +1183,7 @@ double ModelObject::get_instance_max_z(size_t instance_idx) const
             continue;
 
         const Transform3d mv = mi * v->get_matrix();
-        const TriangleMesh& hull = v->get_convex_hull();
-        for (const stl_triangle_vertex_indices& facet : hull.its.indices)
-            for (int i = 0; i < 3; ++i)
-                max_z = std::max(max_z, (mv * hull.its.vertices[facet[i]].cast<double>()).z());
+        max_z = std::max(max_z, v->transformed_convex_hull_bounding_box(mv).max.z());
     }
 
     return max_z + inst->get_offset(Z);
@@ -1362,6 +1358,8 @@ void ModelVolume::center_geometry_after_creation(bool update_source_offset)
         	const_cast<TriangleMesh*>(m_mesh.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
         if (m_convex_hull)
 			const_cast<TriangleMesh*>(m_convex_hull.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
+        // The meshes were modified in place.
+        m_transformed_cache.clear();
         translate(shift);
     }
 
@@ -1380,6 +1378,77 @@ const TriangleMesh& ModelVolume::get_convex_hull() const
     return *m_convex_hull.get();
 }
 
+static std::atomic<size_t> s_transformed_cache_hits{ 0 };
+static std::atomic<size_t> s_transformed_cache_misses{ 0 };
+
+// The number of transformations above which the cache of a volume is cleared.
+static constexpr size_t TransformedCacheMaxEntries = 1024;
+
+template<class T, class CalcFn>
+T ModelVolume::TransformedCache::get(const ModelVolume &volume, const Transform3d &trafo, std::optional<T> Entry::*value, CalcFn &&calcfn)
+{
+    auto is_same = [](const std::weak_ptr<const TriangleMesh> &wp, const std::shared_ptr<const TriangleMesh> &sp) {
+        // The weak pointer keeps the control block of a released mesh alive, thus a new mesh cannot share it.
+        return !wp.owner_before(sp) && !sp.owner_before(wp);
+    };
+
+    std::lock_guard<std::mutex> lk(mutex);
+
+    if (!is_same(mesh, volume.m_mesh) || !is_same(convex_hull, volume.m_convex_hull)) {
+        entries.clear();
+        mesh        = volume.m_mesh;
+        convex_hull = volume.m_convex_hull;
+    }
+
+    auto it = entries.find(trafo.matrix());
+    if (it == entries.end()) {
+        if (entries.size() >= TransformedCacheMaxEntries)
+            entries.clear();
+        it = entries.emplace(trafo.matrix(), Entry{}).first;
+    }
+
+    std::optional<T> &v = it->second.*value;
+    if (v) {
+        ++ s_transformed_cache_hits;
+    } else {
+        ++ s_transformed_cache_misses;
+        v = calcfn();
+    }
+
+    return *v;
+}
+
+BoundingBoxf3 ModelVolume::transformed_bounding_box(const Transform3d &trafo) const
+{
+    return m_transformed_cache.get(*this, trafo, &TransformedCache::Entry::bounding_box, [this, &trafo]() {
+        return this->mesh().transformed_bounding_box(trafo);
+    });
+}
+
+BoundingBoxf3 ModelVolume::transformed_convex_hull_bounding_box(const Transform3d &trafo) const
+{
+    return m_transformed_cache.get(*this, trafo, &TransformedCache::Entry::convex_hull_bounding_box, [this, &trafo]() {
+        // The extreme points of the transformed mesh are vertices of its convex hull.
+        return m_convex_hull ? m_convex_hull->transformed_bounding_box(trafo) : this->mesh().transformed_bounding_box(trafo);
+    });
+}
+
+Polygon ModelVolume::transformed_convex_hull_2d(const Transform3d &trafo) const
+{
+    return m_transformed_cache.get(*this, trafo, &TransformedCache::Entry::convex_hull_2d, [this, &trafo]() {
+        return its_convex_hull_2d_above(this->mesh().its, trafo.cast<float>(), 0.0f);
+    });
+}
+
+size_t ModelVolume::transformed_cache_hits() { return s_transformed_cache_hits; }
+size_t ModelVolume::transformed_cache_misses() { return s_transformed_cache_misses; }
+
+void ModelVolume::reset_transformed_cache_statistics()
+{
+    s_transformed_cache_hits   = 0;
+    s_transformed_cache_misses = 0;
+}
+
 ModelVolumeType ModelVolume::type_from_string(const std::string &s)
 {
     // Legacy support
@@ -1482,6 +1551,8 @@ void ModelVolume::scale_geometry_after_creation(const Vec3f& versor)
 {
 	const_cast<TriangleMesh*>(m_mesh.get())->scale(versor);
 	const_cast<TriangleMesh*>(m_convex_hull.get())->scale(versor);
+    // The meshes were modified in place.
+    m_transformed_cache.clear();
 }
 
 void ModelVolume::transform_this_mesh(const Transform3d &mesh_trafo, bool fix_left_handed)
@@ -1606,19 +1677,15 @@ std::string FacetsAnnotation::get_triangle_as_string(int triangle_idx) const
 
     auto triangle_it = std::lower_bound(m_data.triangles_to_split.begin(), m_data.triangles_to_split.end(), triangle_idx, [](const TriangleSelector::TriangleBitStreamMapping &l, const int r) { return l.triangle_idx < r; });
     if (triangle_it != m_data.triangles_to_split.end() && triangle_it->triangle_idx == triangle_idx) {
-        int offset = triangle_it->bitstream_start_idx;
-        int end    = ++ triangle_it == m_data.triangles_to_split.end() ? int(m_data.bitstream.size()) : triangle_it->bitstream_start_idx;
-        while (offset < end) {
-            int next_code = 0;
-            for (int i=3; i>=0; --i) {
-                next_code = next_code << 1;
-                next_code |= int(m_data.bitstream[offset + i]);
-            }
-            offset += 4;
-
+        int begin = triangle_it->bitstream_start_idx;
+        int end   = ++ triangle_it == m_data.triangles_to_split.end() ? int(m_data.bitstream.size()) : triangle_it->bitstream_start_idx;
+        // The nibbles are stored into the string in reverse order.
+        out.reserve(end - begin);
+        for (int offset = end - 1; offset >= begin; -- offset) {
+            int next_code = m_data.bitstream[offset];
             assert(next_code >=0 && next_code <= 15);
             char digit = next_code < 10 ? next_code + '0' : (next_code-10)+'A';
-            out.insert(out.begin(), digit);
+            out.push_back(digit);
         }
     }
     return out;
@@ -1649,9 +1716,7 @@ void FacetsAnnotation::set_triangle_from_string(int triangle_id, const std::stri
         else
             assert(false);
 
-        // Convert to binary and append into code.
-        for (int i = 0; i < 4; ++i)
-            m_data.bitstream.insert(m_data.bitstream.end(), bool(dec & (1 << i)));
+        m_data.bitstream.push_back(uint8_t(dec));
     }
 
     m_data.update_used_states(bitstream_start_idx);
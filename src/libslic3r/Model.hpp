@@ -26,8 +26,10 @@
 #include "EmbossShape.hpp"
 #include "TriangleSelector.hpp"
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -883,6 +885,21 @@ public:
     const TriangleMesh& get_convex_hull() const;
     const std::shared_ptr<const TriangleMesh>& get_convex_hull_shared_ptr() const { return m_convex_hull; }
 
+    // Bounding box of the mesh transformed by trafo.
+    BoundingBoxf3       transformed_bounding_box(const Transform3d &trafo) const;
+    // Bounding box of the convex hull transformed by trafo, cheaper to calculate than the one of the mesh
+    // for the directions the convex hull spans.
+    BoundingBoxf3       transformed_convex_hull_bounding_box(const Transform3d &trafo) const;
+    // 2D convex hull of a projection of the part of the transformed mesh above the XY plane into the XY plane.
+    Polygon             transformed_convex_hull_2d(const Transform3d &trafo) const;
+
+    // The three functions above cache their results per transformation for the current mesh and convex hull.
+    // The cache is invalidated when the mesh or the convex hull is replaced. Statistics of the caches
+    // of all the volumes:
+    static size_t       transformed_cache_hits();
+    static size_t       transformed_cache_misses();
+    static void         reset_transformed_cache_statistics();
+
     // Helpers for loading / storing into AMF / 3MF files.
     static ModelVolumeType type_from_string(const std::string &s);
     static std::string  type_to_string(const ModelVolumeType t);
@@ -974,6 +991,40 @@ private:
     //      1   ->   is splittable
     mutable int               		m_is_splittable{ -1 };
 
+    // Bounding data of the mesh for the transformations it was requested for, see transformed_bounding_box().
+    // A copy of the cache is empty, it is calculated again for the copied volume on demand.
+    struct TransformedCache
+    {
+        struct Entry {
+            std::optional<BoundingBoxf3> bounding_box;
+            std::optional<BoundingBoxf3> convex_hull_bounding_box;
+            std::optional<Polygon>       convex_hull_2d;
+        };
+
+        struct MatrixLess {
+            bool operator()(const Matrix4d &a, const Matrix4d &b) const {
+                return std::lexicographical_compare(a.data(), a.data() + a.size(), b.data(), b.data() + b.size());
+            }
+        };
+
+        std::mutex                               mutex;
+        // The mesh and convex hull the entries were calculated for.
+        std::weak_ptr<const TriangleMesh>        mesh;
+        std::weak_ptr<const TriangleMesh>        convex_hull;
+        std::map<Matrix4d, Entry, MatrixLess>    entries;
+
+        TransformedCache() = default;
+        TransformedCache(const TransformedCache &) {}
+        TransformedCache& operator=(const TransformedCache &) { this->clear(); return *this; }
+
+        void clear() { std::lock_guard<std::mutex> lk(mutex); entries.clear(); }
+
+        // Get a value of the entry of trafo, calculate it by calcfn if it was not cached yet.
+        template<class T, class CalcFn>
+        T get(const ModelVolume &volume, const Transform3d &trafo, std::optional<T> Entry::*value, CalcFn &&calcfn);
+    };
+    mutable TransformedCache                m_transformed_cache;
+
     inline bool check() {
         assert(this->id().valid());
         assert(this->config.id().valid());
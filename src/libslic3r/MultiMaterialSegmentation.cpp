@@ -63,6 +63,8 @@ const constexpr double MM_SEGMENTATION_MAX_PROJECTION_DISTANCE_SCALED = scaled<d
 const constexpr double MM_SEGMENTATION_MAX_SNAP_DISTANCE_SCALED       = scaled<double>(0.01);
 const constexpr double MM_SEGMENTATION_SNAP_ANGLE_THRESHOLD           = PI / 12.;
 const constexpr double MM_SEGMENTATION_SNAP_ANGLE_MAX_DISTANCE_SCALED = scaled<double>(0.1);
+// Maximum number of layers, for which the intermediate projection data are kept in memory at once.
+const constexpr size_t MM_SEGMENTATION_MAX_LAYERS_PER_SLAB            = 256;
 
 enum VD_ANNOTATION : Voronoi::VD::cell_type::color_type {
     VERTEX_ON_CONTOUR = 1,
@@ -1971,26 +1973,89 @@ static void update_color_changes_using_color_projection_ranges(ColorProjectionEx
     }
 }
 
-static std::vector<ColorPolygons> slice_model_volume_with_color(const ModelVolume                                              &model_volume,
-                                                               const std::function<ModelVolumeFacetsInfo(const ModelVolume &)> &extract_facets_info,
-                                                               const std::vector<float>                                        &layer_zs,
-                                                               const PrintObject                                               &print_object,
-                                                               const size_t                                                     num_facets_states)
+static indexed_triangle_set_with_color extract_model_volume_mesh_with_color(const ModelVolume &model_volume, const ModelVolumeFacetsInfo &facets_info)
 {
-    const ModelVolumeFacetsInfo facets_info = extract_facets_info(model_volume);
+    if (const int volume_extruder_id = model_volume.extruder_id(); facets_info.replace_default_extruder && !facets_info.is_painted && volume_extruder_id >= 0) {
+        const TriangleMesh &mesh = model_volume.mesh();
+        return {mesh.its.indices, mesh.its.vertices, std::vector<uint8_t>(mesh.its.indices.size(), uint8_t(volume_extruder_id))};
+    }
+
+    return facets_info.facets_annotation.get_all_facets_strict_with_colors(model_volume);
+}
+
+// Remove the vertices not referenced by any face. The order of the remaining vertices is kept.
+static void compactify_vertices(indexed_triangle_set_with_color &mesh)
+{
+    std::vector<int> vertex_map(mesh.vertices.size(), -1);
+    for (const stl_triangle_vertex_indices &face : mesh.indices)
+        for (int i = 0; i < 3; ++i)
+            vertex_map[face(i)] = 0;
 
-    const auto extract_mesh_with_color = [&model_volume, &facets_info]() -> indexed_triangle_set_with_color {
-        if (const int volume_extruder_id = model_volume.extruder_id(); facets_info.replace_default_extruder && !facets_info.is_painted && volume_extruder_id >= 0) {
-            const TriangleMesh &mesh = model_volume.mesh();
-            return {mesh.its.indices, mesh.its.vertices, std::vector<uint8_t>(mesh.its.indices.size(), uint8_t(volume_extruder_id))};
+    int new_vertex_idx = 0;
+    for (size_t vertex_idx = 0; vertex_idx < vertex_map.size(); ++vertex_idx)
+        if (vertex_map[vertex_idx] != -1) {
+            mesh.vertices[new_vertex_idx] = mesh.vertices[vertex_idx];
+            vertex_map[vertex_idx]        = new_vertex_idx++;
         }
 
-        return facets_info.facets_annotation.get_all_facets_strict_with_colors(model_volume);
-    };
+    mesh.vertices.resize(new_vertex_idx);
+    mesh.vertices.shrink_to_fit();
+
+    for (stl_triangle_vertex_indices &face : mesh.indices)
+        for (int i = 0; i < 3; ++i)
+            face(i) = vertex_map[face(i)];
+}
+
+// Returns the faces of the mesh with color, which span the Z range [min_z, max_z] after the transformation, to slice just
+// the layers of one slab. The faces reaching above max_z are kept in the mesh for the following slabs, the other faces are
+// not needed anymore and they are released. The order of the faces and vertices is kept in both meshes, so slicing the
+// returned mesh gives the same polygons as slicing the whole mesh.
+static indexed_triangle_set_with_color split_mesh_with_color_by_slab(indexed_triangle_set_with_color &mesh, const Transform3d &trafo, const float min_z, const float max_z)
+{
+    std::vector<float> vertices_z(mesh.vertices.size());
+    for (size_t vertex_idx = 0; vertex_idx < mesh.vertices.size(); ++vertex_idx)
+        vertices_z[vertex_idx] = float((trafo * mesh.vertices[vertex_idx].cast<double>()).z());
+
+    indexed_triangle_set_with_color slab_mesh;
+    slab_mesh.vertices = mesh.vertices;
+
+    size_t num_kept_faces = 0;
+    for (size_t face_idx = 0; face_idx < mesh.indices.size(); ++face_idx) {
+        const stl_triangle_vertex_indices &face       = mesh.indices[face_idx];
+        const float                        face_min_z = std::min({vertices_z[face(0)], vertices_z[face(1)], vertices_z[face(2)]});
+        const float                        face_max_z = std::max({vertices_z[face(0)], vertices_z[face(1)], vertices_z[face(2)]});
+
+        if (face_max_z >= min_z - float(EPSILON) && face_min_z <= max_z + float(EPSILON)) {
+            slab_mesh.indices.emplace_back(face);
+            slab_mesh.colors.emplace_back(mesh.colors[face_idx]);
+        }
+
+        if (face_max_z > max_z - float(EPSILON)) {
+            mesh.indices[num_kept_faces]  = face;
+            mesh.colors[num_kept_faces++] = mesh.colors[face_idx];
+        }
+    }
 
-    const indexed_triangle_set_with_color mesh_with_color = extract_mesh_with_color();
-    const Transform3d                     trafo           = print_object.trafo_centered() * model_volume.get_matrix();
-    const MeshSlicingParams               slicing_params{trafo};
+    mesh.indices.resize(num_kept_faces);
+    mesh.indices.shrink_to_fit();
+    mesh.colors.resize(num_kept_faces);
+    mesh.colors.shrink_to_fit();
+    compactify_vertices(mesh);
+    compactify_vertices(slab_mesh);
+
+    return slab_mesh;
+}
+
+// Slice the mesh with color extracted by extract_model_volume_mesh_with_color() at the given layer_zs, which may be just a slab of the object layers.
+static std::vector<ColorPolygons> slice_model_volume_with_color(const ModelVolume                     &model_volume,
+                                                               const ModelVolumeFacetsInfo           &facets_info,
+                                                               const indexed_triangle_set_with_color &mesh_with_color,
+                                                               const std::vector<float>              &layer_zs,
+                                                               const PrintObject                     &print_object,
+                                                               const size_t                           num_facets_states)
+{
+    const Transform3d       trafo = print_object.trafo_centered() * model_volume.get_matrix();
+    const MeshSlicingParams slicing_params{trafo};
 
     std::vector<ColorPolygons> color_polygons_per_layer = slice_mesh(mesh_with_color, layer_zs, slicing_params);
 
@@ -2079,18 +2144,17 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
                                                               const float                                                      segmentation_interlocking_depth,
                                                               const bool                                                       segmentation_interlocking_beam,
                                                               const IncludeTopAndBottomLayers                                  include_top_and_bottom_layers,
-                                                              const std::function<void()>                                     &throw_on_cancel_callback)
+                                                              const std::function<void()>                                     &throw_on_cancel_callback,
+                                                              const size_t                                                     max_layers_per_slab)
 {
     const size_t                                   num_layers    = print_object.layers().size();
     const SpanOfConstPtrs<Layer>                   layers        = print_object.layers();
 
-    std::vector<ExPolygons>                input_expolygons(num_layers);
-    std::vector<ColorProjectionExPolygons> input_expolygons_projection_lines_layers(num_layers);
-    std::vector<std::vector<ColorLines>>   color_polygons_lines_layers(num_layers);
+    std::vector<ExPolygons> input_expolygons(num_layers);
 
     // Merge all regions and remove small holes
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slices preprocessing in parallel - Begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &input_expolygons_projection_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
 
@@ -2113,8 +2177,7 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
             // Such close points sometimes caused that the Voronoi diagram has self-intersecting edges around these vertices.
             // This consequently leads to issues with the extraction of colored segments by function extract_colored_segments.
             // Calling expolygons_simplify fixed these issues.
-            input_expolygons[layer_idx]                         = remove_duplicates(expolygons_simplify(offset_ex(ex_polygons, -10.f * float(SCALED_EPSILON)), 5 * SCALED_EPSILON), scaled<coord_t>(0.01), PI / 6);
-            input_expolygons_projection_lines_layers[layer_idx] = create_color_projection_expolygons(input_expolygons[layer_idx]);
+            input_expolygons[layer_idx] = remove_duplicates(expolygons_simplify(offset_ex(ex_polygons, -10.f * float(SCALED_EPSILON)), 5 * SCALED_EPSILON), scaled<coord_t>(0.01), PI / 6);
 
             if constexpr (MM_SEGMENTATION_DEBUG_INPUT) {
                 export_processed_input_expolygons_to_svg(debug_out_path("mm-input-%d.svg", layer_idx), layers[layer_idx]->regions(), input_expolygons[layer_idx]);
@@ -2123,119 +2186,164 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slices preprocessing in parallel - End";
 
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - Begin";
-    const std::vector<float> layer_zs = get_print_object_layers_zs(layers);
-    for (const ModelVolume *mv : print_object.model_object()->volumes) {
-        std::vector<ColorPolygons> color_polygons_per_layer = slice_model_volume_with_color(*mv, extract_facets_info, layer_zs, print_object, num_facets_states);
+    // Painted meshes of all model volumes are extracted just once. Each slab takes just the faces spanning its layers,
+    // the faces below the slab are released from the painted meshes after the slab is sliced.
+    const ModelVolumePtrs                        &model_volumes = print_object.model_object()->volumes;
+    std::vector<ModelVolumeFacetsInfo>            model_volumes_facets_info;
+    std::vector<indexed_triangle_set_with_color>  model_volumes_meshes_with_color;
+    model_volumes_facets_info.reserve(model_volumes.size());
+    model_volumes_meshes_with_color.reserve(model_volumes.size());
+    for (const ModelVolume *mv : model_volumes) {
+        const ModelVolumeFacetsInfo &facets_info = model_volumes_facets_info.emplace_back(extract_facets_info(*mv));
+        model_volumes_meshes_with_color.emplace_back(extract_model_volume_mesh_with_color(*mv, facets_info));
+    }
+
+    const std::vector<float>             layer_zs = get_print_object_layers_zs(layers);
+    std::vector<std::vector<ExPolygons>> segmented_regions(num_layers, std::vector<ExPolygons>(num_facets_states));
+
+    // The projection of painted triangles and the segmentation of a layer only depend on the layer itself, the dependencies
+    // between layers are resolved later by segmentation_top_and_bottom_layers() and merge_segmented_layers().
+    // Thus the layers are segmented in slabs and the per layer projection data are released after each slab is finished
+    // to keep the peak memory bounded for very tall objects.
+    assert(max_layers_per_slab > 0);
+    for (size_t slab_begin = 0; slab_begin < num_layers; slab_begin += max_layers_per_slab) {
+        const size_t slab_end  = std::min(num_layers, slab_begin + max_layers_per_slab);
+        const size_t slab_size = slab_end - slab_begin;
+
+        // Indexed by a layer index relative to slab_begin.
+        std::vector<ColorProjectionExPolygons> input_expolygons_projection_lines_layers(slab_size);
+        std::vector<std::vector<ColorLines>>   color_polygons_lines_layers(slab_size);
+
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles of layers " << slab_begin << " to " << slab_end << " - Begin";
+        const std::vector<float> slab_layer_zs(layer_zs.begin() + slab_begin, layer_zs.begin() + slab_end);
+        for (size_t volume_idx = 0; volume_idx < model_volumes.size(); ++volume_idx) {
+            const ModelVolume                     &model_volume = *model_volumes[volume_idx];
+            const Transform3d                      trafo        = print_object.trafo_centered() * model_volume.get_matrix();
+            const indexed_triangle_set_with_color  slab_mesh    = split_mesh_with_color_by_slab(model_volumes_meshes_with_color[volume_idx], trafo, slab_layer_zs.front(), slab_layer_zs.back());
+            if (slab_mesh.indices.empty())
+                continue;
 
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&color_polygons_per_layer, &color_polygons_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
-                throw_on_cancel_callback();
+            std::vector<ColorPolygons> color_polygons_per_layer = slice_model_volume_with_color(model_volume, model_volumes_facets_info[volume_idx], slab_mesh, slab_layer_zs,
+                                                                                                print_object, num_facets_states);
 
-                ColorPolygons &raw_color_polygons = color_polygons_per_layer[layer_idx];
-                filter_out_small_color_polygons(raw_color_polygons, POLYGON_FILTER_MIN_AREA_SCALED, POLYGON_FILTER_MIN_OFFSET_SCALED);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, slab_size), [&color_polygons_per_layer, &color_polygons_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+                for (size_t slab_layer_idx = range.begin(); slab_layer_idx < range.end(); ++slab_layer_idx) {
+                    throw_on_cancel_callback();
 
-                if (raw_color_polygons.empty())
-                    continue;
+                    ColorPolygons &raw_color_polygons = color_polygons_per_layer[slab_layer_idx];
+                    filter_out_small_color_polygons(raw_color_polygons, POLYGON_FILTER_MIN_AREA_SCALED, POLYGON_FILTER_MIN_OFFSET_SCALED);
 
-                // Convert ColorPolygons into the vector of ColorPoints to perform several filtrations that are performed on points.
-                color_polygons_lines_layers[layer_idx].reserve(color_polygons_lines_layers[layer_idx].size() + raw_color_polygons.size());
-                for (const ColorPoints &color_polygon_points : color_polygons_to_color_points(raw_color_polygons)) {
-                    ColorPoints color_polygon_points_filtered;
-                    color_polygon_points_filtered.reserve(color_polygon_points.size());
+                    if (raw_color_polygons.empty())
+                        continue;
 
-                    douglas_peucker(color_polygon_points.begin(), color_polygon_points.end(), std::back_inserter(color_polygon_points_filtered), POLYGON_COLOR_FILTER_TOLERANCE_SCALED, POLYGON_COLOR_FILTER_DISTANCE_SCALED);
+                    // Convert ColorPolygons into the vector of ColorPoints to perform several filtrations that are performed on points.
+                    std::vector<ColorLines> &color_polygons_lines = color_polygons_lines_layers[slab_layer_idx];
+                    color_polygons_lines.reserve(color_polygons_lines.size() + raw_color_polygons.size());
+                    for (const ColorPoints &color_polygon_points : color_polygons_to_color_points(raw_color_polygons)) {
+                        ColorPoints color_polygon_points_filtered;
+                        color_polygon_points_filtered.reserve(color_polygon_points.size());
 
-                    if (color_polygon_points_filtered.size() < 3)
-                        continue;
+                        douglas_peucker(color_polygon_points.begin(), color_polygon_points.end(), std::back_inserter(color_polygon_points_filtered), POLYGON_COLOR_FILTER_TOLERANCE_SCALED, POLYGON_COLOR_FILTER_DISTANCE_SCALED);
+
+                        if (color_polygon_points_filtered.size() < 3)
+                            continue;
 
-                    filter_color_of_small_segments(color_polygon_points_filtered, POLYGON_COLOR_FILTER_DISTANCE_SCALED);
-                    assert(is_valid_color_polygon_points(color_polygon_points_filtered));
+                        filter_color_of_small_segments(color_polygon_points_filtered, POLYGON_COLOR_FILTER_DISTANCE_SCALED);
+                        assert(is_valid_color_polygon_points(color_polygon_points_filtered));
 
-                    color_polygons_lines_layers[layer_idx].emplace_back(color_points_to_color_lines(color_polygon_points_filtered));
+                        color_polygons_lines.emplace_back(color_points_to_color_lines(color_polygon_points_filtered));
+                    }
                 }
-            }
-        }); // end of parallel_for
-    }
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - End";
+            }); // end of parallel_for
+        }
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles of layers " << slab_begin << " to " << slab_end << " - End";
 
-    if constexpr (MM_SEGMENTATION_DEBUG_FILTERED_COLOR_LINES) {
-        for (size_t layer_idx = 0; layer_idx < print_object.layers().size(); ++layer_idx) {
-            export_color_polygons_lines_to_svg(debug_out_path("mm-filtered-color-line-%d.svg", layer_idx), color_polygons_lines_layers[layer_idx], input_expolygons[layer_idx]);
+        if constexpr (MM_SEGMENTATION_DEBUG_FILTERED_COLOR_LINES) {
+            for (size_t layer_idx = slab_begin; layer_idx < slab_end; ++layer_idx) {
+                export_color_polygons_lines_to_svg(debug_out_path("mm-filtered-color-line-%d.svg", layer_idx), color_polygons_lines_layers[layer_idx - slab_begin], input_expolygons[layer_idx]);
+            }
         }
-    }
 
-    // Project sliced ColorPolygons on sliced layers (input_expolygons).
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Projection of painted triangles - Begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&color_polygons_lines_layers, &input_expolygons_projection_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
-            throw_on_cancel_callback();
+        // Project sliced ColorPolygons on sliced layers (input_expolygons).
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Projection of painted triangles of layers " << slab_begin << " to " << slab_end << " - Begin";
+        tbb::parallel_for(tbb::blocked_range<size_t>(slab_begin, slab_end), [slab_begin, &input_expolygons, &color_polygons_lines_layers, &input_expolygons_projection_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+                throw_on_cancel_callback();
 
-            // For each ColorLine, find the nearest ColorProjectionLines and project the ColorLine on each ColorProjectionLine.
-            const AABBTreeLines::LinesDistancer<ColorProjectionLineWrapper> color_projection_lines_distancer{create_color_projection_lines_mapping(input_expolygons_projection_lines_layers[layer_idx])};
-            project_color_lines_on_color_projection_lines(color_polygons_lines_layers[layer_idx], color_projection_lines_distancer);
+                const size_t               slab_layer_idx                    = layer_idx - slab_begin;
+                ColorProjectionExPolygons &input_expolygons_projection_lines = input_expolygons_projection_lines_layers[slab_layer_idx];
+                input_expolygons_projection_lines = create_color_projection_expolygons(input_expolygons[layer_idx]);
 
-            // For each ColorProjectionLine, find the nearest ColorLines and project them on the ColorProjectionLine.
-            const AABBTreeLines::LinesDistancer<ColorLine> color_lines_distancer{flatten_color_lines(color_polygons_lines_layers[layer_idx])};
-            project_color_projection_expolygons_on_color_lines(input_expolygons_projection_lines_layers[layer_idx], color_lines_distancer);
-        }
-    }); // end of parallel_for
-    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - Projection of painted triangles - End";
+                // For each ColorLine, find the nearest ColorProjectionLines and project the ColorLine on each ColorProjectionLine.
+                const AABBTreeLines::LinesDistancer<ColorProjectionLineWrapper> color_projection_lines_distancer{create_color_projection_lines_mapping(input_expolygons_projection_lines)};
+                project_color_lines_on_color_projection_lines(color_polygons_lines_layers[slab_layer_idx], color_projection_lines_distancer);
 
-    std::vector<std::vector<ExPolygons>>  segmented_regions(num_layers);
-    segmented_regions.assign(num_layers, std::vector<ExPolygons>(num_facets_states));
+                // For each ColorProjectionLine, find the nearest ColorLines and project them on the ColorProjectionLine.
+                const AABBTreeLines::LinesDistancer<ColorLine> color_lines_distancer{flatten_color_lines(color_polygons_lines_layers[slab_layer_idx])};
+                project_color_projection_expolygons_on_color_lines(input_expolygons_projection_lines, color_lines_distancer);
 
-    // Be aware that after the projection of the ColorPolygons and its postprocessing isn't
-    // ensured that consistency of the color_prev. So, only color_next can be used.
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - Begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&input_expolygons_projection_lines_layers, &segmented_regions, &input_expolygons, &num_facets_states, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
-            throw_on_cancel_callback();
+                // The color lines were projected and they are not needed anymore.
+                color_polygons_lines_layers[slab_layer_idx] = {};
+            }
+        }); // end of parallel_for
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Projection of painted triangles of layers " << slab_begin << " to " << slab_end << " - End";
 
-            ColorProjectionExPolygons &input_expolygons_projection_lines = input_expolygons_projection_lines_layers[layer_idx];
-            for (ColorProjectionExPolygon &input_expolygon_projection_lines : input_expolygons_projection_lines) {
-                const size_t expolygon_idx = &input_expolygon_projection_lines - input_expolygons_projection_lines.data();
+        // Be aware that after the projection of the ColorPolygons and its postprocessing isn't
+        // ensured that consistency of the color_prev. So, only color_next can be used.
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of layers " << slab_begin << " to " << slab_end << " in parallel - Begin";
+        tbb::parallel_for(tbb::blocked_range<size_t>(slab_begin, slab_end), [slab_begin, &input_expolygons_projection_lines_layers, &segmented_regions, &input_expolygons, &num_facets_states, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+                throw_on_cancel_callback();
 
-                if constexpr (MM_SEGMENTATION_DEBUG_COLOR_RANGES) {
-                    export_color_projection_lines_color_ranges_to_svg(debug_out_path("mm-color-ranges-%d-%d.svg", layer_idx, expolygon_idx), input_expolygon_projection_lines, input_expolygons[layer_idx]);
-                }
+                ColorProjectionExPolygons &input_expolygons_projection_lines = input_expolygons_projection_lines_layers[layer_idx - slab_begin];
+                for (ColorProjectionExPolygon &input_expolygon_projection_lines : input_expolygons_projection_lines) {
+                    const size_t expolygon_idx = &input_expolygon_projection_lines - input_expolygons_projection_lines.data();
 
-                update_color_changes_using_color_projection_ranges(input_expolygon_projection_lines);
-                filter_projected_color_points_on_expolygon(input_expolygon_projection_lines);
+                    if constexpr (MM_SEGMENTATION_DEBUG_COLOR_RANGES) {
+                        export_color_projection_lines_color_ranges_to_svg(debug_out_path("mm-color-ranges-%d-%d.svg", layer_idx, expolygon_idx), input_expolygon_projection_lines, input_expolygons[layer_idx]);
+                    }
 
-                std::vector<ColorPoints> color_polygons_points = convert_color_expolygon_projection_lines_to_color_points(input_expolygon_projection_lines);
-                if (color_polygons_points.empty())
-                    continue;
+                    update_color_changes_using_color_projection_ranges(input_expolygon_projection_lines);
+                    filter_projected_color_points_on_expolygon(input_expolygon_projection_lines);
 
-                snap_projected_color_points_to_nearest_angles(color_polygons_points);
+                    std::vector<ColorPoints> color_polygons_points = convert_color_expolygon_projection_lines_to_color_points(input_expolygon_projection_lines);
+                    if (color_polygons_points.empty())
+                        continue;
 
-                if constexpr (MM_SEGMENTATION_DEBUG_COLORIZED_POLYGONS) {
-                    export_color_polygons_points_to_svg(debug_out_path("mm-projected-color_polygon-%d-%d.svg", layer_idx, expolygon_idx), color_polygons_points, input_expolygons[layer_idx]);
-                }
+                    snap_projected_color_points_to_nearest_angles(color_polygons_points);
 
-                const std::vector<ColoredLines> colored_polygons = color_points_to_colored_lines(color_polygons_points);
-                assert(!colored_polygons.empty());
-                if (has_polygons_only_one_color(colored_polygons)) {
-                    // When the whole ExPolygon is painted using the same color, it is not needed to construct a Voronoi diagram for the segmentation of this ExPolygon.
-                    assert(!colored_polygons.front().empty());
-                    segmented_regions[layer_idx][size_t(colored_polygons.front().front().color)].emplace_back(input_expolygons[layer_idx][expolygon_idx]);
-                } else {
-                    std::vector<ExPolygons> colored_segments_by_states = extract_colored_segments(colored_polygons, num_facets_states, layer_idx);
-                    for (size_t state_idx = 0; state_idx < num_facets_states; ++state_idx) {
-                        if (colored_segments_by_states[state_idx].empty())
-                            continue;
+                    if constexpr (MM_SEGMENTATION_DEBUG_COLORIZED_POLYGONS) {
+                        export_color_polygons_points_to_svg(debug_out_path("mm-projected-color_polygon-%d-%d.svg", layer_idx, expolygon_idx), color_polygons_points, input_expolygons[layer_idx]);
+                    }
 
-                        Slic3r::append(segmented_regions[layer_idx][state_idx], std::move(colored_segments_by_states[state_idx]));
+                    const std::vector<ColoredLines> colored_polygons = color_points_to_colored_lines(color_polygons_points);
+                    assert(!colored_polygons.empty());
+                    if (has_polygons_only_one_color(colored_polygons)) {
+                        // When the whole ExPolygon is painted using the same color, it is not needed to construct a Voronoi diagram for the segmentation of this ExPolygon.
+                        assert(!colored_polygons.front().empty());
+                        segmented_regions[layer_idx][size_t(colored_polygons.front().front().color)].emplace_back(input_expolygons[layer_idx][expolygon_idx]);
+                    } else {
+                        std::vector<ExPolygons> colored_segments_by_states = extract_colored_segments(colored_polygons, num_facets_states, layer_idx);
+                        for (size_t state_idx = 0; state_idx < num_facets_states; ++state_idx) {
+                            if (colored_segments_by_states[state_idx].empty())
+                                continue;
+
+                            Slic3r::append(segmented_regions[layer_idx][state_idx], std::move(colored_segments_by_states[state_idx]));
+                        }
                     }
                 }
-            }
 
-            if constexpr (MM_SEGMENTATION_DEBUG_REGIONS) {
-                export_regions_to_svg(debug_out_path("mm-regions-non-merged-%d.svg", layer_idx), segmented_regions[layer_idx], input_expolygons[layer_idx]);
+                // Release the projection data of this layer as soon as the layer is segmented.
+                input_expolygons_projection_lines = {};
+
+                if constexpr (MM_SEGMENTATION_DEBUG_REGIONS) {
+                    export_regions_to_svg(debug_out_path("mm-regions-non-merged-%d.svg", layer_idx), segmented_regions[layer_idx], input_expolygons[layer_idx]);
+                }
             }
-        }
-    }); // end of parallel_for
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - End";
+        }); // end of parallel_for
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of layers " << slab_begin << " to " << slab_end << " in parallel - End" << log_memory_info();
+    }
+    model_volumes_meshes_with_color = {};
     throw_on_cancel_callback();
 
     // The first index is extruder number (includes default extruder), and the second one is layer number
@@ -2273,7 +2381,7 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
         return {mv.mm_segmentation_facets, mv.is_mm_painted(), false};
     };
 
-    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_width, interlocking_depth, interlocking_beam, IncludeTopAndBottomLayers::Yes, throw_on_cancel_callback);
+    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_width, interlocking_depth, interlocking_beam, IncludeTopAndBottomLayers::Yes, throw_on_cancel_callback, MM_SEGMENTATION_MAX_LAYERS_PER_SLAB);
 }
 
 // Returns fuzzy skin segmentation based on painting in fuzzy skin segmentation gizmo
@@ -2292,7 +2400,7 @@ std::vector<std::vector<ExPolygons>> fuzzy_skin_segmentation_by_painting(const P
         max_external_perimeter_width = std::max<float>(max_external_perimeter_width, region.flow(print_object, frExternalPerimeter, print_object.config().layer_height).width());
     }
 
-    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_external_perimeter_width, 0.f, false, IncludeTopAndBottomLayers::No, throw_on_cancel_callback);
+    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_external_perimeter_width, 0.f, false, IncludeTopAndBottomLayers::No, throw_on_cancel_callback, MM_SEGMENTATION_MAX_LAYERS_PER_SLAB);
 }
 
 
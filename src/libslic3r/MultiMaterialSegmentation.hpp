@@ -50,13 +50,16 @@ struct ModelVolumeFacetsInfo {
 BoundingBox get_extents(const std::vector<ColoredLines> &colored_polygons);
 
 // Returns segmentation based on painting in segmentation gizmos.
+// The painted triangles are projected and the layers are segmented in slabs of at most max_layers_per_slab layers.
 std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject                                               &print_object,
                                                               const std::function<ModelVolumeFacetsInfo(const ModelVolume &)> &extract_facets_info,
                                                               size_t                                                           num_facets_states,
                                                               float                                                            segmentation_max_width,
                                                               float                                                            segmentation_interlocking_depth,
+                                                              bool                                                             segmentation_interlocking_beam,
                                                               IncludeTopAndBottomLayers                                        include_top_and_bottom_layers,
-                                                              const std::function<void()>                                     &throw_on_cancel_callback);
+                                                              const std::function<void()>                                     &throw_on_cancel_callback,
+                                                              size_t                                                           max_layers_per_slab);
 
 // Returns multi-material segmentation based on painting in multi-material segmentation gizmo
 std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
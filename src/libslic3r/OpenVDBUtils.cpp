@@ -323,4 +323,9 @@ bool is_grid_empty(const VoxelGrid &grid)
     return grid.grid.empty();
 }
 
+size_t grid_memory_usage(const VoxelGrid &grid)
+{
+    return size_t(grid.grid.memUsage());
+}
+
 } // namespace Slic3r
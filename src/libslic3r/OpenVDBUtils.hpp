@@ -89,6 +89,9 @@ void grid_intersection(VoxelGrid &grid, VoxelGrid &arg);
 
 bool is_grid_empty(const VoxelGrid &grid);
 
+// Memory held by the grid in bytes.
+size_t grid_memory_usage(const VoxelGrid &grid);
+
 } // namespace Slic3r
 
 #endif // OPENVDBUTILS_HPP
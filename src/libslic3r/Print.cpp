@@ -898,7 +898,21 @@ void Print::process()
         }
     }, tbb::simple_partitioner());
 
-    // The following step writes to m_shared_regions, it should not run in parallel.
+    {
+        // The support spots are searched just once for all PrintObjects sharing the same PrintObjectRegions and stored
+        // there. The first PrintObject of each PrintObjectRegions runs the step in parallel, the step writes to its
+        // own PrintObjectRegions only.
+        std::vector<PrintObject*>                       objects_to_search;
+        std::unordered_set<const PrintObjectRegions*>   shared_regions_searched;
+        for (PrintObject *obj : m_objects)
+            if (shared_regions_searched.insert(obj->shared_regions()).second)
+                objects_to_search.emplace_back(obj);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, objects_to_search.size(), 1), [&objects_to_search](const tbb::blocked_range<size_t> &range) {
+            for (size_t idx = range.begin(); idx < range.end(); ++ idx)
+                objects_to_search[idx]->generate_support_spots();
+        }, tbb::simple_partitioner());
+    }
+    // The rest of the PrintObjects reuse the support spots stored into their PrintObjectRegions by the step above.
     for (PrintObject *obj : m_objects)
         obj->generate_support_spots();
     // check data from previous step, format the error message(s) and send alert to ui
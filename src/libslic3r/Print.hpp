@@ -376,6 +376,8 @@ private:
     // to be called from Print only.
     friend class Print;
     friend class PrintBaseWithState<PrintStep, psCount>;
+    // to restore the layers from a snapshot.
+    friend class PrintSnapshot;
 
 	PrintObject(Print* print, ModelObject* model_object, const Transform3d& trafo, PrintInstances&& instances);
     ~PrintObject() override {
@@ -410,6 +412,7 @@ private:
     void clear_fills();
     void infill();
     void ironing();
+    // Writes to m_shared_regions, thus it may only run in parallel over PrintObjects not sharing their PrintObjectRegions.
     void generate_support_spots();
     void generate_support_material();
     void estimate_curled_extrusions();
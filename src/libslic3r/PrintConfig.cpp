@@ -20,6 +20,7 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include "PrintConfig.hpp"
+#include "Format/3mf.hpp"
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
@@ -187,6 +188,12 @@ static const t_config_enum_values s_keys_map_SupportMaterialInterfacePattern {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SupportMaterialInterfacePattern)
 
+static const t_config_enum_values s_keys_map_SupportTreeCollisionBackend {
+    { "polygons",       stcbPolygons },
+    { "distance_field", stcbDistanceField }
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SupportTreeCollisionBackend)
+
 static const t_config_enum_values s_keys_map_SeamPosition {
     { "random",         spRandom },
     { "nearest",        spNearest },
@@ -210,6 +217,12 @@ static const t_config_enum_values s_keys_map_SLADisplayOrientation = {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLADisplayOrientation)
 
+static const t_config_enum_values s_keys_map_SLARasterizer = {
+    { "agg",            slarAGG },
+    { "scanline",       slarScanline }
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLARasterizer)
+
 static const t_config_enum_values s_keys_map_SLAPillarConnectionMode = {
     {"zigzag",          int(SLAPillarConnectionMode::zigzag)},
     {"cross",           int(SLAPillarConnectionMode::cross)},
@@ -281,6 +294,14 @@ static t_config_enum_values s_keys_map_TopOnePerimeterType {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(TopOnePerimeterType)
 
+static const t_config_enum_values s_keys_map_ThreeMFCompression = {
+    { "store",   int(ThreeMFCompression::Store)   },
+    { "fast",    int(ThreeMFCompression::Fast)    },
+    { "default", int(ThreeMFCompression::Default) },
+    { "best",    int(ThreeMFCompression::Best)    }
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(ThreeMFCompression)
+
 static const t_config_enum_values s_keys_map_TowerSpeeds{
     { "layer1",  tsLayer1    },
     { "layer2",  tsLayer2    },
@@ -3520,6 +3541,21 @@ void PrintConfigDef::init_fff_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionFloat(1.));
 
+    def = this->add("support_tree_collision_backend", coEnum);
+    def->label = L("Collision detection");
+    def->category = L("Support material");
+    // TRN PrintSettings: "Organic supports" > "Collision detection"
+    def->tooltip = L("How the branches of organic supports are kept away from the object when they are smoothed. "
+                     "Polygons test the branches against the outlines of the object in each layer. "
+                     "Distance field samples a distance map of each layer, which is faster on complex objects "
+                     "with many branches.");
+    def->set_enum<SupportTreeCollisionBackend>({
+        { "polygons",       L("Polygons") },
+        { "distance_field", L("Distance field") }
+    });
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionEnum<SupportTreeCollisionBackend>(stcbPolygons));
+
     def = this->add("support_tree_top_rate", coPercent);
     def->label = L("Branch Density");
     def->category = L("Support material");
@@ -4759,6 +4795,18 @@ void PrintConfigDef::init_sla_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionFloat(0.001));
 
+    def = this->add("sla_rasterizer", coEnum);
+    def->label = L("Rasterizer");
+    def->tooltip = L("The algorithm drawing the layer images. AGG is the general purpose anti-aliasing "
+                     "rasterizer. Scanline computes the exact coverage of the pixels by the polygons "
+                     "without supersampling, the images differ from AGG only slightly on the edges.");
+    def->set_enum<SLARasterizer>({
+        { "agg",            L("AGG") },
+        { "scanline",       L("Scanline") }
+    });
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionEnum<SLARasterizer>(slarAGG));
+
     // Declare retract values for material profile, overriding the print and printer profiles.
     for (const char* opt_key : {
         // float
@@ -5696,6 +5744,12 @@ CLIInputConfigDef::CLIInputConfigDef()
     def->tooltip = ("Name(s) of the material preset(s) used for slicing.\n"
         "Could be filaments or sla_material preset name(s) depending on printer tochnology");
     def->set_default_value(new ConfigOptionStrings());
+
+    def = this->add("from_snapshot", coString);
+    def->label = L("Load print snapshot");
+    def->tooltip = L("Load the sliced objects from a print snapshot stored by --export-snapshot instead of slicing them again. "
+                     "The snapshot is only accepted for the same models. Print settings differing from the snapshot "
+                     "only recalculate the steps they influence.");
 }
 
 CLIActionsConfigDef::CLIActionsConfigDef()
@@ -5898,6 +5952,28 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("The file where the output will be written (if not specified, it will be based on the input file).");
     def->cli = "output|o";
 
+    def = this->add("export_snapshot", coString);
+    def->label = L("Export print snapshot");
+    def->tooltip = L("After slicing for G-code export, store the sliced objects into the given file, "
+                     "so that the G-code could be exported again by --from-snapshot without slicing.");
+
+    def = this->add("export_3mf_compression", coEnum);
+    def->label = L("3MF compression");
+    def->tooltip = L("Compression of the files stored into the exported 3MF. Storing without compression "
+                     "is the fastest, the best compression produces the smallest file.");
+    def->set_enum<ThreeMFCompression>({
+        { "store",   L("Store") },
+        { "fast",    L("Fast") },
+        { "default", L("Default") },
+        { "best",    L("Best") }
+        });
+    def->set_default_value(new ConfigOptionEnum<ThreeMFCompression>(ThreeMFCompression::Default));
+
+    def = this->add("nfp_cache", coString);
+    def->label = L("NFP cache file");
+    def->tooltip = L("Load the no-fit polygons calculated by previous runs from the given file before arranging "
+                     "and store them back afterwards, so that arranging the same parts again is faster.");
+
     def = this->add("datadir", coString);
     def->label = L("Data directory");
     def->tooltip = L("Load and store settings at the given directory. This is useful for maintaining different profiles or including configurations from a network storage.");
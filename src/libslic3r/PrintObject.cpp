@@ -579,15 +579,12 @@ void PrintObject::calculate_overhanging_perimeters()
 
         if (!regions_with_dynamic_speeds.empty()) {
             std::unordered_map<size_t, AABBTreeLines::LinesDistancer<CurledLine>> curled_lines;
-            std::unordered_map<size_t, AABBTreeLines::LinesDistancer<Linef>>      unscaled_polygons_lines;
-            for (const Layer *l : this->layers()) {
-                curled_lines[l->id()]            = AABBTreeLines::LinesDistancer<CurledLine>{l->curled_lines};
-                unscaled_polygons_lines[l->id()] = AABBTreeLines::LinesDistancer<Linef>{to_unscaled_linesf(l->lslices)};
-            }
-            curled_lines[size_t(-1)]            = {};
-            unscaled_polygons_lines[size_t(-1)] = {};
+            for (const Layer *l : this->layers())
+                curled_lines[l->id()] = AABBTreeLines::LinesDistancer<CurledLine>{l->curled_lines};
+            curled_lines[size_t(-1)] = {};
 
-            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &curled_lines, &unscaled_polygons_lines,
+            const AABBTreeLines::LinesDistancer<Linef> no_lslices_lines;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &curled_lines, &no_lslices_lines,
                                                                                &regions_with_dynamic_speeds](
                                                                                   const tbb::blocked_range<size_t> &range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
@@ -600,10 +597,10 @@ void PrintObject::calculate_overhanging_perimeters()
                         if (regions_with_dynamic_speeds.find(layer_region->m_region) == regions_with_dynamic_speeds.end()) {
                             continue;
                         }
-                        size_t prev_layer_id = l->lower_layer ? l->lower_layer->id() : size_t(-1);
+                        // The AABB tree over the lower layer lslices is shared with the other steps.
                         layer_region->m_perimeters =
                             ExtrusionProcessor::calculate_and_split_overhanging_extrusions(&layer_region->m_perimeters,
-                                                                                           unscaled_polygons_lines[prev_layer_id],
+                                                                                           l->lower_layer ? l->lower_layer->lslices_distancer() : no_lslices_lines,
                                                                                            curled_lines[l->id()]);
                     }
                 }
@@ -812,6 +809,7 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "support_tree_top_rate"
             || opt_key == "support_tree_branch_distance"
             || opt_key == "support_tree_tip_diameter"
+            || opt_key == "support_tree_collision_backend"
             || opt_key == "raft_expansion"
             || opt_key == "raft_first_layer_density"
             || opt_key == "raft_first_layer_expansion"
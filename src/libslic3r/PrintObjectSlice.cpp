@@ -1004,6 +1004,7 @@ void PrintObject::slice_volumes()
 	    	assert(layer.id() == 0);
 			layer.lslices = std::move(lslices_1st_layer);
             layer.lslice_indices_sorted_by_print_order = chain_expolygons(layer.lslices);
+            layer.invalidate_spatial_index();
 		}
 	}
 
@@ -0,0 +1,696 @@
+#include "PrintSnapshot.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+//FIXME replace with <boost/md5.hpp> after it becomes mainstream, see AppConfig.cpp.
+#include <boost/uuid/detail/md5.hpp>
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/ExtrusionEntity.hpp"
+#include "libslic3r/ExtrusionEntityCollection.hpp"
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+
+namespace Slic3r {
+
+namespace PrintSnapshotDetail {
+
+// Increase with any change of the data layout.
+static constexpr const uint32_t SnapshotVersion = 1;
+static constexpr const char     SnapshotMagic[8] = { 'P', 'S', 'S', 'N', 'A', 'P', 'S', 'H' };
+
+using Fingerprint = std::array<uint8_t, 16>;
+
+// Native endianity, native sizes of the coordinates. The snapshot is meant to be loaded by the same build
+// on the same machine, which is verified by the version and by the size of coord_t stored in the header.
+class Writer
+{
+public:
+    explicit Writer(std::ostream &os) : m_os(os) {}
+
+    template<typename T> void pod(const T &value) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+        m_os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void size(size_t n) { this->pod(uint64_t(n)); }
+    void bytes(const void *data, size_t n) { m_os.write(static_cast<const char*>(data), n); }
+    void string(const std::string &s) { this->size(s.size()); this->bytes(s.data(), s.size()); }
+    // Point, Vec3f, CurledLine ... are memcpy-able.
+    template<typename T, typename A> void array(const std::vector<T, A> &v) { this->size(v.size()); this->bytes(v.data(), v.size() * sizeof(T)); }
+
+private:
+    std::ostream &m_os;
+};
+
+class Reader
+{
+public:
+    Reader(const char *begin, const char *end) : m_ptr(begin), m_end(end) {}
+
+    template<typename T> T pod() {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+        T value;
+        this->bytes(&value, sizeof(T));
+        return value;
+    }
+    size_t size() {
+        auto n = this->pod<uint64_t>();
+        if (n > uint64_t(m_end - m_ptr))
+            throw_corrupted();
+        return size_t(n);
+    }
+    void bytes(void *data, size_t n) {
+        if (n > size_t(m_end - m_ptr))
+            throw_corrupted();
+        memcpy(data, m_ptr, n);
+        m_ptr += n;
+    }
+    std::string string() { std::string s(this->size(), 0); this->bytes(s.data(), s.size()); return s; }
+    template<typename T, typename A> void array(std::vector<T, A> &v) { v.resize(this->size()); this->bytes(v.data(), v.size() * sizeof(T)); }
+
+    [[noreturn]] static void throw_corrupted() { throw Slic3r::RuntimeError("The print snapshot is corrupted."); }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+static void write(Writer &out, const Polygon &poly) { out.array(poly.points); }
+static void read(Reader &in, Polygon &poly) { in.array(poly.points); }
+static void write(Writer &out, const Polyline &polyline) { out.array(polyline.points); }
+static void read(Reader &in, Polyline &polyline) { in.array(polyline.points); }
+
+static void write(Writer &out, const ExPolygon &expoly)
+{
+    write(out, expoly.contour);
+    out.size(expoly.holes.size());
+    for (const Polygon &hole : expoly.holes)
+        write(out, hole);
+}
+
+static void read(Reader &in, ExPolygon &expoly)
+{
+    read(in, expoly.contour);
+    expoly.holes.resize(in.size());
+    for (Polygon &hole : expoly.holes)
+        read(in, hole);
+}
+
+static void write(Writer &out, const BoundingBox &bbox)
+{
+    out.pod(bbox.min.x()); out.pod(bbox.min.y());
+    out.pod(bbox.max.x()); out.pod(bbox.max.y());
+    out.pod(uint8_t(bbox.defined));
+}
+
+static void read(Reader &in, BoundingBox &bbox)
+{
+    bbox.min.x() = in.pod<coord_t>(); bbox.min.y() = in.pod<coord_t>();
+    bbox.max.x() = in.pod<coord_t>(); bbox.max.y() = in.pod<coord_t>();
+    bbox.defined = in.pod<uint8_t>() != 0;
+}
+
+template<typename T>
+static void write(Writer &out, const std::vector<T> &v)
+{
+    out.size(v.size());
+    for (const T &item : v)
+        write(out, item);
+}
+
+template<typename T>
+static void read(Reader &in, std::vector<T> &v)
+{
+    v.resize(in.size());
+    for (T &item : v)
+        read(in, item);
+}
+
+static void write(Writer &out, const Surface &surface)
+{
+    out.pod(surface.surface_type);
+    write(out, surface.expolygon);
+    out.pod(surface.thickness);
+    out.pod(surface.thickness_layers);
+    out.pod(surface.bridge_angle);
+    out.pod(surface.extra_perimeters);
+}
+
+static void read(Reader &in, Surface &surface)
+{
+    surface.surface_type     = in.pod<SurfaceType>();
+    read(in, surface.expolygon);
+    surface.thickness        = in.pod<double>();
+    surface.thickness_layers = in.pod<unsigned short>();
+    surface.bridge_angle     = in.pod<double>();
+    surface.extra_perimeters = in.pod<unsigned short>();
+}
+
+static void write(Writer &out, const SurfaceCollection &surfaces)
+{
+    out.size(surfaces.surfaces.size());
+    for (const Surface &surface : surfaces.surfaces)
+        write(out, surface);
+}
+
+static void read(Reader &in, SurfaceCollection &surfaces)
+{
+    size_t n = in.size();
+    surfaces.surfaces.clear();
+    surfaces.surfaces.reserve(n);
+    for (size_t i = 0; i < n; ++ i) {
+        Surface surface(stInternal, ExPolygon());
+        read(in, surface);
+        surfaces.surfaces.emplace_back(std::move(surface));
+    }
+}
+
+// ExtrusionRole does not expose its bit mask, thus it is stored bit by bit.
+static void write(Writer &out, const ExtrusionRole role)
+{
+    uint16_t bits = 0;
+    for (uint16_t i = 0; i < uint16_t(ExtrusionRoleModifier::Count); ++ i)
+        if (role.has(ExtrusionRoleModifier(i)))
+            bits |= uint16_t(1 << i);
+    out.pod(bits);
+}
+
+static ExtrusionRole read_extrusion_role(Reader &in)
+{
+    const auto    bits = in.pod<uint16_t>();
+    ExtrusionRole role = ExtrusionRole::None;
+    for (uint16_t i = 0; i < uint16_t(ExtrusionRoleModifier::Count); ++ i)
+        if (bits & (1 << i))
+            role = role | ExtrusionRoleModifier(i);
+    return role;
+}
+
+static void write(Writer &out, const ExtrusionAttributes &attributes)
+{
+    write(out, attributes.role);
+    out.pod(attributes.mm3_per_mm);
+    out.pod(attributes.width);
+    out.pod(attributes.height);
+    out.pod(uint8_t(attributes.maybe_self_crossing));
+    out.pod(uint8_t(attributes.overhang_attributes.has_value()));
+    if (attributes.overhang_attributes) {
+        out.pod(attributes.overhang_attributes->start_distance_from_prev_layer);
+        out.pod(attributes.overhang_attributes->end_distance_from_prev_layer);
+        out.pod(attributes.overhang_attributes->proximity_to_curled_lines);
+    }
+}
+
+static ExtrusionAttributes read_extrusion_attributes(Reader &in)
+{
+    ExtrusionAttributes attributes(read_extrusion_role(in));
+    attributes.mm3_per_mm          = in.pod<double>();
+    attributes.width               = in.pod<float>();
+    attributes.height              = in.pod<float>();
+    attributes.maybe_self_crossing = in.pod<uint8_t>() != 0;
+    if (in.pod<uint8_t>() != 0) {
+        OverhangAttributes overhang;
+        overhang.start_distance_from_prev_layer = in.pod<float>();
+        overhang.end_distance_from_prev_layer   = in.pod<float>();
+        overhang.proximity_to_curled_lines      = in.pod<float>();
+        attributes.overhang_attributes = overhang;
+    }
+    return attributes;
+}
+
+static void write(Writer &out, const ExtrusionPath &path)
+{
+    out.array(path.polyline.points);
+    write(out, path.attributes());
+}
+
+static ExtrusionPath read_extrusion_path(Reader &in)
+{
+    Points points;
+    in.array(points);
+    return ExtrusionPath(Polyline(std::move(points)), read_extrusion_attributes(in));
+}
+
+static void write(Writer &out, const ExtrusionPaths &paths)
+{
+    out.size(paths.size());
+    for (const ExtrusionPath &path : paths)
+        write(out, path);
+}
+
+static void read(Reader &in, ExtrusionPaths &paths)
+{
+    size_t n = in.size();
+    paths.clear();
+    paths.reserve(n);
+    for (size_t i = 0; i < n; ++ i)
+        paths.emplace_back(read_extrusion_path(in));
+}
+
+enum class EntityTag : uint8_t {
+    Collection,
+    Path,
+    PathOriented,
+    MultiPath,
+    Loop,
+};
+
+static void write(Writer &out, const ExtrusionEntityCollection &collection);
+
+static void write(Writer &out, const ExtrusionEntity &entity)
+{
+    if (auto *collection = dynamic_cast<const ExtrusionEntityCollection*>(&entity)) {
+        out.pod(EntityTag::Collection);
+        write(out, *collection);
+    } else if (auto *path_oriented = dynamic_cast<const ExtrusionPathOriented*>(&entity)) {
+        out.pod(EntityTag::PathOriented);
+        write(out, static_cast<const ExtrusionPath&>(*path_oriented));
+    } else if (auto *path = dynamic_cast<const ExtrusionPath*>(&entity)) {
+        out.pod(EntityTag::Path);
+        write(out, *path);
+    } else if (auto *multipath = dynamic_cast<const ExtrusionMultiPath*>(&entity)) {
+        out.pod(EntityTag::MultiPath);
+        write(out, multipath->paths);
+    } else if (auto *loop = dynamic_cast<const ExtrusionLoop*>(&entity)) {
+        out.pod(EntityTag::Loop);
+        write(out, loop->paths);
+        out.pod(loop->loop_role());
+    } else
+        throw Slic3r::RuntimeError("PrintSnapshot: Unknown extrusion entity type.");
+}
+
+static void write(Writer &out, const ExtrusionEntityCollection &collection)
+{
+    out.pod(uint8_t(collection.no_sort));
+    out.size(collection.entities.size());
+    for (const ExtrusionEntity *entity : collection.entities)
+        write(out, *entity);
+}
+
+static void read(Reader &in, ExtrusionEntityCollection &collection);
+
+static ExtrusionEntity* read_extrusion_entity(Reader &in)
+{
+    switch (in.pod<EntityTag>()) {
+    case EntityTag::Collection: {
+        auto collection = std::make_unique<ExtrusionEntityCollection>();
+        read(in, *collection);
+        return collection.release();
+    }
+    case EntityTag::Path:
+        return new ExtrusionPath(read_extrusion_path(in));
+    case EntityTag::PathOriented: {
+        ExtrusionPath path = read_extrusion_path(in);
+        return new ExtrusionPathOriented(std::move(path.polyline), path.attributes());
+    }
+    case EntityTag::MultiPath: {
+        auto multipath = std::make_unique<ExtrusionMultiPath>();
+        read(in, multipath->paths);
+        return multipath.release();
+    }
+    case EntityTag::Loop: {
+        ExtrusionPaths paths;
+        read(in, paths);
+        return new ExtrusionLoop(std::move(paths), in.pod<ExtrusionLoopRole>());
+    }
+    default:
+        Reader::throw_corrupted();
+    }
+}
+
+static void read(Reader &in, ExtrusionEntityCollection &collection)
+{
+    collection.clear();
+    collection.no_sort = in.pod<uint8_t>() != 0;
+    size_t n = in.size();
+    collection.entities.reserve(n);
+    for (size_t i = 0; i < n; ++ i)
+        collection.entities.emplace_back(read_extrusion_entity(in));
+}
+
+static void write(Writer &out, const IndexRange<uint32_t> &range)
+{
+    out.pod(*range.begin());
+    out.pod(*range.end());
+}
+
+static IndexRange<uint32_t> read_index_range(Reader &in)
+{
+    auto begin = in.pod<uint32_t>();
+    auto end   = in.pod<uint32_t>();
+    if (begin > end)
+        Reader::throw_corrupted();
+    return { begin, end };
+}
+
+static void write(Writer &out, const LayerExtrusionRange &range)
+{
+    out.pod(range.region());
+    write(out, static_cast<const ExtrusionRange&>(range));
+}
+
+static LayerExtrusionRange read_layer_extrusion_range(Reader &in)
+{
+    auto region = in.pod<uint32_t>();
+    return { region, read_index_range(in) };
+}
+
+static void write(Writer &out, const LayerSlice::Links &links)
+{
+    out.size(links.size());
+    for (const LayerSlice::Link &link : links) {
+        out.pod(link.slice_idx);
+        out.pod(link.area);
+    }
+}
+
+static void read(Reader &in, LayerSlice::Links &links)
+{
+    links.resize(in.size());
+    for (LayerSlice::Link &link : links) {
+        link.slice_idx = in.pod<int32_t>();
+        link.area      = in.pod<float>();
+    }
+}
+
+static void write(Writer &out, const LayerSlice &slice)
+{
+    write(out, slice.bbox);
+    write(out, slice.overlaps_above);
+    write(out, slice.overlaps_below);
+    out.size(slice.islands.size());
+    for (const LayerIsland &island : slice.islands) {
+        write(out, island.boundary);
+        write(out, island.perimeters);
+        write(out, island.thin_fills);
+        out.size(island.fills.size());
+        for (const LayerExtrusionRange &fill : island.fills)
+            write(out, fill);
+        write(out, island.fill_expolygons);
+        out.pod(island.fill_region_id);
+    }
+}
+
+static void read(Reader &in, LayerSlice &slice)
+{
+    read(in, slice.bbox);
+    read(in, slice.overlaps_above);
+    read(in, slice.overlaps_below);
+    slice.islands.resize(in.size());
+    for (LayerIsland &island : slice.islands) {
+        read(in, island.boundary);
+        island.perimeters = read_layer_extrusion_range(in);
+        island.thin_fills = read_index_range(in);
+        island.fills.resize(in.size());
+        for (LayerExtrusionRange &fill : island.fills)
+            fill = read_layer_extrusion_range(in);
+        island.fill_expolygons = read_index_range(in);
+        island.fill_region_id  = in.pod<uint32_t>();
+    }
+}
+
+// Fingerprint of the input of slicing a PrintObject, which is not covered by the configuration stored
+// with the snapshot: Geometry of the ModelObject, its painting and its configuration overrides.
+class FingerprintBuilder
+{
+public:
+    void bytes(const void *data, size_t n) { m_md5.process_bytes(data, n); }
+    template<typename T> void pod(const T &value) { this->bytes(&value, sizeof(T)); }
+    template<typename T> void array(const std::vector<T> &v) { this->pod(uint64_t(v.size())); this->bytes(v.data(), v.size() * sizeof(T)); }
+    void transform(const Transform3d &trafo) { this->bytes(trafo.data(), 16 * sizeof(double)); }
+    void config(const DynamicPrintConfig &config) {
+        for (const std::string &key : config.keys()) {
+            std::string value = config.opt_serialize(key);
+            this->array(std::vector<char>(key.begin(), key.end()));
+            this->array(std::vector<char>(value.begin(), value.end()));
+        }
+        this->pod(uint64_t(config.size()));
+    }
+    void facets(const FacetsAnnotation &facets) {
+        std::ostringstream os;
+        {
+            cereal::BinaryOutputArchive ar(os);
+            ar(facets.get_data());
+        }
+        std::string data = os.str();
+        this->array(std::vector<char>(data.begin(), data.end()));
+    }
+
+    Fingerprint finalize() {
+        boost::uuids::detail::md5::digest_type digest;
+        static_assert(sizeof(digest) == std::tuple_size_v<Fingerprint>);
+        m_md5.get_digest(digest);
+        Fingerprint out;
+        memcpy(out.data(), &digest, out.size());
+        return out;
+    }
+
+private:
+    boost::uuids::detail::md5 m_md5;
+};
+
+static Fingerprint print_object_fingerprint(const PrintObject &print_object)
+{
+    const ModelObject  &model_object = *print_object.model_object();
+    FingerprintBuilder  fp;
+    fp.transform(print_object.trafo());
+    fp.config(model_object.config.get());
+    fp.array(model_object.layer_height_profile.get());
+    fp.pod(uint64_t(model_object.layer_config_ranges.size()));
+    for (const auto &[range, config] : model_object.layer_config_ranges) {
+        fp.pod(range.first);
+        fp.pod(range.second);
+        fp.config(config.get());
+    }
+    fp.pod(uint64_t(model_object.volumes.size()));
+    for (const ModelVolume *volume : model_object.volumes) {
+        fp.pod(volume->type());
+        fp.transform(volume->get_matrix());
+        fp.array(volume->mesh().its.vertices);
+        fp.array(volume->mesh().its.indices);
+        fp.config(volume->config.get());
+        fp.facets(volume->supported_facets);
+        fp.facets(volume->seam_facets);
+        fp.facets(volume->mm_segmentation_facets);
+        fp.facets(volume->fuzzy_skin_facets);
+    }
+    return fp.finalize();
+}
+
+} // namespace PrintSnapshotDetail
+
+using namespace PrintSnapshotDetail;
+
+void PrintSnapshot::save_layer_region(Writer &out, const LayerRegion &layerm)
+{
+    write(out, layerm.m_raw_slices);
+    write(out, layerm.m_slices);
+    write(out, layerm.m_fill_expolygons);
+    write(out, layerm.m_fill_expolygons_bboxes);
+    write(out, layerm.m_fill_expolygons_composite);
+    write(out, layerm.m_fill_expolygons_composite_bboxes);
+    write(out, layerm.m_fill_surfaces);
+    write(out, layerm.m_thin_fills);
+    write(out, layerm.m_unsupported_bridge_edges);
+    write(out, layerm.m_perimeters);
+    write(out, layerm.m_fills);
+}
+
+void PrintSnapshot::load_layer_region(Reader &in, LayerRegion &layerm)
+{
+    read(in, layerm.m_raw_slices);
+    read(in, layerm.m_slices);
+    read(in, layerm.m_fill_expolygons);
+    read(in, layerm.m_fill_expolygons_bboxes);
+    read(in, layerm.m_fill_expolygons_composite);
+    read(in, layerm.m_fill_expolygons_composite_bboxes);
+    read(in, layerm.m_fill_surfaces);
+    read(in, layerm.m_thin_fills);
+    read(in, layerm.m_unsupported_bridge_edges);
+    read(in, layerm.m_perimeters);
+    read(in, layerm.m_fills);
+}
+
+void PrintSnapshot::save_layer(Writer &out, const Layer &layer)
+{
+    out.size(layer.id());
+    out.pod(layer.slice_z);
+    out.pod(layer.print_z);
+    out.pod(layer.height);
+    out.array(layer.curled_lines);
+    write(out, layer.lslices);
+    out.size(layer.lslice_indices_sorted_by_print_order.size());
+    for (size_t idx : layer.lslice_indices_sorted_by_print_order)
+        out.size(idx);
+    write(out, layer.lslices_ex);
+    out.size(layer.regions().size());
+    for (const LayerRegion *layerm : layer.regions())
+        save_layer_region(out, *layerm);
+}
+
+void PrintSnapshot::load_layer(Reader &in, Layer &layer)
+{
+    in.array(layer.curled_lines);
+    read(in, layer.lslices);
+    layer.lslice_indices_sorted_by_print_order.resize(in.size());
+    for (size_t &idx : layer.lslice_indices_sorted_by_print_order)
+        idx = in.size();
+    read(in, layer.lslices_ex);
+    if (layer.lslices_ex.size() != layer.lslices.size())
+        Reader::throw_corrupted();
+    layer.invalidate_spatial_index();
+    const PrintObject &print_object = *layer.object();
+    if (size_t num_regions = in.size(); num_regions != print_object.num_printing_regions() && num_regions != 0)
+        Reader::throw_corrupted();
+    else {
+        layer.m_regions.reserve(num_regions);
+        for (size_t region_id = 0; region_id < num_regions; ++ region_id)
+            load_layer_region(in, *layer.add_region(&print_object.printing_region(region_id)));
+    }
+}
+
+void PrintSnapshot::save_print_object(Writer &out, const PrintObject &print_object)
+{
+    Fingerprint fingerprint = print_object_fingerprint(print_object);
+    out.bytes(fingerprint.data(), fingerprint.size());
+    out.pod(uint8_t(print_object.m_typed_slices));
+    out.size(print_object.layers().size());
+    for (const Layer *layer : print_object.layers())
+        save_layer(out, *layer);
+    out.size(print_object.support_layers().size());
+    for (const SupportLayer *layer : print_object.support_layers()) {
+        out.size(layer->interface_id());
+        save_layer(out, *layer);
+        write(out, layer->support_islands);
+        write(out, layer->support_islands_bboxes);
+        write(out, layer->support_fills);
+    }
+}
+
+void PrintSnapshot::load_print_object(Reader &in, PrintObject &print_object)
+{
+    Fingerprint fingerprint;
+    in.bytes(fingerprint.data(), fingerprint.size());
+    if (fingerprint != print_object_fingerprint(print_object))
+        throw Slic3r::RuntimeError("The print snapshot was created for a different model.");
+
+    print_object.clear_layers();
+    print_object.clear_support_layers();
+    print_object.m_typed_slices = in.pod<uint8_t>() != 0;
+
+    size_t num_layers = in.size();
+    print_object.m_layers.reserve(num_layers);
+    for (size_t i = 0; i < num_layers; ++ i) {
+        auto id      = in.size();
+        auto slice_z = in.pod<coordf_t>();
+        auto print_z = in.pod<coordf_t>();
+        auto height  = in.pod<coordf_t>();
+        Layer *layer = print_object.add_layer(int(id), height, print_z, slice_z);
+        load_layer(in, *layer);
+        if (i > 0) {
+            Layer *prev = print_object.m_layers[i - 1];
+            prev->upper_layer  = layer;
+            layer->lower_layer = prev;
+        }
+    }
+
+    size_t num_support_layers = in.size();
+    print_object.m_support_layers.reserve(num_support_layers);
+    for (size_t i = 0; i < num_support_layers; ++ i) {
+        auto interface_id = in.size();
+        auto id           = in.size();
+        auto slice_z      = in.pod<coordf_t>();
+        auto print_z      = in.pod<coordf_t>();
+        auto height       = in.pod<coordf_t>();
+        SupportLayer *layer = *print_object.insert_support_layer(print_object.m_support_layers.end(), id, interface_id, height, print_z, slice_z);
+        load_layer(in, *layer);
+        read(in, layer->support_islands);
+        read(in, layer->support_islands_bboxes);
+        read(in, layer->support_fills);
+    }
+
+    // All the data produced by the PrintObject steps is now valid. The support spots are not stored,
+    // they are only used to alert the user of missing supports, which has already been done when slicing.
+    for (int step = 0; step < int(posCount); ++ step)
+        if (print_object.set_started(PrintObjectStep(step)))
+            print_object.set_done(PrintObjectStep(step));
+}
+
+void PrintSnapshot::save(const Print &print, const std::string &path)
+{
+    boost::nowide::ofstream os(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (! os.is_open())
+        throw Slic3r::FileIOError("Cannot open the print snapshot " + path + " for writing.");
+
+    Writer out(os);
+    out.bytes(SnapshotMagic, sizeof(SnapshotMagic));
+    out.pod(SnapshotVersion);
+    out.pod(uint8_t(sizeof(coord_t)));
+
+    const DynamicPrintConfig &config = print.full_print_config();
+    out.size(config.size());
+    for (const std::string &key : config.keys()) {
+        out.string(key);
+        out.string(config.opt_serialize(key));
+    }
+
+    out.size(print.objects().size());
+    for (const PrintObject *print_object : print.objects())
+        save_print_object(out, *print_object);
+
+    os.close();
+    if (os.fail())
+        throw Slic3r::FileIOError("Failed writing the print snapshot " + path);
+    BOOST_LOG_TRIVIAL(info) << "Print snapshot stored to " << path;
+}
+
+void PrintSnapshot::load(const std::string &path, Print &print, const Model &model, const DynamicPrintConfig &config)
+{
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(boost::filesystem::path(path));
+    } catch (const std::exception &ex) {
+        throw Slic3r::FileIOError("Cannot open the print snapshot " + path + ": " + ex.what());
+    }
+    if (! file.is_open())
+        throw Slic3r::FileIOError("Cannot open the print snapshot " + path);
+
+    Reader in(file.data(), file.data() + file.size());
+    char   magic[sizeof(SnapshotMagic)];
+    in.bytes(magic, sizeof(magic));
+    if (memcmp(magic, SnapshotMagic, sizeof(magic)) != 0)
+        throw Slic3r::RuntimeError(path + " is not a print snapshot.");
+    if (in.pod<uint32_t>() != SnapshotVersion || in.pod<uint8_t>() != sizeof(coord_t))
+        throw Slic3r::RuntimeError("The print snapshot " + path + " was created by an incompatible version of the application.");
+
+    // Apply the configuration the snapshot was created with, so that the PrintObjects and PrintRegions
+    // match the stored layers.
+    DynamicPrintConfig snapshot_config;
+    for (size_t i = in.size(); i > 0; -- i) {
+        std::string key   = in.string();
+        std::string value = in.string();
+        snapshot_config.set_deserialize_strict(key, value);
+    }
+    print.apply(model, snapshot_config);
+
+    if (in.size() != print.objects().size())
+        throw Slic3r::RuntimeError("The print snapshot was created for a different model.");
+    for (size_t i = 0; i < print.objects().size(); ++ i)
+        load_print_object(in, *print.get_object(i));
+
+    // Invalidate the steps influenced by the differences between the stored and the current configuration.
+    print.apply(model, config);
+    BOOST_LOG_TRIVIAL(info) << "Print snapshot loaded from " << path;
+}
+
+} // namespace Slic3r
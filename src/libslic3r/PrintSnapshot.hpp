@@ -0,0 +1,52 @@
+#ifndef slic3r_PrintSnapshot_hpp_
+#define slic3r_PrintSnapshot_hpp_
+
+#include <string>
+
+namespace Slic3r {
+
+class DynamicPrintConfig;
+class Layer;
+class LayerRegion;
+class Model;
+class Print;
+class PrintObject;
+class SupportLayer;
+
+namespace PrintSnapshotDetail {
+    class Writer;
+    class Reader;
+}
+
+// Versioned binary snapshot of the sliced PrintObjects of a Print: their layers, layer regions, support layers
+// and extrusions, together with the configuration the Print was sliced with.
+// A snapshot is stored after Print::process() and loaded into a fresh Print when exporting the G-code again
+// in another process, so that the object steps do not need to be recalculated. The Print level steps
+// (wipe tower, skirt and brim) are fast and they are recalculated.
+class PrintSnapshot
+{
+public:
+    // Store the sliced PrintObjects of a processed Print into a file.
+    // Throws Slic3r::FileIOError if the file could not be written.
+    static void save(const Print &print, const std::string &path);
+
+    // Apply the model to the Print with the configuration stored in the snapshot, restore the PrintObjects
+    // from the snapshot and then apply the model with the current configuration. The steps influenced by
+    // the configuration changes are invalidated by Print::apply() as usual, thus the following
+    // Print::process() only recalculates what the snapshot does not cover.
+    // Throws Slic3r::FileIOError if the file could not be read, Slic3r::RuntimeError if the snapshot
+    // is corrupted, of a different version or it was not created for the same model.
+    static void load(const std::string &path, Print &print, const Model &model, const DynamicPrintConfig &config);
+
+private:
+    static void save_layer_region(PrintSnapshotDetail::Writer &out, const LayerRegion &layerm);
+    static void load_layer_region(PrintSnapshotDetail::Reader &in, LayerRegion &layerm);
+    static void save_layer(PrintSnapshotDetail::Writer &out, const Layer &layer);
+    static void load_layer(PrintSnapshotDetail::Reader &in, Layer &layer);
+    static void save_print_object(PrintSnapshotDetail::Writer &out, const PrintObject &print_object);
+    static void load_print_object(PrintSnapshotDetail::Reader &in, PrintObject &print_object);
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_PrintSnapshot_hpp_
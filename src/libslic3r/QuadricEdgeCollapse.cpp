@@ -6,6 +6,7 @@
 
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <numeric>
 #include <tuple>
 #include <optional>
 #include <algorithm>
@@ -71,6 +72,8 @@ namespace QuadricEdgeCollapse {
     using Indices = std::vector<stl_triangle_vertex_indices>;
     using ThrowOnCancel = std::function<void(void)>;
     using StatusFn = std::function<void(int)>;
+    // Vertices which must not be moved by an edge collapse, empty when none is locked
+    using LockedVertices = std::vector<bool>;
     // smallest error caused by edges, identify smallest edge in triangle
     struct Error
     {
@@ -103,6 +106,8 @@ namespace QuadricEdgeCollapse {
         bool is_deleted() const { return count == 0; }
     };
     using VertexInfos = std::vector<VertexInfo>;
+    // sum quadric for each vertex, empty when it should be calculated from triangles
+    using VertexQuadrics = std::vector<SymMat>;
     struct EdgeInfo {
         uint32_t t_index=0; // triangle index
         unsigned char edge = 0; // 0 or 1 or 2
@@ -132,7 +137,13 @@ namespace QuadricEdgeCollapse {
     double vertex_error(const SymMat &q, const Vec3d &vertex);
     SymMat create_quadric(const Triangle &t, const Vec3d& n, const Vertices &vertices);
     std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    init(const indexed_triangle_set &its, const LockedVertices &locked, const VertexQuadrics &quadrics,
+        ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    // reduce edges while triangle_count or maximal_error is not reached, returns last collapsed error
+    // deleted triangles are only marked in t_infos, compact is not called
+    float collapse_edges(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+        const LockedVertices &locked, const VertexQuadrics &quadrics, ThrowOnCancel &throw_on_cancel,
+        StatusFn &status_fn, TriangleInfos &t_infos, VertexInfos &v_infos, EdgeInfos &e_infos);
     std::optional<uint32_t> find_triangle_index1(uint32_t vi, const VertexInfo& v_info,
         uint32_t ti, const EdgeInfos& e_infos, const Indices& indices);
     void reorder_edges(EdgeInfos &e_infos, const VertexInfo &v_info, uint32_t ti0, uint32_t ti1);
@@ -143,13 +154,25 @@ namespace QuadricEdgeCollapse {
     bool create_no_volume(uint32_t vi0, uint32_t vi1, uint32_t ti0, uint32_t ti1,
         const VertexInfo &v_info0, const VertexInfo &v_info1, const EdgeInfos &e_infos, const Indices &indices);
     // find edge with smallest error in triangle
-    Vec3d calculate_3errors(const Triangle &t, const Vertices &vertices, const VertexInfos &v_infos);
-    Error calculate_error(uint32_t ti, const Triangle& t,const Vertices &vertices, const VertexInfos& v_infos, unsigned char& min_index);
+    Vec3d calculate_3errors(const Triangle &t, const Vertices &vertices, const VertexInfos &v_infos, const LockedVertices &locked);
+    Error calculate_error(uint32_t ti, const Triangle& t,const Vertices &vertices, const VertexInfos& v_infos,
+        const LockedVertices &locked, unsigned char& min_index);
     void remove_triangle(EdgeInfos &e_infos, VertexInfo &v_info, uint32_t ti);
     void change_neighbors(EdgeInfos &e_infos, VertexInfos &v_infos, uint32_t ti0, uint32_t ti1,
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
     void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    // split triangles spatially into partitions of at most triangles_per_partition triangles
+    std::vector<std::vector<uint32_t>> partition_triangles(const indexed_triangle_set &its, size_t triangles_per_partition);
+    VertexQuadrics create_vertex_quadrics(const indexed_triangle_set &its);
+    // collapse edges of all partitions concurrently, returns last collapsed error of each partition
+    std::vector<float> collapse_partitions(indexed_triangle_set &its, VertexQuadrics &quadrics,
+        const std::vector<std::vector<uint32_t>> &partitions, const std::vector<uint32_t> &triangle_counts,
+        float maximal_error, ThrowOnCancel &throw_on_cancel);
+    // collapse edges of one partition, vertices shared with other partitions are locked
+    float collapse_partition(indexed_triangle_set &its, VertexQuadrics &quadrics, const std::vector<uint32_t> &triangles,
+        const std::vector<uint32_t> &vertex_partition, uint32_t triangle_count, float maximal_error,
+        ThrowOnCancel &throw_on_cancel, Indices &result_indices);
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -169,6 +192,16 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // parallel simplification: part of status for partitions, rest is for seams
+    const int status_partitions_size = 70;
+    // multiple of the wanted triangle count reduced inside of partitions
+    const uint32_t partition_triangle_count_ratio = 2;
+    // growth of the error threshold between rounds of reducing partitions
+    const float partition_error_threshold_step = 4.f;
+    // partitions are not reduced anymore when a round reduces less triangles
+    const double partition_min_reduction = 0.1;
+    // vertex_partition value for vertex used by more partitions
+    const uint32_t shared_vertex = std::numeric_limits<uint32_t>::max();
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -187,16 +220,171 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    TriangleInfos t_infos; // only normals with information about deleted triangle
+    VertexInfos   v_infos;
+    EdgeInfos     e_infos;
+    float last_collapsed_error = collapse_edges(its, triangle_count, maximal_error, {}, {},
+        throw_on_cancel, status_fn, t_infos, v_infos, e_infos);
+
+    // compact triangle
+    compact(v_infos, t_infos, e_infos, its);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn,
+    uint32_t                  triangles_per_partition)
+{
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+    triangles_per_partition = std::max(triangles_per_partition, uint32_t(1));
+
+    // Partitions are reduced in rounds, each round collapses only edges with an error under a threshold
+    // common to all partitions, so that the collapses are ordered by error similarly to the sequential
+    // algorithm. The first round halves each partition to find out the scale of the errors.
+    // Each partition is reduced at most to a multiple of its share on the wanted triangle count,
+    // the rest is left for the final pass ordering the collapses of the whole mesh.
+    // Quadrics of vertices are kept between the rounds to accumulate the error as the sequential algorithm does.
+    std::vector<std::vector<uint32_t>> partitions = partition_triangles(its, triangles_per_partition);
+    if (partitions.size() < 2) {
+        its_quadric_edge_collapse(its, triangle_count, max_error, throw_on_cancel, status_fn);
+        return;
+    }
+    VertexQuadrics       quadrics             = create_vertex_quadrics(its);
+    const size_t         original_count       = its.indices.size();
+    float                last_collapsed_error = 0.f;
+    std::optional<float> error_threshold;
+    while (partitions.size() >= 2) {
+        throw_on_cancel();
+
+        std::vector<uint32_t> partition_triangle_counts(partitions.size());
+        for (size_t pi = 0; pi < partitions.size(); ++pi) {
+            size_t count = partitions[pi].size();
+            partition_triangle_counts[pi] = static_cast<uint32_t>(std::min<uint64_t>(count, std::max<uint64_t>(
+                error_threshold.has_value() ? 0 : count / 2,
+                partition_triangle_count_ratio * uint64_t(triangle_count) * count / its.indices.size())));
+        }
+        float threshold = std::min(maximal_error, error_threshold.value_or(maximal_error));
+        std::vector<float> partition_errors = collapse_partitions(its, quadrics, partitions,
+            partition_triangle_counts, threshold, throw_on_cancel);
+
+        size_t count_before = std::accumulate(partitions.begin(), partitions.end(), size_t(0),
+            [](size_t sum, const std::vector<uint32_t> &triangles) { return sum + triangles.size(); });
+        last_collapsed_error = std::max(last_collapsed_error,
+            *std::max_element(partition_errors.begin(), partition_errors.end()));
+        status_fn(static_cast<int>(status_partitions_size * std::min(1., double(original_count - its.indices.size()) /
+            double(original_count - triangle_count))));
+
+        if (! error_threshold.has_value()) {
+            // median of errors reached by halving partitions
+            std::nth_element(partition_errors.begin(), partition_errors.begin() + partition_errors.size() / 2, partition_errors.end());
+            error_threshold = partition_errors[partition_errors.size() / 2];
+        } else if (threshold >= maximal_error ||
+                   count_before - its.indices.size() < count_before * partition_min_reduction)
+            // Edges left are mostly locked on the partition borders.
+            break;
+        else
+            *error_threshold *= partition_error_threshold_step;
+
+        if (its.indices.size() <= partition_triangle_count_ratio * size_t(triangle_count))
+            break;
+        partitions = partition_triangles(its, triangles_per_partition);
+    }
+
+    // collapse edges around the partition borders with all vertices unlocked
+    if (triangle_count < its.indices.size()) {
+        TriangleInfos t_infos;
+        VertexInfos   v_infos;
+        EdgeInfos     e_infos;
+        StatusFn seam_status_fn = [&status_fn](int percent) {
+            status_fn(status_partitions_size + percent * (100 - status_partitions_size) / 100);
+        };
+        float seam_error = collapse_edges(its, triangle_count, maximal_error, {}, quadrics,
+            throw_on_cancel, seam_status_fn, t_infos, v_infos, e_infos);
+        compact(v_infos, t_infos, e_infos, its);
+        last_collapsed_error = std::max(last_collapsed_error, seam_error);
+    }
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+std::vector<float> QuadricEdgeCollapse::collapse_partitions(indexed_triangle_set &                    its,
+                                                            VertexQuadrics &                          quadrics,
+                                                            const std::vector<std::vector<uint32_t>> &partitions,
+                                                            const std::vector<uint32_t> &             triangle_counts,
+                                                            float                                     maximal_error,
+                                                            ThrowOnCancel &                           throw_on_cancel)
+{
+    // identify vertices on borders between partitions
+    const uint32_t no_partition = shared_vertex - 1;
+    std::vector<uint32_t> vertex_partition(its.vertices.size(), no_partition);
+    for (uint32_t pi = 0; pi < partitions.size(); ++pi)
+        for (uint32_t ti : partitions[pi])
+            for (size_t j = 0; j < 3; ++j) {
+                uint32_t &vp = vertex_partition[its.indices[ti][j]];
+                vp = (vp == no_partition || vp == pi) ? pi : shared_vertex;
+            }
+
+    // Partitions do not share any unlocked vertex, so their inner edges are collapsed concurrently.
+    std::vector<Indices> partition_indices(partitions.size());
+    std::vector<float>   partition_errors(partitions.size(), 0.f);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, partitions.size(), 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t pi = range.begin(); pi < range.end(); ++pi)
+            partition_errors[pi] = collapse_partition(its, quadrics, partitions[pi], vertex_partition,
+                triangle_counts[pi], maximal_error, throw_on_cancel, partition_indices[pi]);
+    }); // END parallel for
+    throw_on_cancel();
+
+    its.indices.clear();
+    for (Indices &indices : partition_indices)
+        append(its.indices, std::move(indices));
+
+    // remove vertices of collapsed edges
+    std::vector<uint32_t> vertex_map(its.vertices.size(), std::numeric_limits<uint32_t>::max());
+    for (const Triangle &t : its.indices)
+        for (size_t j = 0; j < 3; ++j)
+            vertex_map[t[j]] = 0;
+    uint32_t vi_new = 0;
+    for (uint32_t vi = 0; vi < its.vertices.size(); ++vi) {
+        if (vertex_map[vi] != 0) continue; // deleted
+        vertex_map[vi]         = vi_new;
+        its.vertices[vi_new]   = its.vertices[vi];
+        quadrics[vi_new++]     = quadrics[vi];
+    }
+    its.vertices.erase(its.vertices.begin() + vi_new, its.vertices.end());
+    quadrics.erase(quadrics.begin() + vi_new, quadrics.end());
+    for (Triangle &t : its.indices)
+        for (size_t j = 0; j < 3; ++j)
+            t[j] = vertex_map[t[j]];
+    return partition_errors;
+}
+
+float QuadricEdgeCollapse::collapse_edges(indexed_triangle_set &its,
+                                          uint32_t              triangle_count,
+                                          float                 maximal_error,
+                                          const LockedVertices &locked,
+                                          const VertexQuadrics &quadrics,
+                                          ThrowOnCancel &       throw_on_cancel,
+                                          StatusFn &            status_fn,
+                                          TriangleInfos &       t_infos,
+                                          VertexInfos &         v_infos,
+                                          EdgeInfos &           e_infos)
+{
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
     };
 
-    TriangleInfos t_infos; // only normals with information about deleted triangle
-    VertexInfos   v_infos;
-    EdgeInfos     e_infos;
-    Errors        errors;
-    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn);
+    Errors errors;
+    std::tie(t_infos, v_infos, e_infos, errors) = init(its, locked, quadrics, throw_on_cancel, init_status_fn);
     throw_on_cancel();
     status_fn(status_init_size);
 
@@ -278,7 +466,7 @@ void Slic3r::its_quadric_edge_collapse(
             is_flipped(new_vertex0, ti0, ti1, v_info0, t_infos, e_infos, its) ||
             is_flipped(new_vertex0, ti0, ti1, v_info1, t_infos, e_infos, its)) {
             // try other triangle's edge
-            Vec3d errors = calculate_3errors(t0, its.vertices, v_infos);
+            Vec3d errors = calculate_3errors(t0, its.vertices, v_infos, locked);
             Vec3i ord = (errors[0] < errors[1]) ? 
                 ((errors[0] < errors[2])? 
                     ((errors[1] < errors[2]) ? Vec3i(0, 1, 2) : Vec3i(0, 2, 1)) :
@@ -342,7 +530,7 @@ void Slic3r::its_quadric_edge_collapse(
             size_t priority_queue_index = ti_2_mpqi[ti];
             TriangleInfo& t_info = t_infos[ti];
             t_info.n = create_normal(its.indices[ti], its.vertices).cast<float>(); // recalc normals
-            mpq[priority_queue_index] = calculate_error(ti, its.indices[ti], its.vertices, v_infos, t_info.min_index);
+            mpq[priority_queue_index] = calculate_error(ti, its.indices[ti], its.vertices, v_infos, locked, t_info.min_index);
             mpq.update(priority_queue_index);
         }
 
@@ -356,10 +544,125 @@ void Slic3r::its_quadric_edge_collapse(
         assert(check_neighbors(its, t_infos, v_infos, e_infos));
 #endif // EXPENSIVE_DEBUG_CHECKS
     }
+    return last_collapsed_error;
+}
 
-    // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
-    if (max_error != nullptr) *max_error = last_collapsed_error;
+VertexQuadrics QuadricEdgeCollapse::create_vertex_quadrics(const indexed_triangle_set &its)
+{
+    std::vector<SymMat> triangle_quadrics(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            triangle_quadrics[i] = create_quadric(t, create_normal(t, its.vertices), its.vertices);
+        }
+    }); // END parallel for
+
+    VertexQuadrics quadrics(its.vertices.size());
+    for (size_t i = 0; i < its.indices.size(); i++)
+        for (size_t e = 0; e < 3; e++)
+            quadrics[its.indices[i][e]] += triangle_quadrics[i];
+    return quadrics;
+}
+
+std::vector<std::vector<uint32_t>> QuadricEdgeCollapse::partition_triangles(
+    const indexed_triangle_set &its, size_t triangles_per_partition)
+{
+    std::vector<Vec3f> centers(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            centers[i] = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+        }
+    }); // END parallel for
+
+    std::vector<uint32_t> order(its.indices.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // split range of triangles by median of centers on the longest axis of their bounding box
+    std::vector<std::vector<uint32_t>> partitions;
+    std::vector<std::pair<size_t, size_t>> ranges{{0, order.size()}};
+    while (!ranges.empty()) {
+        auto [begin, end] = ranges.back();
+        ranges.pop_back();
+        if (end - begin <= triangles_per_partition) {
+            partitions.emplace_back(order.begin() + begin, order.begin() + end);
+            continue;
+        }
+        Vec3f min = centers[order[begin]], max = min;
+        for (size_t i = begin + 1; i < end; ++i) {
+            min = min.cwiseMin(centers[order[i]]);
+            max = max.cwiseMax(centers[order[i]]);
+        }
+        int axis;
+        (max - min).maxCoeff(&axis);
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+            [&centers, axis](uint32_t ti1, uint32_t ti2) { return centers[ti1][axis] < centers[ti2][axis]; });
+        ranges.emplace_back(middle, end);
+        ranges.emplace_back(begin, middle);
+    }
+    return partitions;
+}
+
+float QuadricEdgeCollapse::collapse_partition(indexed_triangle_set &       its,
+                                              VertexQuadrics &             quadrics,
+                                              const std::vector<uint32_t> &triangles,
+                                              const std::vector<uint32_t> &vertex_partition,
+                                              uint32_t                     triangle_count,
+                                              float                        maximal_error,
+                                              ThrowOnCancel &              throw_on_cancel,
+                                              Indices &                    result_indices)
+{
+    // copy partition into its own mesh
+    std::vector<uint32_t> local_to_global;
+    local_to_global.reserve(triangles.size() * 3);
+    for (uint32_t ti : triangles)
+        for (size_t j = 0; j < 3; ++j)
+            local_to_global.emplace_back(its.indices[ti][j]);
+    sort_remove_duplicates(local_to_global);
+
+    indexed_triangle_set part;
+    LockedVertices locked(local_to_global.size());
+    VertexQuadrics part_quadrics;
+    part.vertices.reserve(local_to_global.size());
+    part_quadrics.reserve(local_to_global.size());
+    for (size_t vi = 0; vi < local_to_global.size(); ++vi) {
+        part.vertices.emplace_back(its.vertices[local_to_global[vi]]);
+        part_quadrics.emplace_back(quadrics[local_to_global[vi]]);
+        locked[vi] = vertex_partition[local_to_global[vi]] == shared_vertex;
+    }
+    part.indices.reserve(triangles.size());
+    for (uint32_t ti : triangles) {
+        Triangle t;
+        for (size_t j = 0; j < 3; ++j)
+            t[j] = std::lower_bound(local_to_global.begin(), local_to_global.end(),
+                                    uint32_t(its.indices[ti][j])) - local_to_global.begin();
+        part.indices.emplace_back(t);
+    }
+
+    TriangleInfos t_infos;
+    VertexInfos   v_infos;
+    EdgeInfos     e_infos;
+    StatusFn      status_fn = [](int) {};
+    float last_collapsed_error = collapse_edges(part, triangle_count, maximal_error, locked, part_quadrics,
+        throw_on_cancel, status_fn, t_infos, v_infos, e_infos);
+
+    // Not locked vertices are used only by this partition, write back their new positions and quadrics.
+    for (size_t vi = 0; vi < local_to_global.size(); ++vi)
+        if (!locked[vi] && !v_infos[vi].is_deleted()) {
+            its.vertices[local_to_global[vi]] = part.vertices[vi];
+            quadrics[local_to_global[vi]]     = v_infos[vi].q;
+        }
+
+    result_indices.reserve(triangles.size());
+    for (size_t ti = 0; ti < part.indices.size(); ++ti) {
+        if (t_infos[ti].is_deleted()) continue;
+        const Triangle &t = part.indices[ti];
+        result_indices.emplace_back(local_to_global[t[0]], local_to_global[t[1]], local_to_global[t[2]]);
+    }
+    return last_collapsed_error;
 }
 
 Vec3d QuadricEdgeCollapse::create_normal(const Triangle &triangle,
@@ -454,13 +757,17 @@ SymMat QuadricEdgeCollapse::create_quadric(const Triangle &t,
 }
 
 std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
+QuadricEdgeCollapse::init(const indexed_triangle_set &its,
+                          const LockedVertices &      locked,
+                          const VertexQuadrics &      quadrics,
+                          ThrowOnCancel &             throw_on_cancel,
+                          StatusFn &                  status_fn)
 {
     int status_offset = 0;
     TriangleInfos t_infos(its.indices.size());
     VertexInfos   v_infos(its.vertices.size());
     {
-        std::vector<SymMat> triangle_quadrics(its.indices.size());
+        std::vector<SymMat> triangle_quadrics(quadrics.empty() ? its.indices.size() : 0);
         // calculate normals
         tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
         [&](const tbb::blocked_range<size_t> &range) {
@@ -469,7 +776,8 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
                 TriangleInfo &  t_info = t_infos[i];
                 Vec3d           normal = create_normal(t, its.vertices);
                 t_info.n = normal.cast<float>();
-                triangle_quadrics[i] = create_quadric(t, normal, its.vertices);
+                if (quadrics.empty())
+                    triangle_quadrics[i] = create_quadric(t, normal, its.vertices);
                 if (i % 1000000 == 0) {
                     throw_on_cancel();
                     status_fn(status_offset + (i * status_normal_size) / its.indices.size());
@@ -481,10 +789,10 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
         // sum quadrics
         for (size_t i = 0; i < its.indices.size(); i++) {
             const Triangle &t = its.indices[i];
-            const SymMat &  q = triangle_quadrics[i];
             for (size_t e = 0; e < 3; e++) {
                 VertexInfo &v_info = v_infos[t[e]];
-                v_info.q += q;
+                if (quadrics.empty())
+                    v_info.q += triangle_quadrics[i];
                 ++v_info.count; // triangle count
             }
             if (i % 1000000 == 0) {
@@ -492,6 +800,9 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
                 status_fn(status_offset + (i * status_sum_quadric) / its.indices.size());
             }
         }
+        if (!quadrics.empty())
+            for (size_t i = 0; i < v_infos.size(); i++)
+                v_infos[i].q = quadrics[i];
         status_offset += status_sum_quadric;
     } // remove triangle quadrics
 
@@ -516,7 +827,7 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
         for (size_t i = range.begin(); i < range.end(); ++i) {
             const Triangle &t      = its.indices[i];
             TriangleInfo &  t_info = t_infos[i];
-            errors[i] = calculate_error(i, t, its.vertices, v_infos, t_info.min_index);
+            errors[i] = calculate_error(i, t, its.vertices, v_infos, locked, t_info.min_index);
             if (i % 1000000 == 0) {
                 throw_on_cancel();
                 status_fn(status_offset + (i * status_calc_errors) / its.indices.size());
@@ -714,15 +1025,21 @@ bool QuadricEdgeCollapse::create_no_volume(
     return false;
 }
 
-Vec3d QuadricEdgeCollapse::calculate_3errors(const Triangle &   t,
-                                             const Vertices &   vertices,
-                                             const VertexInfos &v_infos)
+Vec3d QuadricEdgeCollapse::calculate_3errors(const Triangle &      t,
+                                             const Vertices &      vertices,
+                                             const VertexInfos &   v_infos,
+                                             const LockedVertices &locked)
 {
     Vec3d error;
     for (size_t j = 0; j < 3; ++j) {
         size_t   j2  = (j == 2) ? 0 : (j + 1);
         uint32_t vi0 = t[j];
         uint32_t vi1 = t[j2];
+        if (! locked.empty() && (locked[vi0] || locked[vi1])) {
+            // locked edge is never collapsed
+            error[j] = std::numeric_limits<double>::infinity();
+            continue;
+        }
         SymMat   q(v_infos[vi0].q); // copy
         q += v_infos[vi1].q;
         error[j] = calculate_error(vi0, vi1, q, vertices);
@@ -734,9 +1051,10 @@ Error QuadricEdgeCollapse::calculate_error(uint32_t           ti,
                                            const Triangle &   t,
                                            const Vertices &   vertices,
                                            const VertexInfos &v_infos,
+                                           const LockedVertices &locked,
                                            unsigned char &    min_index)
 {
-    Vec3d error = calculate_3errors(t, vertices, v_infos);
+    Vec3d error = calculate_3errors(t, vertices, v_infos, locked);
     // select min error
     min_index = (error[0] < error[1]) ? ((error[0] < error[2]) ? 0 : 2) :
                                         ((error[1] < error[2]) ? 1 : 2);
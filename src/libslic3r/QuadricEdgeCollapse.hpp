@@ -36,6 +36,30 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify big mesh by Quadric metric in parallel.
+/// Mesh is split spatially into partitions, edges inside of partitions are
+/// collapsed concurrently while vertices on borders between partitions are locked.
+/// Final pass of its_quadric_edge_collapse resolves seams between partitions.
+/// Result is similar to its_quadric_edge_collapse, but not the same.
+/// </summary>
+/// <param name="its">IN/OUT triangle mesh to be simplified.</param>
+/// <param name="triangle_count">Wanted triangle count.</param>
+/// <param name="max_error">Maximal Quadric for reduce.
+/// When nullptr then max float is used
+/// Output: Biggest collapsed ErrorValue</param>
+/// <param name="throw_on_cancel">Could stop process of calculation.</param>
+/// <param name="statusfn">Give a feed back to user about progress. Values 1 - 100</param>
+/// <param name="triangles_per_partition">Maximal count of triangles in one partition.
+/// Smaller mesh is simplified by its_quadric_edge_collapse.</param>
+void its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count          = 0,
+    float *                   max_error               = nullptr,
+    std::function<void(void)> throw_on_cancel         = nullptr,
+    std::function<void(int)>  statusfn                = nullptr,
+    uint32_t                  triangles_per_partition = 200000);
+
 } // namespace Slic3r
 #endif // slic3r_quadric_edge_collapse_hpp_
 
@@ -164,6 +164,7 @@ public:
                 SCALING_FACTOR / m_pxdim_scaled.h_mm};
     }
     
+    using RasterBase::draw;
     void draw(const ExPolygon &poly) override { _draw(poly); }
     
     EncodedRaster encode(RasterEncoder encoder) const override
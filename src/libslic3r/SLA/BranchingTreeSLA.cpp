@@ -382,7 +382,16 @@ void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &s
     execution::for_each(
         ex_tbb, size_t(0), nondup_idx.size(),
         [&sm, &heads, &nondup_idx, &builder](size_t i) {
-            if (!builder.ctl().stopcondition())
+            if (builder.ctl().stopcondition())
+                return;
+
+            const std::optional<Head> *cached = sm.pinhead_cache ?
+                sm.pinhead_cache->find(sm.pts[nondup_idx[i]]) : nullptr;
+            if (cached) {
+                heads[i] = *cached;
+                if (heads[i])
+                    heads[i]->id = long(nondup_idx[i]);
+            } else
                 heads[i] = calculate_pinhead_placement(ex_seq, sm, nondup_idx[i]);
         },
         execution::max_concurrency(ex_tbb)
@@ -391,6 +400,10 @@ void create_branching_tree(SupportTreeBuilder &builder, const SupportableMesh &s
     if (builder.ctl().stopcondition())
         return;
 
+    if (sm.pinhead_cache)
+        for (size_t i = 0; i < nondup_idx.size(); ++i)
+            sm.pinhead_cache->insert(sm.pts[nondup_idx[i]], heads[i]);
+
     for (auto &h : heads)
         if (h && h->is_valid()) {
             leafs.emplace_back(h->junction_point().cast<float>(), h->r_back_mm);
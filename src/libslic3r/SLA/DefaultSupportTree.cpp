@@ -12,10 +12,13 @@
 #include <cmath>
 #include <functional>
 #include <iterator>
+#include <map>
+#include <numeric>
 #include <set>
 #include <string>
 #include <cassert>
 #include <cstddef>
+#include <tuple>
 
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/Optimize/Optimizer.hpp"
@@ -37,18 +40,20 @@ using Slic3r::opt::AlgNLoptSubplex;
 using Slic3r::opt::AlgNLoptGenetic;
 
 DefaultSupportTree::DefaultSupportTree(SupportTreeBuilder &   builder,
-                                     const SupportableMesh &sm)
+                                     const SupportableMesh &sm,
+                                     const SupportPoints   &pts)
     : m_sm(sm)
-    , m_support_nmls(sm.pts.size(), 3)
+    , m_pts(pts)
+    , m_support_nmls(pts.size(), 3)
     , m_builder(builder)
-    , m_points(sm.pts.size(), 3)
+    , m_points(pts.size(), 3)
     , m_thr(builder.ctl().cancelfn)
 {
     // Prepare the support points in Eigen/IGL format as well, we will use
     // it mostly in this form.
 
     long i = 0;
-    for (const SupportPoint &sp : m_sm.pts) {
+    for (const SupportPoint &sp : m_pts) {
         m_points.row(i).x() = double(sp.pos.x());
         m_points.row(i).y() = double(sp.pos.y());
         m_points.row(i).z() = double(sp.pos.z());
@@ -57,11 +62,13 @@ DefaultSupportTree::DefaultSupportTree(SupportTreeBuilder &   builder,
 }
 
 bool DefaultSupportTree::execute(SupportTreeBuilder    &builder,
-                                const SupportableMesh &sm)
+                                const SupportableMesh &sm,
+                                const SupportPoints   &pts,
+                                PointIndex            *pillar_index)
 {
-    if(sm.pts.empty()) return false;
+    if(pts.empty()) return false;
 
-    DefaultSupportTree alg(builder, sm);
+    DefaultSupportTree alg(builder, sm, pts);
 
        // Let's define the individual steps of the processing. We can experiment
        // later with the ordering and the dependencies between them.
@@ -166,6 +173,9 @@ bool DefaultSupportTree::execute(SupportTreeBuilder    &builder,
         program[pc]();
     }
 
+    if (pillar_index)
+        *pillar_index = alg.m_pillar_index.guarded_clone();
+
     return pc == ABORT;
 }
 
@@ -399,18 +409,8 @@ void DefaultSupportTree::add_pinheads()
         filtered_indices.emplace_back(a.front());
     }
 
-    // calculate the normals to the triangles for filtered points
-    auto nmls = normals(suptree_ex_policy, m_points, m_sm.emesh,
-                        m_sm.cfg.head_front_radius_mm, m_thr,
-                        filtered_indices);
-
-    // Not all of the support points have to be a valid position for
-    // support creation. The angle may be inappropriate or there may
-    // not be enough space for the pinhead. Filtering is applied for
-    // these reasons.
-
-    auto heads = reserve_vector<Head>(m_sm.pts.size());
-    for (const SupportPoint &sp : m_sm.pts) {
+    auto heads = reserve_vector<Head>(m_pts.size());
+    for (const SupportPoint &sp : m_pts) {
         m_thr();
         heads.emplace_back(
             NaNd,
@@ -422,6 +422,34 @@ void DefaultSupportTree::add_pinheads()
             );
     }
 
+    // The heads placed by the previous build of the same mesh are reused,
+    // only the rest of the points go through the placement below.
+    PtIndices placed_indices = filtered_indices;
+    if (m_sm.pinhead_cache) {
+        placed_indices.clear();
+        for (unsigned fidx : filtered_indices) {
+            if (const std::optional<Head> *cached = m_sm.pinhead_cache->find(m_pts[fidx])) {
+                if (*cached) {
+                    heads[fidx]    = **cached;
+                    heads[fidx].id = fidx;
+                }
+            } else
+                placed_indices.emplace_back(fidx);
+        }
+    }
+
+    // calculate the normals to the triangles for filtered points
+    Eigen::MatrixXd nmls;
+    if (!placed_indices.empty())
+        nmls = normals(suptree_ex_policy, m_points, m_sm.emesh,
+                       m_sm.cfg.head_front_radius_mm, m_thr,
+                       placed_indices);
+
+    // Not all of the support points have to be a valid position for
+    // support creation. The angle may be inappropriate or there may
+    // not be enough space for the pinhead. Filtering is applied for
+    // these reasons.
+
     std::function<void(unsigned, size_t, double)> filterfn;
     filterfn = [this, &nmls, &heads, &filterfn](unsigned fidx, size_t i, double back_r) {
         m_thr();
@@ -456,7 +484,7 @@ void DefaultSupportTree::add_pinheads()
         double w = lmin + 2 * back_r + 2 * m_sm.cfg.head_front_radius_mm -
                    m_sm.cfg.head_penetration_mm;
 
-        double pin_r = double(m_sm.pts[fidx].head_front_radius);
+        double pin_r = double(m_pts[fidx].head_front_radius);
 
         // Reassemble the now corrected normal
         auto nn = spheric_to_dir(polar, azimuth).normalized();
@@ -510,12 +538,17 @@ void DefaultSupportTree::add_pinheads()
     };
 
     execution::for_each(
-        suptree_ex_policy, size_t(0), filtered_indices.size(),
-        [this, &filterfn, &filtered_indices](size_t i) {
-            filterfn(filtered_indices[i], i, m_sm.cfg.head_back_radius_mm);
+        suptree_ex_policy, size_t(0), placed_indices.size(),
+        [this, &filterfn, &placed_indices](size_t i) {
+            filterfn(placed_indices[i], i, m_sm.cfg.head_back_radius_mm);
         },
         execution::max_concurrency(suptree_ex_policy));
 
+    if (m_sm.pinhead_cache)
+        for (unsigned fidx : filtered_indices)
+            m_sm.pinhead_cache->insert(m_pts[fidx],
+                                       heads[fidx].is_valid() ? std::optional<Head>{heads[fidx]} : std::nullopt);
+
     for (size_t i = 0; i < heads.size(); ++i)
         if (heads[i].is_valid()) {
             m_builder.add_head(i, heads[i]);
@@ -1002,4 +1035,205 @@ void DefaultSupportTree::interconnect_pillars()
     }
 }
 
+namespace {
+
+bool support_point_less(const SupportPoint &a, const SupportPoint &b)
+{
+    return std::make_tuple(a.pos.x(), a.pos.y(), a.pos.z(), a.head_front_radius) <
+           std::make_tuple(b.pos.x(), b.pos.y(), b.pos.z(), b.head_front_radius);
+}
+
+bool same_support_points(const SupportPoints &a, const SupportPoints &b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                      [](const SupportPoint &p, const SupportPoint &q) {
+                          return p.pos == q.pos &&
+                                 p.head_front_radius == q.head_front_radius;
+                      });
+}
+
+// Indices of the support points of the individual subtrees: the connected
+// components of the points closer to each other than the separation
+// distance in the XY plane. The points of a subtree are sorted by position
+// and the subtrees by their first point, so the result does not depend on
+// the order of the input points.
+std::vector<std::vector<unsigned>> partition_subtrees(const SupportPoints &pts,
+                                                      double separation)
+{
+    std::vector<unsigned> parent(pts.size());
+    std::iota(parent.begin(), parent.end(), 0u);
+
+    auto find = [&parent](unsigned i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    // Only the points in the neighboring cells of a grid with the cell size
+    // of the separation distance can be closer to each other than that.
+    using Cell = std::pair<long, long>;
+    auto cell_of = [separation](const SupportPoint &sp) {
+        return Cell{long(std::floor(sp.pos.x() / separation)),
+                    long(std::floor(sp.pos.y() / separation))};
+    };
+
+    std::map<Cell, std::vector<unsigned>> cells;
+    for (unsigned i = 0; i < pts.size(); ++i)
+        cells[cell_of(pts[i])].emplace_back(i);
+
+    double sep2 = separation * separation;
+    for (const auto &[cell, indices] : cells)
+        for (long dx = -1; dx <= 1; ++dx)
+            for (long dy = -1; dy <= 1; ++dy) {
+                auto it = cells.find({cell.first + dx, cell.second + dy});
+                if (it == cells.end())
+                    continue;
+
+                for (unsigned i : indices)
+                    for (unsigned j : it->second) {
+                        unsigned ri = find(i), rj = find(j);
+                        if (ri == rj)
+                            continue;
+
+                        Vec2d d = (pts[i].pos - pts[j].pos).head<2>().cast<double>();
+                        if (d.squaredNorm() < sep2)
+                            parent[std::max(ri, rj)] = std::min(ri, rj);
+                    }
+            }
+
+    std::map<unsigned, std::vector<unsigned>> components;
+    for (unsigned i = 0; i < pts.size(); ++i)
+        components[find(i)].emplace_back(i);
+
+    auto less = [&pts](unsigned i, unsigned j) {
+        return support_point_less(pts[i], pts[j]) ||
+               (!support_point_less(pts[j], pts[i]) && i < j);
+    };
+
+    std::vector<std::vector<unsigned>> ret;
+    ret.reserve(components.size());
+    for (auto &[root, indices] : components) {
+        std::sort(indices.begin(), indices.end(), less);
+        ret.emplace_back(std::move(indices));
+    }
+
+    std::sort(ret.begin(), ret.end(), [&less](const auto &a, const auto &b) {
+        return less(a.front(), b.front());
+    });
+
+    return ret;
+}
+
+} // namespace
+
+double SupportSubtreeCache::separation_distance(const SupportTreeConfig &cfg)
+{
+    // The reach of the structure grown from a single point: the head, a
+    // bridge to a pillar or a ground route, an additional pillar placed next
+    // to a lonely one and the base of that pillar.
+    double reach = cfg.head_fullwidth() + cfg.max_bridge_length_mm +
+                   3 * cfg.base_radius_mm + cfg.pillar_base_safety_distance_mm;
+
+    // Two structures may get connected if they come within a bridge or a
+    // pillar link of each other.
+    return 2 * reach + std::max(cfg.max_bridge_length_mm,
+                                cfg.max_pillar_link_distance_mm);
+}
+
+void SupportSubtreeCache::build(SupportTreeBuilder &builder, const SupportableMesh &sm)
+{
+    const SupportTreeConfig &cfg = sm.cfg;
+
+    std::vector<double> fingerprint = {
+        double(cfg.tree_type),
+        cfg.head_front_radius_mm,
+        cfg.head_penetration_mm,
+        cfg.head_back_radius_mm,
+        cfg.head_fallback_radius_mm,
+        cfg.head_width_mm,
+        double(cfg.pillar_connection_mode),
+        double(cfg.ground_facing_only),
+        cfg.pillar_widening_factor,
+        cfg.base_radius_mm,
+        cfg.base_height_mm,
+        cfg.bridge_slope,
+        cfg.max_bridge_length_mm,
+        cfg.max_pillar_link_distance_mm,
+        cfg.pillar_base_safety_distance_mm,
+        double(cfg.max_bridges_on_pillar),
+        cfg.max_weight_on_model_support,
+        sm.pad_cfg.wall_thickness_mm,
+        ground_level(sm)
+    };
+
+    std::vector<std::shared_ptr<const Subtree>> cached;
+    if (fingerprint == m_fingerprint)
+        cached = m_subtrees;
+
+    std::vector<std::vector<unsigned>> parts =
+        partition_subtrees(sm.pts, separation_distance(cfg));
+
+    std::vector<std::shared_ptr<const Subtree>> subtrees(parts.size());
+    std::vector<std::pair<size_t, std::shared_ptr<Subtree>>> to_build;
+
+    for (size_t i = 0; i < parts.size(); ++i) {
+        auto st = std::make_shared<Subtree>();
+        st->pts = reserve_vector<SupportPoint>(parts[i].size());
+        for (unsigned idx : parts[i])
+            st->pts.emplace_back(sm.pts[idx]);
+
+        auto it = std::find_if(cached.begin(), cached.end(), [&st](const auto &c) {
+            return same_support_points(c->pts, st->pts);
+        });
+
+        if (it != cached.end()) {
+            subtrees[i] = *it;
+            if (sm.pinhead_cache)
+                for (const SupportPoint &sp : st->pts)
+                    sm.pinhead_cache->keep(sp);
+        } else {
+            to_build.emplace_back(i, std::move(st));
+        }
+    }
+
+    const JobController &ctl = builder.ctl();
+    for (size_t n = 0; n < to_build.size(); ++n) {
+        if (ctl.stopcondition())
+            return;
+
+        // The progress of a subtree is scaled to its share of the build.
+        JobController subctl = ctl;
+        subctl.statuscb = [&ctl, n, cnt = to_build.size()](unsigned st, const std::string &msg) {
+            ctl.statuscb(unsigned((n * 100 + st) / cnt), msg);
+        };
+
+        auto &[i, st] = to_build[n];
+        SupportTreeBuilder tree{subctl};
+        bool aborted = DefaultSupportTree::execute(tree, sm, st->pts, &st->pillar_index);
+        if (aborted || ctl.stopcondition())
+            return;
+
+        // The job controller of the build is not kept with the cached tree.
+        st->tree    = std::move(tree);
+        subtrees[i] = std::move(st);
+    }
+
+    for (size_t i = 0; i < parts.size(); ++i)
+        builder.append(subtrees[i]->tree, parts[i]);
+
+    m_fingerprint = std::move(fingerprint);
+    m_subtrees    = std::move(subtrees);
+    m_built_count = to_build.size();
+}
+
+void create_default_tree(SupportTreeBuilder &builder, const SupportableMesh &sm)
+{
+    if (sm.subtree_cache) {
+        sm.subtree_cache->build(builder, sm);
+    } else {
+        SupportSubtreeCache cache;
+        cache.build(builder, sm);
+    }
+}
+
 }} // namespace Slic3r::sla
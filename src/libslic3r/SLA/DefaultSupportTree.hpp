@@ -10,6 +10,7 @@
 #include <Eigen/Geometry>
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <utility>
@@ -75,6 +76,10 @@ public:
 class DefaultSupportTree {
     const SupportableMesh &m_sm;
 
+    // The support points to build the tree for, not necessarily all the
+    // points of m_sm, see SupportSubtreeCache.
+    const SupportPoints &m_pts;
+
     using PtIndices = std::vector<unsigned>;
 
     PtIndices m_iheads;            // support points with pinhead
@@ -210,7 +215,9 @@ class DefaultSupportTree {
     }
 
 public:
-    DefaultSupportTree(SupportTreeBuilder & builder, const SupportableMesh &sm);
+    DefaultSupportTree(SupportTreeBuilder    &builder,
+                       const SupportableMesh &sm,
+                       const SupportPoints   &pts);
 
     // Now let's define the individual steps of the support generation algorithm
 
@@ -249,13 +256,66 @@ public:
 
     inline void merge_result() { m_builder.merged_mesh(); }
 
-    static bool execute(SupportTreeBuilder & builder, const SupportableMesh &sm);
+    // Build the tree of the given support points. The pillar index of the
+    // finished tree is copied to pillar_index if it is not null.
+    static bool execute(SupportTreeBuilder    &builder,
+                        const SupportableMesh &sm,
+                        const SupportPoints   &pts,
+                        PointIndex            *pillar_index = nullptr);
+
+    static bool execute(SupportTreeBuilder & builder, const SupportableMesh &sm)
+    {
+        return execute(builder, sm, sm.pts);
+    }
+};
+
+// The default support tree of a mesh is built as a set of subtrees. The
+// support points of a subtree are farther from the points of every other
+// subtree in the XY plane than the structure grown from the points can
+// reach (bridges, ground routes, pillar bases and pillar links), so the
+// subtrees are independent of each other.
+//
+// The cache keeps the element graph and the pillar index of every subtree
+// of the last build of a SupportableMesh. When the user edits some support
+// points, only the subtrees of which the point set changed are built again,
+// the rest is taken from the cache. The result is the same as if all the
+// subtrees were built from scratch.
+//
+// The cache belongs to a single mesh, it has to be thrown away with it.
+class SupportSubtreeCache {
+public:
+    struct Subtree {
+        // Sorted by position, the heads of the tree use these indices.
+        SupportPoints      pts;
+        SupportTreeBuilder tree;
+        PointIndex         pillar_index;
+    };
+
+    // Build the tree of the support points of sm into the empty builder.
+    // The cache is left untouched if the build is canceled.
+    void build(SupportTreeBuilder &builder, const SupportableMesh &sm);
+
+    const std::vector<std::shared_ptr<const Subtree>> &subtrees() const
+    {
+        return m_subtrees;
+    }
+
+    // Number of the subtrees built by the last build, the rest was reused.
+    size_t built_count() const { return m_built_count; }
+
+    // Support points closer to each other in the XY plane than this distance
+    // belong to the same subtree.
+    static double separation_distance(const SupportTreeConfig &cfg);
+
+private:
+    std::vector<double>                         m_fingerprint;
+    std::vector<std::shared_ptr<const Subtree>> m_subtrees;
+    size_t                                      m_built_count = 0;
 };
 
-inline void create_default_tree(SupportTreeBuilder &builder, const SupportableMesh &sm)
-{
-    DefaultSupportTree::execute(builder, sm);
-}
+// Uses the subtree cache of sm if there is one, otherwise all the subtrees
+// are built.
+void create_default_tree(SupportTreeBuilder &builder, const SupportableMesh &sm);
 
 }} // namespace Slic3r::sla
 
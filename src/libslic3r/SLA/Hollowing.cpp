@@ -14,12 +14,25 @@
 #include <libslic3r/MeshBoolean.hpp>
 #include <boost/log/trivial.hpp>
 #include <libslic3r/I18N.hpp>
+#include <tbb/task_arena.h>
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
 #include <functional>
 #include <numeric>
+#include <unordered_map>
 #include <unordered_set>
 #include <random>
 #include <cmath>
 #include <mutex>
+#include <atomic>
 #include <string>
 #include <cassert>
 #include <cinttypes>
@@ -45,6 +58,9 @@ struct Interior {
     double thickness = 0.;
     double full_narrowb = 2.;
 
+    // Peak memory of the grids alive at the same time while generating.
+    size_t peak_grid_memory = 0;
+
     void reset_accessor() const  // This resets the accessor and its cache
     // Not a thread safe call!
     {
@@ -78,9 +94,53 @@ VoxelGrid &get_grid(Interior &interior)
     return *interior.gridptr;
 }
 
-InteriorPtr generate_interior(const VoxelGrid       &vgrid,
-                              const HollowingConfig &hc,
-                              const JobController   &ctl)
+size_t get_peak_grid_memory(const Interior &interior)
+{
+    return interior.peak_grid_memory;
+}
+
+// The level set of the interior and the parameters needed to mesh it.
+struct InteriorGrid {
+    VoxelGridPtr gridptr;
+    double iso_surface  = 0.;
+    double full_narrowb = 2.;
+};
+
+// Sums up the memory of the grids alive at the same time and records the
+// peak of the sum. Safe to use from multiple threads.
+class GridMemoryTracker {
+    std::atomic<size_t> m_live{0};
+    std::atomic<size_t> m_peak{0};
+
+public:
+    void add(const VoxelGrid &grid)
+    {
+        size_t live = m_live += grid_memory_usage(grid);
+        size_t peak = m_peak.load();
+        while (peak < live && !m_peak.compare_exchange_weak(peak, live));
+    }
+
+    void remove(const VoxelGrid &grid) { m_live -= grid_memory_usage(grid); }
+
+    // Replace the tracked grid in dst with src, which may be empty.
+    void replace(VoxelGridPtr &dst, VoxelGridPtr src)
+    {
+        if (src) add(*src);
+        if (dst) remove(*dst);
+        dst = std::move(src);
+    }
+
+    size_t peak() const { return m_peak.load(); }
+};
+
+// Offset the level set of the model inwards by the wall thickness and close
+// the result by the closing distance. The statusfn is called with the
+// progress in percents, returning true stops the calculation and an empty
+// grid is returned.
+static InteriorGrid offset_grid(const VoxelGrid                &vgrid,
+                                const HollowingConfig          &hc,
+                                GridMemoryTracker              &mem,
+                                const std::function<bool(int)> &statusfn)
 {
     double voxsc    = get_voxel_scale(vgrid);
     double offset   = hc.min_thickness;              // world units
@@ -89,19 +149,18 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
     float  out_range = 1.f / voxsc; // world units
     auto   narrowb  = 1.f;  // voxel units (voxel count)
 
-    if (ctl.stopcondition()) return {};
-    else ctl.statuscb(0, _u8L("Hollowing"));
+    if (statusfn(0)) return {};
 
-    auto gridptr = dilate_grid(vgrid, out_range, in_range);
+    VoxelGridPtr gridptr;
+    mem.replace(gridptr, dilate_grid(vgrid, out_range, in_range));
 
-    if (ctl.stopcondition()) return {};
-    else ctl.statuscb(30, _u8L("Hollowing"));
+    if (statusfn(30)) return {};
 
     double iso_surface = D;
     if (D > EPSILON) {
-        gridptr = redistance_grid(*gridptr, -(offset + D), narrowb, narrowb);
+        mem.replace(gridptr, redistance_grid(*gridptr, -(offset + D), narrowb, narrowb));
 
-        gridptr = dilate_grid(*gridptr, 1.1 * std::ceil(iso_surface), 0.f);
+        mem.replace(gridptr, dilate_grid(*gridptr, 1.1 * std::ceil(iso_surface), 0.f));
 
         out_range = iso_surface;
         in_range  = narrowb / voxsc;
@@ -109,21 +168,343 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
         iso_surface = -offset;
     }
 
-    if (ctl.stopcondition()) return {};
-    else ctl.statuscb(70, _u8L("Hollowing"));
+    if (statusfn(70)) return {};
+
+    InteriorGrid ret;
+    ret.gridptr      = std::move(gridptr);
+    ret.iso_surface  = iso_surface;
+    ret.full_narrowb = (out_range + in_range) / 2.;
+
+    return ret;
+}
+
+InteriorPtr generate_interior(const VoxelGrid       &vgrid,
+                              const HollowingConfig &hc,
+                              const JobController   &ctl)
+{
+    GridMemoryTracker mem;
+    mem.add(vgrid);
+
+    InteriorGrid igrid = offset_grid(vgrid, hc, mem, [&ctl](int st) {
+        if (ctl.stopcondition())
+            return true;
+
+        ctl.statuscb(unsigned(st), _u8L("Hollowing"));
+        return false;
+    });
+
+    if (!igrid.gridptr) return {};
 
     double adaptivity = 0.;
     InteriorPtr interior = InteriorPtr{new Interior{}};
 
-    interior->mesh = grid_to_mesh(*gridptr, iso_surface, adaptivity);
-    interior->gridptr = std::move(gridptr);
+    interior->mesh = grid_to_mesh(*igrid.gridptr, igrid.iso_surface, adaptivity);
+    interior->gridptr = std::move(igrid.gridptr);
+
+    if (ctl.stopcondition()) return {};
+    else ctl.statuscb(100, _u8L("Hollowing"));
+
+    interior->iso_surface  = igrid.iso_surface;
+    interior->thickness    = hc.min_thickness;
+    interior->full_narrowb = igrid.full_narrowb;
+    interior->peak_grid_memory = mem.peak();
+
+    return interior;
+}
+
+// Width of the band around each tile in voxels, which is added to the
+// distance the wall offset and the closing can reach from the model surface.
+static constexpr double TileMarginVoxels = 4.;
+
+// Cut the mesh to the box. The cuts are closed by caps, so the result still
+// bounds a volume and can be voxelized.
+static indexed_triangle_set cut_to_box(const indexed_triangle_set &its,
+                                       const BoundingBoxf3        &box)
+{
+    indexed_triangle_set ret = its;
+
+    // cut_mesh only cuts by horizontal planes. Rotating the coordinates
+    // cyclically brings each axis to Z in turn and the mesh back to its
+    // original orientation after the third turn.
+    for (int axis = 0; axis < 3; ++axis) {
+        for (Vec3f &v : ret.vertices)
+            v = Vec3f{v.y(), v.z(), v.x()};
+
+        if (ret.empty())
+            continue;
+
+        BoundingBoxf3 bb = bounding_box(ret);
+        auto lo = float(box.min(axis)), hi = float(box.max(axis));
+
+        if (bb.max.z() > hi) {
+            indexed_triangle_set lower;
+            cut_mesh(ret, hi, nullptr, &lower);
+            ret = std::move(lower);
+        }
+
+        if (bb.min.z() < lo) {
+            indexed_triangle_set upper;
+            cut_mesh(ret, lo, &upper, nullptr);
+            ret = std::move(upper);
+        }
+    }
+
+    its_compactify_vertices(ret);
+
+    return ret;
+}
+
+static bool has_triangles_in(const indexed_triangle_set &its,
+                             const BoundingBoxf3        &box)
+{
+    return std::any_of(its.indices.begin(), its.indices.end(),
+                       [&its, &box](const Vec3i &face) {
+                           BoundingBoxf3 facebb;
+                           for (int i = 0; i < 3; ++i)
+                               facebb.merge(its.vertices[face(i)].cast<double>());
+
+                           return facebb.intersects(box);
+                       });
+}
+
+// Generate the part of the interior mesh inside the core box of one tile.
+// The model is cut to the core enlarged by the margin, which is wider than
+// the distance at which the surface of the model influences the interior,
+// so within the core the level set is the same as if the whole model was
+// offset at once.
+static indexed_triangle_set generate_tile_interior(
+    const std::vector<csg::CSGPart>  &csgparts,
+    const std::vector<BoundingBoxf3> &part_bbs,
+    const BoundingBoxf3              &core,
+    double                            margin,
+    double                            voxsc,
+    const HollowingConfig            &hc,
+    GridMemoryTracker                &mem,
+    const std::function<bool(int)>   &stopfn)
+{
+    BoundingBoxf3 box{core.min - Vec3d::Constant(margin),
+                      core.max + Vec3d::Constant(margin)};
+
+    // Without any surface nearby, the tile is either completely outside of
+    // the model or completely inside of the interior.
+    bool has_surface = false;
+    for (size_t i = 0; i < csgparts.size() && !has_surface; ++i) {
+        const indexed_triangle_set *its = csg::get_mesh(csgparts[i]);
+        has_surface = its && part_bbs[i].intersects(box) &&
+                      has_triangles_in(*its, box);
+    }
+
+    if (!has_surface || stopfn(0))
+        return {};
+
+    std::vector<csg::CSGPart> tile_parts;
+    tile_parts.reserve(csgparts.size());
+    for (size_t i = 0; i < csgparts.size(); ++i) {
+        const indexed_triangle_set *its = csg::get_mesh(csgparts[i]);
+
+        // Parts outside of the box are kept empty, so that intersections
+        // with them still remove everything.
+        std::unique_ptr<indexed_triangle_set> cut;
+        if (its)
+            cut = std::make_unique<indexed_triangle_set>(
+                part_bbs[i].intersects(box) ? cut_to_box(*its, box) :
+                                              indexed_triangle_set{});
+
+        auto &part = tile_parts.emplace_back(std::move(cut),
+                                             csg::get_operation(csgparts[i]));
+        part.stack_operation = csg::get_stack_operation(csgparts[i]);
+    }
+
+    auto params = csg::VoxelizeParams{}
+                      .voxel_scale(voxsc)
+                      .exterior_bandwidth(3.f)
+                      .interior_bandwidth(3.f)
+                      .statusfn(stopfn);
+
+    VoxelGridPtr grid = csg::voxelize_csgmesh(range(tile_parts), params);
+    tile_parts.clear();
+
+    if (!grid || is_grid_empty(*grid) || stopfn(0))
+        return {};
+
+    VoxelGridPtr tile_grid;
+    mem.replace(tile_grid, redistance_grid(*grid, IsoAtZero,
+                                           params.exterior_bandwidth(),
+                                           params.interior_bandwidth()));
+    grid.reset();
+
+    InteriorGrid igrid = offset_grid(*tile_grid, hc, mem, stopfn);
+    mem.replace(tile_grid, {});
+
+    if (!igrid.gridptr)
+        return {};
+
+    indexed_triangle_set ret = grid_to_mesh(*igrid.gridptr, igrid.iso_surface, 0.);
+    mem.replace(igrid.gridptr, {});
+
+    auto it = std::remove_if(ret.indices.begin(), ret.indices.end(),
+                             [&ret, &core](const Vec3i &face) {
+                                 Vec3d c = (ret.vertices[face(0)] +
+                                            ret.vertices[face(1)] +
+                                            ret.vertices[face(2)]).cast<double>() / 3.;
+
+                                 return (c.array() < core.min.array()).any() ||
+                                        (c.array() >= core.max.array()).any();
+                             });
+
+    ret.indices.erase(it, ret.indices.end());
+    its_compactify_vertices(ret);
+
+    return ret;
+}
+
+// The tiles mesh the vertices on their common boundaries independently, so
+// these only match up to the numerical error of the level set operations.
+// Each vertex is merged with the closest vertex of another tile within eps.
+static void stitch_tiles(indexed_triangle_set      &its,
+                         const std::vector<size_t> &vertex_tile,
+                         float                      eps)
+{
+    // Collisions of the keys only add candidates checked by the distance.
+    auto cell_key = [](int64_t x, int64_t y, int64_t z) {
+        constexpr int64_t Mask = 0x1FFFFF;
+        return uint64_t(x & Mask) | (uint64_t(y & Mask) << 21) |
+               (uint64_t(z & Mask) << 42);
+    };
+
+    std::unordered_multimap<uint64_t, int> cells;
+    std::vector<int> vertex_map(its.vertices.size());
+
+    for (int i = 0; i < int(its.vertices.size()); ++i) {
+        const Vec3f &p = its.vertices[i];
+        Vec3i64 c{int64_t(std::floor(p.x() / eps)),
+                  int64_t(std::floor(p.y() / eps)),
+                  int64_t(std::floor(p.z() / eps))};
+
+        int   closest = -1;
+        float closest_dist = eps * eps;
+        for (int64_t dx = -1; dx <= 1; ++dx)
+            for (int64_t dy = -1; dy <= 1; ++dy)
+                for (int64_t dz = -1; dz <= 1; ++dz) {
+                    auto [from, to] = cells.equal_range(cell_key(c.x() + dx, c.y() + dy, c.z() + dz));
+                    for (auto it = from; it != to; ++it) {
+                        int   j    = it->second;
+                        float dist = (its.vertices[j] - p).squaredNorm();
+                        if (vertex_tile[j] != vertex_tile[i] && dist < closest_dist) {
+                            closest      = j;
+                            closest_dist = dist;
+                        }
+                    }
+                }
+
+        if (closest >= 0) {
+            vertex_map[i] = closest;
+        } else {
+            vertex_map[i] = i;
+            cells.emplace(cell_key(c.x(), c.y(), c.z()), i);
+        }
+    }
+
+    for (Vec3i &face : its.indices)
+        for (int k = 0; k < 3; ++k)
+            face(k) = vertex_map[face(k)];
+
+    its_remove_degenerate_faces(its);
+    its_compactify_vertices(its);
+}
+
+InteriorPtr generate_interior_tiled(const std::vector<csg::CSGPart> &csgparts,
+                                    const HollowingConfig           &hc,
+                                    const JobController             &ctl)
+{
+    double voxsc  = get_voxel_scale(csgmesh_positive_maxvolume(csgparts), hc);
+    double margin = 1.1 * (hc.min_thickness + hc.closing_distance) +
+                    hc.closing_distance + TileMarginVoxels / voxsc;
+
+    BoundingBoxf3 bb;
+    std::vector<BoundingBoxf3> part_bbs;
+    part_bbs.reserve(csgparts.size());
+    for (const csg::CSGPart &part : csgparts) {
+        const indexed_triangle_set *its = csg::get_mesh(part);
+        part_bbs.emplace_back(its ? bounding_box(*its) : BoundingBoxf3{});
+        if (part_bbs.back().defined)
+            bb.merge(part_bbs.back());
+    }
+
+    if (!bb.defined)
+        return {};
+
+    // The tile boundaries lie in the middle between the voxel centers, which
+    // are at the integer multiples of the voxel size.
+    double tile   = std::max(1., std::round(hc.tile_size * voxsc)) / voxsc;
+    Vec3d  origin = ((bb.min * voxsc).array().floor() - 0.5).matrix() / voxsc;
+    Vec3i  counts;
+    for (int i = 0; i < 3; ++i)
+        counts(i) = std::max(1, int(std::ceil((bb.max(i) - origin(i)) / tile)));
+
+    std::vector<BoundingBoxf3> tiles;
+    tiles.reserve(size_t(counts.x()) * counts.y() * counts.z());
+    for (int z = 0; z < counts.z(); ++z)
+        for (int y = 0; y < counts.y(); ++y)
+            for (int x = 0; x < counts.x(); ++x) {
+                Vec3d min = origin + tile * Vec3d{double(x), double(y), double(z)};
+                tiles.emplace_back(min, min + Vec3d::Constant(tile));
+            }
+
+    BOOST_LOG_TRIVIAL(debug) << "Hollowing: interior is generated in " << tiles.size() << " tiles";
+
+    if (ctl.stopcondition()) return {};
+    else ctl.statuscb(0, _u8L("Hollowing"));
+
+    struct TileMesh { size_t tile_idx = 0; indexed_triangle_set its; };
+
+    GridMemoryTracker    mem;
+    indexed_triangle_set mesh;
+    std::vector<size_t>  vertex_tile;
+    size_t               next_tile  = 0;
+    size_t               tiles_done = 0;
+
+    auto stopfn = [&ctl](int) { return ctl.stopcondition(); };
+
+    // The number of tokens bounds the tiles in flight, thus the number of
+    // tile grids allocated at the same time.
+    tbb::parallel_pipeline(std::max(size_t(1), hc.max_parallel_tiles),
+        tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+            [&next_tile, &tiles, &ctl](tbb::flow_control &fc) -> size_t {
+                if (next_tile == tiles.size() || ctl.stopcondition()) {
+                    fc.stop();
+                    return 0;
+                }
+                return next_tile++;
+            }) &
+        tbb::make_filter<size_t, TileMesh>(slic3r_tbb_filtermode::parallel,
+            [&](size_t tile_idx) {
+                return TileMesh{tile_idx,
+                                generate_tile_interior(csgparts, part_bbs,
+                                                       tiles[tile_idx], margin,
+                                                       voxsc, hc, mem, stopfn)};
+            }) &
+        tbb::make_filter<TileMesh, void>(slic3r_tbb_filtermode::serial_in_order,
+            [&](TileMesh tm) {
+                vertex_tile.insert(vertex_tile.end(), tm.its.vertices.size(), tm.tile_idx);
+                its_merge(mesh, std::move(tm.its));
+                ctl.statuscb(unsigned(90 * ++tiles_done / tiles.size()), _u8L("Hollowing"));
+            }));
+
+    if (ctl.stopcondition() || mesh.empty())
+        return {};
+
+    stitch_tiles(mesh, vertex_tile, float(0.1 / voxsc));
 
     if (ctl.stopcondition()) return {};
     else ctl.statuscb(100, _u8L("Hollowing"));
 
-    interior->iso_surface = iso_surface;
-    interior->thickness   = offset;
-    interior->full_narrowb = (out_range + in_range) / 2.;
+    // The grid of the whole interior is never built, distance queries to the
+    // interior are not available.
+    InteriorPtr interior = InteriorPtr{new Interior{}};
+    interior->mesh             = std::move(mesh);
+    interior->thickness        = hc.min_thickness;
+    interior->peak_grid_memory = mem.peak();
 
     return interior;
 }
@@ -770,7 +1151,8 @@ double get_voxel_scale(double mesh_volume, const HollowingConfig &hc)
     // The minimum can be lowered if the wall thickness is great enough and
     // the maximum is lowered if the model volume very big.
 
-    double sc_divider    = std::max(1.0, (mesh_volume / UNIT_VOLUME));
+    // With tiling, the memory is bounded by the tile size instead.
+    double sc_divider    = hc.tile_size > 0. ? 1. : std::max(1.0, (mesh_volume / UNIT_VOLUME));
     double min_oversampl = std::max(MIN_SAMPLES_IN_WALL / hc.min_thickness, 1.);
     double max_oversampl_scaled = std::max(min_oversampl, MAX_OVERSAMPL / sc_divider);
     auto   voxel_scale          = min_oversampl + (max_oversampl_scaled - min_oversampl) * hc.quality;
@@ -893,10 +1275,14 @@ int hollow_mesh_and_drill(indexed_triangle_set &hollowed_mesh,
         hollowed_mesh =
             MeshBoolean::cgal::cgal_to_indexed_triangle_set(*hollowed_mesh_cgal);
 
-        std::vector<bool> exclude_mask =
-            create_exclude_mask(hollowed_mesh, interior, drainholes);
+        // Without the grid of the interior (generated in tiles), the
+        // triangles inside the cavity can't be found.
+        if (interior.gridptr) {
+            std::vector<bool> exclude_mask =
+                create_exclude_mask(hollowed_mesh, interior, drainholes);
 
-        sla::remove_inside_triangles(hollowed_mesh, interior, exclude_mask);
+            sla::remove_inside_triangles(hollowed_mesh, interior, exclude_mask);
+        }
     } catch (const Slic3r::RuntimeError &) {
         ret |= static_cast<int>(HollowMeshResult::DrillingFailed);
     }
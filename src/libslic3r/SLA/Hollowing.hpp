@@ -37,6 +37,16 @@ struct HollowingConfig
     double quality          = 0.5;
     double closing_distance = 0.5;
     bool enabled = true;
+
+    // Edge length in mm of the cubic tiles in which the interior is
+    // generated, zero generates the whole interior at once. Each tile is
+    // voxelized from the model cut to the tile and a margin around it, then
+    // offset and meshed on its own. The grid of the whole model is never
+    // built, so the voxel scale is not reduced for large models.
+    double tile_size = 0.;
+
+    // Maximum number of tiles processed at the same time.
+    size_t max_parallel_tiles = 4;
 };
 
 enum HollowingFlags { hfRemoveInsideTriangles = 0x1 };
@@ -54,6 +64,10 @@ const indexed_triangle_set &get_mesh(const Interior &interior);
 const VoxelGrid & get_grid(const Interior &interior);
 VoxelGrid &get_grid(Interior &interior);
 
+// Peak memory in bytes of the voxel grids held at the same time while the
+// interior was generated.
+size_t get_peak_grid_memory(const Interior &interior);
+
 struct DrainHole
 {
     Vec3f pos;
@@ -100,6 +114,7 @@ constexpr float IsoAtZero = 0.f;
 
 double get_voxel_scale(double mesh_volume, const HollowingConfig &hc);
 
+// The grid is offset as a whole, the tile size is not used.
 InteriorPtr generate_interior(const VoxelGrid &mesh,
                               const HollowingConfig &  = {},
                               const JobController &ctl = {});
@@ -128,11 +143,34 @@ template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
     return mesh_vol;
 }
 
+// Generate the interior in tiles of hc.tile_size. The transformations of the
+// parts are ignored, their meshes have to be in world coordinates already.
+InteriorPtr generate_interior_tiled(const std::vector<csg::CSGPart> &csgparts,
+                                    const HollowingConfig           &hc,
+                                    const JobController             &ctl);
+
 template<class It>
 InteriorPtr generate_interior(const Range<It>       &csgparts,
                               const HollowingConfig &hc  = {},
                               const JobController   &ctl = {})
 {
+    if (hc.tile_size > 0.) {
+        std::vector<csg::CSGPart> parts;
+        parts.reserve(csgparts.size());
+        for (const auto &csgpart : csgparts) {
+            std::unique_ptr<indexed_triangle_set> m;
+            if (const indexed_triangle_set *its = csg::get_mesh(csgpart)) {
+                m = std::make_unique<indexed_triangle_set>(*its);
+                its_transform(*m, csg::get_transform(csgpart), true);
+            }
+
+            auto &part = parts.emplace_back(std::move(m), csg::get_operation(csgpart));
+            part.stack_operation = csg::get_stack_operation(csgpart);
+        }
+
+        return generate_interior_tiled(parts, hc, ctl);
+    }
+
     double mesh_vol = csgmesh_positive_maxvolume(csgparts);
     double voxsc    = get_voxel_scale(mesh_vol, hc);
 
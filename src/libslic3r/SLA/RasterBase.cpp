@@ -8,8 +8,10 @@
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
+#include <libslic3r/SLA/ScanlineRaster.hpp>
 // minz image write:
 #include <miniz.h>
+#include <libslic3r/miniz_extension.hpp>
 #include <algorithm>
 #include <cmath>
 #include <iterator>
@@ -25,7 +27,8 @@ EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
     std::vector<uint8_t> buf;
     size_t s = 0;
     
-    void *rawdata = tdefl_write_image_to_png_file_in_memory(
+    // Large rasters are deflated in parallel blocks of rows.
+    void *rawdata = write_png_to_memory_parallel(
         ptr, int(w), int(h), int(num_components), &s);
     
     // On error, data() will return an empty vector. No other info can be
@@ -74,10 +77,20 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const Resolution        &res,
     const PixelDim          &pxdim,
     double                   gamma,
-    const RasterBase::Trafo &tr)
+    const RasterBase::Trafo &tr,
+    RasterBackend            backend)
 {
     std::unique_ptr<RasterBase> rst;
-    
+
+    if (backend == RasterBackend::Scanline) {
+        ScanlineRaster::GammaFn gammafn;
+        if (gamma > 0)
+            gammafn = [gamma](double x) { return std::pow(x, gamma); };
+        else
+            gammafn = [](double x) { return x < .5 ? 0. : 1.; };
+        return std::make_unique<ScanlineRaster>(res, pxdim, tr, gammafn);
+    }
+
     if (gamma > 0)
         rst = std::make_unique<RasterGrayscaleAAGammaPower>(res, pxdim, tr, gamma);
     else if (std::abs(gamma - 1.) < 1e-6)
@@ -98,6 +98,13 @@ public:
     
     /// Draw a polygon with holes.
     virtual void draw(const ExPolygon& poly) = 0;
+
+    /// Draw all the polygons of a layer.
+    virtual void draw(const ExPolygons& polys)
+    {
+        for (const ExPolygon &poly : polys)
+            draw(poly);
+    }
     
     /// Get the resolution of the raster.
 //    virtual Resolution resolution() const = 0;
@@ -117,12 +124,18 @@ struct PPMRasterEncoder {
 
 std::ostream& operator<<(std::ostream &stream, const EncodedRaster &bytes);
 
+enum class RasterBackend {
+    AGG,      // Generic AGG scanline pipeline, see AGGRaster.hpp
+    Scanline  // Specialized sub-scanline rasterizer, see ScanlineRaster.hpp
+};
+
 // If gamma is zero, thresholding will be performed which disables AA.
 std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const Resolution        &res,
     const PixelDim          &pxdim,
-    double                   gamma = 1.0,
-    const RasterBase::Trafo &tr    = {});
+    double                   gamma   = 1.0,
+    const RasterBase::Trafo &tr      = {},
+    RasterBackend            backend = RasterBackend::AGG);
 
 }} // namespace Slic3r::sla
 
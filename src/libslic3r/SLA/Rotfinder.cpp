@@ -4,14 +4,17 @@
 ///|/
 #include <libslic3r/SLA/Rotfinder.hpp>
 #include <libslic3r/Execution/ExecutionTBB.hpp>
-#include <libslic3r/Optimize/BruteforceOptimizer.hpp>
 #include <libslic3r/Geometry.hpp>
+#include <libslic3r/QuadricEdgeCollapse.hpp>
+#include <atomic>
+#include <mutex>
 #include <limits>
 #include <thread>
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <iterator>
+#include <numeric>
 #include <vector>
 #include <cinttypes>
 #include <cstdlib>
@@ -21,7 +24,6 @@
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/Execution/Execution.hpp"
 #include "libslic3r/Model.hpp"
-#include "libslic3r/Optimize/Optimizer.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/libslic3r.h"
@@ -33,21 +35,25 @@ namespace {
 inline const Vec3f DOWN = {0.f, 0.f, -1.f};
 constexpr double POINTS_PER_UNIT_AREA = 1.f;
 
+// The faces are scored in chunks of this size between the checks if the
+// score of a rotation can still beat the best one.
+constexpr size_t SCORE_CHUNK_SIZE = 4096;
+
 // Get the vertices of a triangle directly in an array of 3 points
-std::array<Vec3f, 3> get_triangle_vertices(const TriangleMesh &mesh,
-                                           size_t              faceidx)
+std::array<Vec3f, 3> get_triangle_vertices(const indexed_triangle_set &its,
+                                           size_t                      faceidx)
 {
-    const auto &face = mesh.its.indices[faceidx];
-    return {mesh.its.vertices[face(0)],
-            mesh.its.vertices[face(1)],
-            mesh.its.vertices[face(2)]};
+    const auto &face = its.indices[faceidx];
+    return {its.vertices[face(0)],
+            its.vertices[face(1)],
+            its.vertices[face(2)]};
 }
 
-std::array<Vec3f, 3> get_transformed_triangle(const TriangleMesh &mesh,
-                                              const Transform3f & tr,
-                                              size_t              faceidx)
+std::array<Vec3f, 3> get_transformed_triangle(const indexed_triangle_set &its,
+                                              const Transform3f &         tr,
+                                              size_t                      faceidx)
 {
-    const auto &tri = get_triangle_vertices(mesh, faceidx);
+    const auto &tri = get_triangle_vertices(its, faceidx);
     return {tr * tri[0], tr * tri[1], tr * tri[2]};
 }
 
@@ -58,17 +64,6 @@ template<class T> Vec<3, T> normal(const std::array<Vec<3, T>, 3> &tri)
     return U.cross(V).normalized();
 }
 
-template<class T, class AccessFn>
-T sum_score(AccessFn &&accessfn, size_t facecount, size_t Nthreads)
-{
-    T  initv         = 0.;
-    auto   mergefn   = [](T a, T b) { return a + b; };
-    size_t grainsize = facecount / Nthreads;
-    size_t from = 0, to = facecount;
-
-    return execution::reduce(ex_tbb, from, to, initv, mergefn, accessfn, grainsize);
-}
-
 // Get area and normal of a triangle
 struct Facestats {
     Vec3f  normal;
@@ -84,26 +79,70 @@ struct Facestats {
     }
 };
 
-// Try to guess the number of support points needed to support a mesh
-double get_misalginment_score(const TriangleMesh &mesh, const Transform3f &tr)
+// The areas of the faces do not depend on the rotation. The sum of the face
+// areas from the start of each chunk of faces to the end of the mesh bounds
+// the score of the faces not scored yet for any rotation.
+std::vector<double> get_remaining_areas(const indexed_triangle_set &its)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    size_t facecount = its.indices.size();
+    size_t chunks    = facecount / SCORE_CHUNK_SIZE + 1;
+
+    std::vector<double> areas(chunks + 1, 0.);
+    for (size_t fi = 0; fi < facecount; ++fi)
+        areas[fi / SCORE_CHUNK_SIZE] += Facestats{get_triangle_vertices(its, fi)}.area;
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
+    for (size_t c = chunks; c > 0; --c)
+        areas[c - 1] += areas[c];
 
-        float score = fc.area
-                      * (std::abs(fc.normal.dot(Vec3f::UnitX()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitY()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitZ())));
+    return areas;
+}
 
-        // We should score against the alignment with the reference planes
-        return scaled<int_fast64_t>(score);
+// Sum the face scores of a rotation sequentially. The score of a face has to
+// be at least min_factor times the face area. Returns infinity as soon as the
+// sum cannot get below the limit.
+template<class FaceScoreFn>
+double sum_score_bounded(FaceScoreFn             &&facescorefn,
+                         size_t                    facecount,
+                         const std::vector<double> &remaining_areas,
+                         double                    min_factor,
+                         double                    limit)
+{
+    double S = 0.;
+    for (size_t c = 0; c * SCORE_CHUNK_SIZE < facecount; ++c) {
+        if (S + min_factor * remaining_areas[c] > limit)
+            return std::numeric_limits<double>::infinity();
+
+        size_t to = std::min(facecount, (c + 1) * SCORE_CHUNK_SIZE);
+        for (size_t fi = c * SCORE_CHUNK_SIZE; fi < to; ++fi)
+            S += facescorefn(fi);
+    }
+
+    return S;
+}
+
+inline double get_misalignment_score(const Facestats &fc)
+{
+    // We should score against the alignment with the reference planes
+    return fc.area * (std::abs(fc.normal.dot(Vec3f::UnitX())) +
+                      std::abs(fc.normal.dot(Vec3f::UnitY())) +
+                      std::abs(fc.normal.dot(Vec3f::UnitZ())));
+}
+
+// The misalignment score is maximized, this is its negative to be minimized.
+// The sum of the absolute coordinates of a unit normal is at most sqrt(3).
+double get_misalignment_score(const indexed_triangle_set &its,
+                              const std::vector<double>  &remaining_areas,
+                              const Transform3f          &tr,
+                              double                      limit)
+{
+    size_t facecount = its.indices.size();
+
+    auto facescorefn = [&its, &tr](size_t fi) {
+        return -get_misalignment_score(Facestats{get_transformed_triangle(its, tr, fi)});
     };
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    double S = sum_score_bounded(facescorefn, facecount, remaining_areas,
+                                 -std::sqrt(3.), limit * facecount);
 
     return S / facecount;
 }
@@ -126,52 +165,47 @@ inline double get_supportedness_score(const Facestats &fc)
 }
 
 // Try to guess the number of support points needed to support a mesh
-double get_supportedness_score(const TriangleMesh &mesh, const Transform3f &tr)
+double get_supportedness_score(const indexed_triangle_set &its,
+                               const std::vector<double>  &remaining_areas,
+                               const Transform3f          &tr,
+                               double                      limit)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    size_t facecount = its.indices.size();
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
-        return scaled<int_fast64_t>(get_supportedness_score(fc));
+    auto facescorefn = [&its, &tr](size_t fi) {
+        return get_supportedness_score(Facestats{get_transformed_triangle(its, tr, fi)});
     };
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    double S = sum_score_bounded(facescorefn, facecount, remaining_areas, 0.,
+                                 limit * facecount);
 
     return S / facecount;
 }
 
-// Find transformed mesh ground level without copy and with parallel reduce.
-float find_ground_level(const TriangleMesh &mesh,
-                         const Transform3f & tr,
-                         size_t              threads)
+// Find transformed mesh ground level without copy.
+float find_ground_level(const indexed_triangle_set &its, const Transform3f &tr)
 {
-    size_t vsize = mesh.its.vertices.size();
-
-    auto minfn = [](float a, float b) { return std::min(a, b); };
-
-    auto accessfn = [&mesh, &tr] (size_t vi) {
-        return (tr * mesh.its.vertices[vi]).z();
-    };
-
     auto zmin = std::numeric_limits<float>::max();
-    size_t granularity = vsize / threads;
-    return execution::reduce(ex_tbb, size_t(0), vsize, zmin, minfn, accessfn, granularity);
+    for (const Vec3f &v : its.vertices)
+        zmin = std::min(zmin, (tr * v).z());
+
+    return zmin;
 }
 
-double get_supportedness_onfloor_score(const TriangleMesh &mesh,
-                                       const Transform3f  &tr)
+// The faces lying on the ground are scored with -2 * area, the rest with a
+// non-negative supportedness score.
+double get_supportedness_onfloor_score(const indexed_triangle_set &its,
+                                       const std::vector<double>  &remaining_areas,
+                                       const Transform3f          &tr,
+                                       double                      limit)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
-
-    size_t Nthreads = std::thread::hardware_concurrency();
+    size_t facecount = its.indices.size();
 
-    float zmin = find_ground_level(mesh, tr, Nthreads);
+    float zmin = find_ground_level(its, tr);
     float zlvl = zmin + 0.1f; // Set up a slight tolerance from z level
 
-    auto accessfn = [&mesh, &tr, zlvl](size_t fi) {
-        std::array<Vec3f, 3> tri = get_transformed_triangle(mesh, tr, fi);
+    auto facescorefn = [&its, &tr, zlvl](size_t fi) {
+        std::array<Vec3f, 3> tri = get_transformed_triangle(its, tr, fi);
         Facestats fc{tri};
 
         if (tri[0].z() <= zlvl && tri[1].z() <= zlvl && tri[2].z() <= zlvl)
@@ -180,8 +214,8 @@ double get_supportedness_onfloor_score(const TriangleMesh &mesh,
         return get_supportedness_score(fc);
     };
 
-    size_t facecount = mesh.its.indices.size();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    double S = sum_score_bounded(facescorefn, facecount, remaining_areas,
+                                 -2 * POINTS_PER_UNIT_AREA, limit * facecount);
 
     return S / facecount;
 }
@@ -236,7 +270,7 @@ std::vector<XYRotation> get_chull_rotations(const TriangleMesh &mesh, size_t max
     };
 
     for (size_t fi = 0; fi < facecount; ++fi) {
-        Facestats fc{get_triangle_vertices(chull, fi)};
+        Facestats fc{get_triangle_vertices(chull.its, fi)};
 
         if (fc.area > area_threshold)  {
             auto q = Eigen::Quaternionf{}.FromTwoVectors(fc.normal, DOWN);
@@ -291,6 +325,87 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
     return ret;
 }
 
+// The rotations sampled by a grid search over both axes
+std::vector<XYRotation> get_grid_rotations(size_t gridsize)
+{
+    gridsize = std::max(gridsize, size_t(2));
+
+    auto   ret  = reserve_vector<XYRotation>(gridsize * gridsize);
+    double step = 2. * PI / (gridsize - 1);
+    for (size_t y = 0; y < gridsize; ++y)
+        for (size_t x = 0; x < gridsize; ++x)
+            ret.push_back({-PI + x * step, -PI + y * step});
+
+    return ret;
+}
+
+// Find the rotation with the minimum score. Each rotation is scored by a
+// single thread, the rotations are scored concurrently. If a proxy mesh is
+// given, all the rotations are scored on the proxy and only the best
+// refine_count of them are scored on the full mesh. The scoring on the full
+// mesh gives up a rotation as soon as it cannot beat the best one.
+//
+// scorefn(its, remaining_areas, rotation, limit) has to return the score of
+// the rotation or anything above the limit if the score is above the limit.
+template<class ScoreFn, class StopCond>
+XYRotation find_min_score_multires(const indexed_triangle_set    &its,
+                                   const indexed_triangle_set    *proxy,
+                                   std::vector<XYRotation>        inputs,
+                                   size_t                         refine_count,
+                                   ScoreFn                      &&scorefn,
+                                   StopCond                     &&stopfn)
+{
+    static constexpr double Inf = std::numeric_limits<double>::infinity();
+
+    auto score_all = [&inputs, &scorefn, &stopfn](const indexed_triangle_set &m,
+                                                  bool early_out) {
+        std::vector<double> remaining_areas = get_remaining_areas(m);
+        std::vector<double> scores(inputs.size(), Inf);
+        std::atomic<double> best{Inf};
+
+        execution::for_each(ex_tbb, size_t(0), inputs.size(),
+            [&](size_t i) {
+                if (stopfn())
+                    return;
+
+                double score = scorefn(m, remaining_areas, inputs[i],
+                                       early_out ? best.load() : Inf);
+                scores[i] = score;
+
+                double b = best.load();
+                while (score < b && !best.compare_exchange_weak(b, score));
+            }, 1);
+
+        return scores;
+    };
+
+    if (inputs.empty() || its.indices.empty())
+        return {};
+
+    if (proxy && refine_count < inputs.size()) {
+        std::vector<double> scores = score_all(*proxy, false);
+
+        std::vector<size_t> idx(inputs.size());
+        std::iota(idx.begin(), idx.end(), 0);
+        std::stable_sort(idx.begin(), idx.end(), [&scores](size_t a, size_t b) {
+            return scores[a] < scores[b];
+        });
+
+        // Keep the best candidates, the best of the proxy first, to have a
+        // tight limit for the rest early.
+        auto refined = reserve_vector<XYRotation>(refine_count);
+        for (size_t i = 0; i < std::max(refine_count, size_t(1)); ++i)
+            refined.emplace_back(inputs[idx[i]]);
+
+        inputs = std::move(refined);
+    }
+
+    std::vector<double> scores = score_all(its, true);
+
+    return inputs[std::distance(scores.begin(),
+                                std::min_element(scores.begin(), scores.end()))];
+}
+
 } // namespace
 
 
@@ -299,11 +414,19 @@ template<unsigned MAX_ITER>
 struct RotfinderBoilerplate {
     static constexpr unsigned MAX_TRIES = MAX_ITER;
 
-    int status = 0, prev_status = 0;
+    // The rotations are scored concurrently, statusfn() and stopcond() are
+    // called from several threads. The status callback is only invoked with
+    // the mutex locked.
+    std::atomic<int> status{0}, prev_status{0};
+    std::mutex statuscb_mtx;
     TriangleMesh mesh;
     unsigned max_tries;
     const RotOptimizeParams &params;
 
+    // Decimated mesh to score the rotations on first, empty if the mesh is
+    // small enough to be scored as is.
+    indexed_triangle_set proxy;
+
     // Assemble the mesh with the correct transformation to be used in rotation
     // optimization.
     static TriangleMesh get_mesh_to_rotate(const ModelObject &mo)
@@ -324,51 +447,92 @@ struct RotfinderBoilerplate {
         , params{p}
     {}
 
-    void statusfn() {
-        int s = status * 100 / max_tries;
-        if (s != prev_status) {
-            params.statuscb()(s);
-            prev_status = s;
+    void create_proxy()
+    {
+        size_t facecount = params.proxy_facecount();
+        if (facecount == 0 || mesh.its.indices.size() <= facecount)
+            return;
+
+        struct Cancelled {};
+
+        proxy = mesh.its;
+        try {
+            its_quadric_edge_collapse_parallel(proxy, uint32_t(facecount), nullptr,
+                                               [this] { if (stopcond()) throw Cancelled{}; });
+        } catch (const Cancelled &) {
+            proxy.clear();
         }
+    }
+
+    const indexed_triangle_set *get_proxy() const
+    {
+        return proxy.indices.empty() ? nullptr : &proxy;
+    }
 
-        ++status;
+    // The number of scored rotations including the refinement on the full mesh
+    unsigned scoring_count(size_t rotation_count) const
+    {
+        if (!get_proxy() || params.refine_count() >= rotation_count)
+            return rotation_count;
+
+        return rotation_count + std::max(params.refine_count(), size_t(1));
+    }
+
+    void statusfn() {
+        int s = int(status.fetch_add(1) * 100 / max_tries);
+
+        // Only the thread which raises prev_status reports, and only if no
+        // other thread has raised it further in the meantime.
+        int prev = prev_status.load();
+        while (s > prev)
+            if (prev_status.compare_exchange_weak(prev, s)) {
+                std::lock_guard lk{statuscb_mtx};
+                if (prev_status.load() == s)
+                    params.statuscb()(s);
+
+                break;
+            }
     }
 
-    bool stopcond() { return ! params.statuscb()(-1); }
+    bool stopcond()
+    {
+        std::lock_guard lk{statuscb_mtx};
+        return ! params.statuscb()(-1);
+    }
 };
 
 Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
                                       const RotOptimizeParams &params)
 {
     RotfinderBoilerplate<1000> bp{mo, params};
+    bp.create_proxy();
 
-    // Preparing the optimizer.
+    // We are searching rotations around only two axes x, y on a grid
+    // in the bounds of {-PI, PI} for both.
     size_t gridsize = std::sqrt(bp.max_tries);
-    opt::Optimizer<opt::AlgBruteForce> solver(
-        opt::StopCriteria{}.max_iterations(bp.max_tries)
-                           .stop_condition([&bp] { return bp.stopcond(); }),
-        gridsize
-    );
-
-    // We are searching rotations around only two axes x, y. Thus the
-    // problem becomes a 2 dimensional optimization task.
-    // We can specify the bounds for a dimension in the following way:
-    auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-    auto result = solver.to_max().optimize(
-        [&bp] (const XYRotation &rot)
-        {
-            bp.statusfn();
-            return get_misalginment_score(bp.mesh, to_transform3f(rot));
-        }, opt::initvals({0., 0.}), bounds);
+    std::vector<XYRotation> inputs = get_grid_rotations(gridsize);
+    bp.max_tries = bp.scoring_count(inputs.size());
 
-    return {result.optimum[0], result.optimum[1]};
+    auto scorefn = [&bp](const indexed_triangle_set &its,
+                         const std::vector<double>  &remaining_areas,
+                         const XYRotation           &rot,
+                         double                      limit) {
+        bp.statusfn();
+        return get_misalignment_score(its, remaining_areas, to_transform3f(rot), limit);
+    };
+
+    XYRotation rot = find_min_score_multires(bp.mesh.its, bp.get_proxy(), inputs,
+                                             params.refine_count(), scorefn,
+                                             [&bp] { return bp.stopcond(); });
+
+    return {rot[0], rot[1]};
 }
 
 Vec2d find_least_supports_rotation(const ModelObject &      mo,
                                    const RotOptimizeParams &params)
 {
     RotfinderBoilerplate<1000> bp{mo, params};
+    bp.create_proxy();
 
     SLAPrintObjectConfig pocfg;
     if (params.print_config())
@@ -378,48 +542,47 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
 
     XYRotation rot;
 
+    auto stopfn = [&bp] { return bp.stopcond(); };
+
     // Different search methods have to be used depending on the model elevation
     if (is_on_floor(pocfg)) {
 
         std::vector<XYRotation> inputs = get_chull_rotations(bp.mesh, bp.max_tries);
-        bp.max_tries = inputs.size();
+        bp.max_tries = bp.scoring_count(inputs.size());
 
         // If the model can be placed on the bed directly, we only need to
         // check the 3D convex hull face rotations.
 
-        auto objfn = [&bp](const XYRotation &rot) {
+        auto scorefn = [&bp](const indexed_triangle_set &its,
+                             const std::vector<double>  &remaining_areas,
+                             const XYRotation           &rot,
+                             double                      limit) {
             bp.statusfn();
-            Transform3f tr = to_transform3f(rot);
-            return get_supportedness_onfloor_score(bp.mesh, tr);
+            return get_supportedness_onfloor_score(its, remaining_areas,
+                                                   to_transform3f(rot), limit);
         };
 
-        rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
-            return bp.stopcond();
-        });
+        rot = find_min_score_multires(bp.mesh.its, bp.get_proxy(), inputs,
+                                      params.refine_count(), scorefn, stopfn);
 
     } else {
-        // Preparing the optimizer.
+        // We are searching rotations around only two axes x, y on a grid
+        // in the bounds of {-PI, PI} for both.
         size_t gridsize = std::sqrt(bp.max_tries); // 2D grid has gridsize^2 calls
-        opt::Optimizer<opt::AlgBruteForce> solver(
-            opt::StopCriteria{}.max_iterations(bp.max_tries)
-                               .stop_condition([&bp] { return bp.stopcond(); }),
-            gridsize
-        );
-
-        // We are searching rotations around only two axes x, y. Thus the
-        // problem becomes a 2 dimensional optimization task.
-        // We can specify the bounds for a dimension in the following way:
-        auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-        auto result = solver.to_min().optimize(
-            [&bp] (const XYRotation &rot)
-            {
-                bp.statusfn();
-                return get_supportedness_score(bp.mesh, to_transform3f(rot));
-            }, opt::initvals({0., 0.}), bounds);
-
-        // Save the result
-        rot = result.optimum;
+        std::vector<XYRotation> inputs = get_grid_rotations(gridsize);
+        bp.max_tries = bp.scoring_count(inputs.size());
+
+        auto scorefn = [&bp](const indexed_triangle_set &its,
+                             const std::vector<double>  &remaining_areas,
+                             const XYRotation           &rot,
+                             double                      limit) {
+            bp.statusfn();
+            return get_supportedness_score(its, remaining_areas,
+                                           to_transform3f(rot), limit);
+        };
+
+        rot = find_min_score_multires(bp.mesh.its, bp.get_proxy(), inputs,
+                                      params.refine_count(), scorefn, stopfn);
     }
 
     return {rot[0], rot[1]};
@@ -459,7 +622,7 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     };
 
     for (size_t fi = 0; fi < chull.its.indices.size(); ++fi) {
-        Facestats fc{get_triangle_vertices(chull, fi)};
+        Facestats fc{get_triangle_vertices(chull.its, fi)};
 
         auto q = Eigen::Quaternionf{}.FromTwoVectors(fc.normal, DOWN);
         XYRotation rot = from_transform3f(Transform3f::Identity() * q);
@@ -8,6 +8,7 @@
 #include <libslic3r/Point.hpp>
 #include <functional>
 #include <array>
+#include <cstddef>
 #include <utility>
 
 namespace Slic3r {
@@ -23,12 +24,23 @@ using RotOptimizeStatusCB = std::function<bool(int)>;
 
 class RotOptimizeParams {
     float m_accuracy = 1.;
+    size_t m_proxy_facecount = 50000;
+    size_t m_refine_count = 8;
     const DynamicPrintConfig *m_print_config = nullptr;
     RotOptimizeStatusCB m_statuscb = [](int) { return true; };
 
 public:
 
     RotOptimizeParams &accuracy(float a) { m_accuracy = a; return *this; }
+
+    // Meshes with more faces are decimated to this face count to score the
+    // rotations on. Zero disables the decimation.
+    RotOptimizeParams &proxy_facecount(size_t c) { m_proxy_facecount = c; return *this; }
+
+    // The number of the best rotations on the decimated mesh which are
+    // scored again on the full mesh.
+    RotOptimizeParams &refine_count(size_t c) { m_refine_count = c; return *this; }
+
     RotOptimizeParams &print_config(const DynamicPrintConfig *c)
     {
         m_print_config = c;
@@ -41,6 +53,8 @@ public:
     }
 
     float accuracy() const { return m_accuracy; }
+    size_t proxy_facecount() const { return m_proxy_facecount; }
+    size_t refine_count() const { return m_refine_count; }
     const DynamicPrintConfig * print_config() const { return m_print_config; }
     const RotOptimizeStatusCB &statuscb() const { return m_statuscb; }
 };
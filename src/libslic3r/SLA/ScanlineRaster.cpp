@@ -0,0 +1,250 @@
+#include <libslic3r/SLA/ScanlineRaster.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Slic3r { namespace sla {
+
+ScanlineRaster::ScanlineRaster(const Resolution &res,
+                               const PixelDim   &pd,
+                               const Trafo      &trafo,
+                               const GammaFn    &gammafn,
+                               FillRule          fill_rule)
+    : m_resolution(res)
+    , m_pxdim_scaled(SCALING_FACTOR, SCALING_FACTOR)
+    , m_trafo(trafo)
+    , m_fill_rule(fill_rule)
+    , m_buf(res.pixels(), uint8_t(0))
+{
+    assert(pd.w_mm != 0 && pd.h_mm != 0);
+    if (pd.w_mm != 0 && pd.h_mm != 0) {
+        m_pxdim_scaled.x() /= pd.w_mm;
+        m_pxdim_scaled.y() /= pd.h_mm;
+    }
+
+    for (size_t i = 0; i < m_gamma.size(); ++ i) {
+        double v = gammafn ? gammafn(double(i) / 255.) : double(i) / 255.;
+        m_gamma[i] = uint8_t(std::clamp(std::lround(v * 255.), 0l, 255l));
+    }
+}
+
+// Same transformation as AGGRaster::to_path() applies.
+Vec2d ScanlineRaster::to_pixels(const Point &p) const
+{
+    double px = p.x() * m_pxdim_scaled.x();
+    double py = p.y() * m_pxdim_scaled.y();
+    Vec2d  ret = m_trafo.flipXY ? Vec2d{py, px} : Vec2d{px, py};
+
+    ret.x() += m_trafo.center_x * m_pxdim_scaled.x();
+    ret.y() += m_trafo.center_y * m_pxdim_scaled.y();
+
+    if (m_trafo.mirror_x) ret.x() = double(m_resolution.width_px) - ret.x();
+    if (m_trafo.mirror_y) ret.y() = double(m_resolution.height_px) - ret.y();
+
+    return ret;
+}
+
+void ScanlineRaster::add_edges(const Polygon &poly, int expoly_idx, std::vector<Edge> &edges) const
+{
+    if (poly.size() < 3)
+        return;
+
+    Vec2d prev = to_pixels(poly.points.back());
+    for (const Point &pt : poly.points) {
+        Vec2d next = to_pixels(pt);
+        if (prev.y() != next.y()) {
+            Edge e;
+            e.dir = prev.y() < next.y() ? 1.f : -1.f;
+            const Vec2d &a = e.dir > 0 ? prev : next;
+            const Vec2d &b = e.dir > 0 ? next : prev;
+            e.y0   = a.y();
+            e.y1   = b.y();
+            e.x0   = a.x();
+            e.dxdy = (b.x() - a.x()) / (b.y() - a.y());
+            e.expoly_idx = expoly_idx;
+            edges.emplace_back(e);
+        }
+        prev = next;
+    }
+}
+
+void ScanlineRaster::draw(const ExPolygon &poly)
+{
+    std::vector<Edge> edges;
+    add_edges(poly.contour, 0, edges);
+    for (const Polygon &hole : poly.holes)
+        add_edges(hole, 0, edges);
+    render(edges, 1);
+}
+
+void ScanlineRaster::draw(const ExPolygons &polys)
+{
+    std::vector<Edge> edges;
+    for (const ExPolygon &poly : polys) {
+        const int expoly_idx = int(&poly - polys.data());
+        add_edges(poly.contour, expoly_idx, edges);
+        for (const Polygon &hole : poly.holes)
+            add_edges(hole, expoly_idx, edges);
+    }
+    render(edges, polys.size());
+}
+
+// Accumulates the signed area covered by the part of an edge between rows y_begin and y_end into
+// the accumulation buffer, the first row of which is row y_row0. Integrating a row of the buffer from
+// the left yields the winding number weighted by the coverage of each pixel.
+static void accumulate_edge(const ScanlineRaster::Edge &e, int y_begin, int y_end, int y_row0, int width, float *acc)
+{
+    const int stride = width + 2;
+    double    x      = e.x0 + (std::max(double(y_begin), e.y0) - e.y0) * e.dxdy;
+
+    for (int y = y_begin; y < y_end; ++ y) {
+        const double dy    = std::min(double(y + 1), e.y1) - std::max(double(y), e.y0);
+        const double xnext = x + e.dxdy * dy;
+        const float  d     = float(dy) * e.dir;
+        // Clamping to the raster keeps the winding of the edges outside of it.
+        const double x0 = std::clamp(std::min(x, xnext), 0., double(width));
+        const double x1 = std::clamp(std::max(x, xnext), 0., double(width));
+        float *row = acc + size_t(y - y_row0) * stride;
+
+        const double x0floor = std::floor(x0);
+        const int    x0i     = int(x0floor);
+        const double x1ceil  = std::ceil(x1);
+        const int    x1i     = int(x1ceil);
+        if (x1i <= x0i + 1) {
+            // The edge stays within a single pixel of this row.
+            const float xmf = float(0.5 * (x0 + x1) - x0floor);
+            row[x0i]     += d - d * xmf;
+            row[x0i + 1] += d * xmf;
+        } else {
+            const double s   = 1. / (x1 - x0);
+            const double x0f = x0 - x0floor;
+            const double a0  = 0.5 * s * (1. - x0f) * (1. - x0f);
+            const double x1f = x1 - x1ceil + 1.;
+            const double am  = 0.5 * s * x1f * x1f;
+            row[x0i] += d * float(a0);
+            if (x1i == x0i + 2) {
+                row[x0i + 1] += d * float(1. - a0 - am);
+            } else {
+                const double a1 = s * (1.5 - x0f);
+                row[x0i + 1] += d * float(a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; ++ xi)
+                    row[xi] += d * float(s);
+                const double a2 = a1 + (x1i - x0i - 3) * s;
+                row[x1i - 1] += d * float(1. - a2 - am);
+            }
+            row[x1i] += d * float(am);
+        }
+        x = xnext;
+    }
+}
+
+void ScanlineRaster::render(std::vector<Edge> &edges, size_t num_expolys)
+{
+    if (edges.empty() || m_resolution.pixels() == 0)
+        return;
+
+    // The edge table is sorted once, the bands of rows then activate the edges in order.
+    std::sort(edges.begin(), edges.end(), [](const Edge &l, const Edge &r) { return l.y0 < r.y0; });
+
+    const int width  = int(m_resolution.width_px);
+    const int height = int(m_resolution.height_px);
+    const int stride = width + 2;
+
+    // Rows are accumulated in bands to keep the accumulation buffer small for large displays.
+    static constexpr int BandRows = 32;
+    std::vector<float>       acc(size_t(stride) * BandRows, 0.f);
+    std::vector<const Edge*> active;
+    size_t                   next_edge = 0;
+
+    // Horizontal extents of the ExPolygons in the current band. The coverage outside of them
+    // is zero, thus the rows are only integrated over their union.
+    std::vector<std::pair<double, double>> expoly_extents(num_expolys);
+    std::vector<int>                       band_expolys;
+    std::vector<std::pair<int, int>>       spans;
+
+    const int row_first = std::clamp(int(std::floor(edges.front().y0)), 0, height);
+    for (int band_begin = row_first; band_begin < height; band_begin += BandRows) {
+        const int band_end = std::min(height, band_begin + BandRows);
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [band_begin](const Edge *e) { return e->y1 <= band_begin; }),
+                     active.end());
+        while (next_edge < edges.size() && edges[next_edge].y0 < band_end)
+            active.emplace_back(&edges[next_edge ++]);
+        if (active.empty()) {
+            if (next_edge == edges.size())
+                break;
+            continue;
+        }
+
+        band_expolys.clear();
+        for (const Edge *e : active) {
+            const int y_begin = std::max(band_begin, int(std::floor(e->y0)));
+            const int y_end   = std::min(band_end, int(std::ceil(e->y1)));
+            if (y_begin >= y_end)
+                continue;
+            accumulate_edge(*e, y_begin, y_end, band_begin, width, acc.data());
+            const double xa = e->x0 + (std::max(double(y_begin), e->y0) - e->y0) * e->dxdy;
+            const double xb = e->x0 + (std::min(double(y_end), e->y1) - e->y0) * e->dxdy;
+            std::pair<double, double> &extent = expoly_extents[e->expoly_idx];
+            if (std::find(band_expolys.begin(), band_expolys.end(), e->expoly_idx) == band_expolys.end()) {
+                band_expolys.emplace_back(e->expoly_idx);
+                extent = { std::min(xa, xb), std::max(xa, xb) };
+            } else {
+                extent.first  = std::min(extent.first, std::min(xa, xb));
+                extent.second = std::max(extent.second, std::max(xa, xb));
+            }
+        }
+
+        spans.clear();
+        for (int idx : band_expolys) {
+            const std::pair<double, double> &extent = expoly_extents[idx];
+            spans.emplace_back(std::clamp(int(std::floor(extent.first)), 0, width),
+                               std::clamp(int(std::ceil(extent.second)) + 2, 0, stride));
+        }
+        std::sort(spans.begin(), spans.end());
+        size_t num_spans = 0;
+        for (const std::pair<int, int> &span : spans)
+            if (num_spans > 0 && span.first <= spans[num_spans - 1].second)
+                spans[num_spans - 1].second = std::max(spans[num_spans - 1].second, span.second);
+            else
+                spans[num_spans ++] = span;
+        spans.resize(num_spans);
+
+        // Integrate the accumulated rows, map the coverage through the gamma table and blend white
+        // over the pixels as the AGG solid scanline renderer does.
+        for (int y = band_begin; y < band_end; ++ y) {
+            float   *row = acc.data() + size_t(y - band_begin) * stride;
+            uint8_t *dst = m_buf.data() + size_t(y) * m_resolution.width_px;
+            for (const auto &[xlo, xhi] : spans) {
+                const int xend    = std::min(xhi, width);
+                float     winding = 0.f;
+                for (int x = xlo; x < xend;) {
+                    winding += row[x];
+                    row[x] = 0.f;
+                    float cover = std::abs(winding);
+                    if (m_fill_rule == frEvenOdd) {
+                        cover -= 2.f * std::floor(cover * 0.5f);
+                        cover = cover > 1.f ? 2.f - cover : cover;
+                    }
+                    const unsigned alpha = m_gamma[int(std::min(cover, 1.f) * 255.f + 0.5f)];
+                    const unsigned px    = dst[x];
+                    dst[x ++] = uint8_t(px + ((255u - px) * alpha + 127u) / 255u);
+                    if (alpha == 0 || alpha == 255) {
+                        // No edge crosses the following run of pixels, their coverage is the same.
+                        int run_end = x;
+                        while (run_end < xend && row[run_end] == 0.f)
+                            ++ run_end;
+                        if (alpha == 255)
+                            std::fill(dst + x, dst + run_end, uint8_t(255));
+                        x = run_end;
+                    }
+                }
+                std::fill(row + xend, row + xhi, 0.f);
+            }
+        }
+    }
+}
+
+}} // namespace Slic3r::sla
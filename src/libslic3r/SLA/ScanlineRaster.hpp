@@ -0,0 +1,83 @@
+#ifndef SLA_SCANLINERASTER_HPP
+#define SLA_SCANLINERASTER_HPP
+
+#include <libslic3r/SLA/RasterBase.hpp>
+#include <libslic3r/ExPolygon.hpp>
+
+#include <array>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+namespace Slic3r { namespace sla {
+
+/*
+ * Anti-aliased grayscale canvas specialized for rasterizing the SLA layers,
+ * an alternative to the generic AGG pipeline of RasterGrayscaleAA.
+ *
+ * All the polygons passed to a single draw() call are merged into one edge
+ * table sorted by y, which is then processed in bands of rows. Each edge
+ * accumulates the exact signed area it covers into the pixels it crosses,
+ * the pixel coverage is then obtained by a single pass integrating each row,
+ * filling the runs of pixels not crossed by any edge at once.
+ * Pixel coverage is mapped to the output value by a gamma table. Fill color
+ * is always white and the background is black.
+ */
+class ScanlineRaster: public RasterBase {
+public:
+    enum FillRule { frNonZero, frEvenOdd };
+
+    // Maps the coverage of a pixel <0, 1> to its intensity <0, 1>.
+    using GammaFn = std::function<double(double)>;
+
+    ScanlineRaster(const Resolution &res,
+                   const PixelDim   &pd,
+                   const Trafo      &trafo,
+                   const GammaFn    &gammafn,
+                   FillRule          fill_rule = frNonZero);
+
+    Trafo      trafo() const override { return m_trafo; }
+    Resolution resolution() const { return m_resolution; }
+    PixelDim   pixel_dimensions() const
+    {
+        return {SCALING_FACTOR / m_pxdim_scaled.x(), SCALING_FACTOR / m_pxdim_scaled.y()};
+    }
+
+    void draw(const ExPolygon &poly) override;
+    // Rasterizes all the polygons of a layer at once.
+    void draw(const ExPolygons &polys) override;
+
+    EncodedRaster encode(RasterEncoder encoder) const override
+    {
+        return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);
+    }
+
+    uint8_t read_pixel(size_t col, size_t row) const { return m_buf[row * m_resolution.width_px + col]; }
+
+    void clear() { std::fill(m_buf.begin(), m_buf.end(), uint8_t(0)); }
+
+    // Non horizontal polygon edge in pixel coordinates, y0 < y1.
+    struct Edge {
+        double y0, y1;
+        double x0;      // x at y0
+        double dxdy;
+        float  dir;     // +1 for a downward edge, -1 for an upward one
+        int    expoly_idx;
+    };
+
+private:
+    Vec2d to_pixels(const Point &p) const;
+    void  add_edges(const Polygon &poly, int expoly_idx, std::vector<Edge> &edges) const;
+    void  render(std::vector<Edge> &edges, size_t num_expolys);
+
+    Resolution           m_resolution;
+    Vec2d                m_pxdim_scaled; // used for scaled coordinate polygons
+    Trafo                m_trafo;
+    FillRule             m_fill_rule;
+    std::array<uint8_t, 256> m_gamma;
+    std::vector<uint8_t> m_buf;
+};
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_SCANLINERASTER_HPP
@@ -37,6 +37,9 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
         using std::chrono::high_resolution_clock;
         auto start{high_resolution_clock::now()};
 
+        if (sm.pinhead_cache)
+            sm.pinhead_cache->start(sm);
+
         switch (sm.cfg.tree_type) {
         case SupportTreeType::Default: {
             create_default_tree(*builder, sm);
@@ -52,6 +55,9 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
         default:;
         }
 
+        if (sm.pinhead_cache && !ctl.stopcondition())
+            sm.pinhead_cache->finish();
+
         auto stop{high_resolution_clock::now()};
 
         using std::chrono::duration;
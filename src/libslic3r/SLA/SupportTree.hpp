@@ -118,6 +118,9 @@ struct SupportTreeConfig
 
 enum class MeshType { Support, Pad };
 
+class PinheadCache;
+class SupportSubtreeCache;
+
 struct SupportableMesh
 {
     AABBMesh          emesh;
@@ -126,6 +129,14 @@ struct SupportableMesh
     PadConfig         pad_cfg;
     double            zoffset = 0.;
 
+    // Optional cache of the pinhead placements shared by the support tree
+    // builds of this mesh, see PinheadCache.
+    std::shared_ptr<PinheadCache> pinhead_cache;
+
+    // Optional cache of the subtrees of the default support tree of this
+    // mesh, see SupportSubtreeCache.
+    std::shared_ptr<SupportSubtreeCache> subtree_cache;
+
     explicit SupportableMesh(const indexed_triangle_set &trmsh,
                              const SupportPoints        &sp,
                              const SupportTreeConfig    &c)
@@ -31,8 +31,12 @@ SupportTreeBuilder::SupportTreeBuilder(SupportTreeBuilder &&o)
     : m_heads(std::move(o.m_heads))
     , m_head_indices{std::move(o.m_head_indices)}
     , m_pillars{std::move(o.m_pillars)}
+    , m_junctions{std::move(o.m_junctions)}
     , m_bridges{std::move(o.m_bridges)}
     , m_crossbridges{std::move(o.m_crossbridges)}
+    , m_diffbridges{std::move(o.m_diffbridges)}
+    , m_pedestals{std::move(o.m_pedestals)}
+    , m_anchors{std::move(o.m_anchors)}
     , m_meshcache{std::move(o.m_meshcache)}
     , m_meshcache_valid{o.m_meshcache_valid}
     , m_model_height{o.m_model_height}
@@ -42,8 +46,12 @@ SupportTreeBuilder::SupportTreeBuilder(const SupportTreeBuilder &o)
     : m_heads(o.m_heads)
     , m_head_indices{o.m_head_indices}
     , m_pillars{o.m_pillars}
+    , m_junctions{o.m_junctions}
     , m_bridges{o.m_bridges}
     , m_crossbridges{o.m_crossbridges}
+    , m_diffbridges{o.m_diffbridges}
+    , m_pedestals{o.m_pedestals}
+    , m_anchors{o.m_anchors}
     , m_meshcache{o.m_meshcache}
     , m_meshcache_valid{o.m_meshcache_valid}
     , m_model_height{o.m_model_height}
@@ -54,8 +62,12 @@ SupportTreeBuilder &SupportTreeBuilder::operator=(SupportTreeBuilder &&o)
     m_heads = std::move(o.m_heads);
     m_head_indices = std::move(o.m_head_indices);
     m_pillars = std::move(o.m_pillars);
+    m_junctions = std::move(o.m_junctions);
     m_bridges = std::move(o.m_bridges);
     m_crossbridges = std::move(o.m_crossbridges);
+    m_diffbridges = std::move(o.m_diffbridges);
+    m_pedestals = std::move(o.m_pedestals);
+    m_anchors = std::move(o.m_anchors);
     m_meshcache = std::move(o.m_meshcache);
     m_meshcache_valid = o.m_meshcache_valid;
     m_model_height = o.m_model_height;
@@ -67,8 +79,12 @@ SupportTreeBuilder &SupportTreeBuilder::operator=(const SupportTreeBuilder &o)
     m_heads = o.m_heads;
     m_head_indices = o.m_head_indices;
     m_pillars = o.m_pillars;
+    m_junctions = o.m_junctions;
     m_bridges = o.m_bridges;
     m_crossbridges = o.m_crossbridges;
+    m_diffbridges = o.m_diffbridges;
+    m_pedestals = o.m_pedestals;
+    m_anchors = o.m_anchors;
     m_meshcache = o.m_meshcache;
     m_meshcache_valid = o.m_meshcache_valid;
     m_model_height = o.m_model_height;
@@ -87,6 +103,71 @@ void SupportTreeBuilder::add_pillar_base(long pid, double baseheight, double rad
     m_meshcache_valid = false;
 }
 
+void SupportTreeBuilder::append(const SupportTreeBuilder &o,
+                                const std::vector<unsigned> &head_ids)
+{
+    std::lock_guard<Mutex> lk(m_mutex);
+
+    // The merged mesh of the other tree can be reused if this tree is empty
+    // or its mesh is up to date as well.
+    bool empty = m_heads.empty() && m_pillars.empty() && m_junctions.empty() &&
+                 m_bridges.empty() && m_crossbridges.empty() &&
+                 m_diffbridges.empty() && m_pedestals.empty() &&
+                 m_anchors.empty();
+    bool meshcache_valid = (empty || m_meshcache_valid) && o.m_meshcache_valid;
+
+    auto shifted = [](long id, size_t offs) {
+        return id == SupportTreeNode::ID_UNSET ? id : id + long(offs);
+    };
+
+    auto append_nodes = [&shifted](auto &dst, const auto &src) {
+        size_t offs = dst.size();
+        for (const auto &node : src) {
+            dst.emplace_back(node);
+            dst.back().id = shifted(node.id, offs);
+        }
+    };
+
+    size_t pillar_offs = m_pillars.size();
+    size_t bridge_offs = m_bridges.size();
+
+    for (const Head &h : o.m_heads) {
+        Head &head = m_heads.emplace_back(h);
+        head.pillar_id = shifted(h.pillar_id, pillar_offs);
+        head.bridge_id = shifted(h.bridge_id, bridge_offs);
+
+        if (h.is_valid()) {
+            assert(size_t(h.id) < head_ids.size());
+            head.id = head_ids[size_t(h.id)];
+            if (size_t(head.id) >= m_head_indices.size())
+                m_head_indices.resize(size_t(head.id) + 1);
+            m_head_indices[size_t(head.id)] = m_heads.size() - 1;
+        }
+    }
+
+    for (const Pillar &p : o.m_pillars) {
+        Pillar &pillar = m_pillars.emplace_back(p);
+        pillar.id = shifted(p.id, pillar_offs);
+        if (p.starts_from_head && p.start_junction_id >= 0)
+            pillar.start_junction_id = head_ids[size_t(p.start_junction_id)];
+    }
+
+    append_nodes(m_junctions, o.m_junctions);
+    append_nodes(m_bridges, o.m_bridges);
+    append_nodes(m_crossbridges, o.m_crossbridges);
+    append_nodes(m_diffbridges, o.m_diffbridges);
+    append_nodes(m_pedestals, o.m_pedestals);
+    append_nodes(m_anchors, o.m_anchors);
+
+    if (meshcache_valid) {
+        its_merge(m_meshcache, o.m_meshcache);
+        BoundingBoxf3 bb = bounding_box(m_meshcache);
+        m_model_height   = bb.max(Z) - bb.min(Z);
+    }
+
+    m_meshcache_valid = meshcache_valid;
+}
+
 const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
 {
     if (m_meshcache_valid) return m_meshcache;
@@ -179,4 +260,59 @@ const indexed_triangle_set &SupportTreeBuilder::retrieve_mesh(MeshType meshtype)
     return m_meshcache;
 }
 
+void PinheadCache::start(const SupportableMesh &sm)
+{
+    std::vector<double> fingerprint = {
+        double(sm.cfg.tree_type),
+        sm.cfg.head_front_radius_mm,
+        sm.cfg.head_penetration_mm,
+        sm.cfg.head_back_radius_mm,
+        sm.cfg.head_fallback_radius_mm,
+        sm.cfg.head_width_mm,
+        sm.cfg.bridge_slope,
+        ground_level(sm)
+    };
+
+    if (fingerprint != m_fingerprint) {
+        m_heads.clear();
+        m_fingerprint = std::move(fingerprint);
+    }
+
+    m_next_heads.clear();
+}
+
+const std::optional<Head> *PinheadCache::find(const SupportPoint &sp) const
+{
+    auto it = m_heads.find(key(sp));
+
+    return it == m_heads.end() ? nullptr : &it->second;
+}
+
+void PinheadCache::insert(const SupportPoint &sp, const std::optional<Head> &head)
+{
+    m_next_heads.insert_or_assign(key(sp), head);
+}
+
+void PinheadCache::keep(const SupportPoint &sp)
+{
+    auto it = m_heads.find(key(sp));
+    if (it != m_heads.end())
+        m_next_heads.insert_or_assign(it->first, it->second);
+}
+
+void PinheadCache::finish()
+{
+    m_heads.swap(m_next_heads);
+    m_next_heads.clear();
+}
+
+size_t PinheadCache::KeyHash::operator()(const Key &k) const noexcept
+{
+    size_t seed = std::hash<float>{}(k.head_front_radius);
+    for (int i = 0; i < 3; ++i)
+        seed ^= std::hash<float>{}(k.pos(i)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+
+    return seed;
+}
+
 }} // namespace Slic3r::sla
@@ -15,6 +15,8 @@
 #include <stddef.h>
 #include <algorithm>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
@@ -432,6 +434,12 @@ public:
         return m_pillars[size_t(id)];
     }
 
+    // Append all the parts of another tree. The heads of the other tree use
+    // the IDs head_ids[id] in this tree, the IDs of the other parts are
+    // shifted behind the parts already present. The merged mesh of the other
+    // tree is reused if it is up to date.
+    void append(const SupportTreeBuilder &o, const std::vector<unsigned> &head_ids);
+
     // WITHOUT THE PAD!!!
     const indexed_triangle_set &merged_mesh(size_t steps = 45) const;
     
@@ -448,6 +456,61 @@ public:
     }
 };
 
+// Placements of the pinheads calculated by the last support tree build of a
+// SupportableMesh. The placement of a single pinhead only depends on its
+// support point, the mesh, the configuration and the ground level, thus when
+// the user edits a few support points, the heads of the untouched points are
+// taken from the cache instead of running the optimizer again. The result is
+// the same as if all the heads were placed from scratch.
+//
+// The cache belongs to a single mesh, it has to be thrown away with it.
+// find() may be called from multiple threads, the other methods may not.
+class PinheadCache {
+public:
+    // Start a new build: the cached heads are dropped if the configuration
+    // or the ground level differs from the last build.
+    void start(const SupportableMesh &sm);
+
+    // Placement of the head of a support point calculated by the last build,
+    // nullptr if not cached. An empty optional means that the support point
+    // could not hold a head.
+    const std::optional<Head> *find(const SupportPoint &sp) const;
+
+    // Record the placement of the head of a support point in the current build.
+    void insert(const SupportPoint &sp, const std::optional<Head> &head);
+
+    // Keep the cached head of a support point for the next build without
+    // placing it, used for the points of which the whole support is reused.
+    void keep(const SupportPoint &sp);
+
+    // Finish the build: only the heads of the current support points are kept.
+    void finish();
+
+    size_t size() const { return m_heads.size(); }
+
+private:
+    struct Key {
+        Vec3f pos;
+        float head_front_radius;
+
+        bool operator==(const Key &k) const
+        {
+            return pos == k.pos && head_front_radius == k.head_front_radius;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &k) const noexcept;
+    };
+
+    using Heads = std::unordered_map<Key, std::optional<Head>, KeyHash>;
+
+    static Key key(const SupportPoint &sp) { return {sp.pos, sp.head_front_radius}; }
+
+    std::vector<double> m_fingerprint;
+    Heads               m_heads, m_next_heads;
+};
+
 }} // namespace Slic3r::sla
 
 #endif // SUPPORTTREEBUILDER_HPP
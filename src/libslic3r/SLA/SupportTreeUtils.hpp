@@ -146,6 +146,31 @@ struct Beam_ { // Defines a set of rays displaced along a cone's surface
 
 using Beam = Beam_<>;
 
+// Casts num_rays rays on the mesh in packets of AABBMesh::RayPacketSize rays,
+// the packets are distributed among the threads of the execution policy.
+template<class Ex, size_t N>
+void query_ray_hit_packets(Ex                                    policy,
+                           const AABBMesh                       &mesh,
+                           const std::array<Vec3d, N>           &sources,
+                           const std::array<Vec3d, N>           &dirs,
+                           size_t                                num_rays,
+                           std::array<AABBMesh::hit_result, N>  &hits)
+{
+    constexpr size_t PacketSize  = AABBMesh::RayPacketSize;
+    const size_t     num_packets = (num_rays + PacketSize - 1) / PacketSize;
+    if (num_packets == 0)
+        return;
+
+    execution::for_each(
+        policy, size_t(0), num_packets,
+        [&mesh, &sources, &dirs, num_rays, &hits](size_t packet_idx) {
+            size_t begin = packet_idx * AABBMesh::RayPacketSize;
+            mesh.query_ray_hit_batch(sources.data() + begin, dirs.data() + begin,
+                                     std::min(AABBMesh::RayPacketSize, num_rays - begin),
+                                     hits.data() + begin);
+        }, std::min(execution::max_concurrency(policy), num_packets));
+}
+
 template<class Ex, size_t RayCount = Beam::SAMPLES>
 Hit beam_mesh_hit(Ex policy,
                   const AABBMesh &mesh,
@@ -163,32 +188,43 @@ Hit beam_mesh_hit(Ex policy,
 
     using Hit = AABBMesh::hit_result;
 
+    // Points on the circle on the source sphere, the rays start a bit
+    // further in their directions.
+    std::array<Vec3d, RayCount> p_src, sources, raydirs;
+    for (size_t i = 0; i < RayCount; ++i) {
+        p_src[i] = ring.get(i, src, r_src + sd);
+        Vec3d p_dst = ring.get(i, dst, r_dst + sd);
+        raydirs[i] = (p_dst - p_src[i]).normalized();
+        sources[i] = p_src[i] + r_src * raydirs[i];
+    }
+
     // Hit results
     std::array<Hit, RayCount> hits;
+    query_ray_hit_packets(policy, mesh, sources, raydirs, RayCount, hits);
+
+    // Rays hitting the object from the inside are re-cast from the outside
+    // of the object in a second round.
+    std::array<size_t, RayCount> recast_idx;
+    size_t num_recast = 0;
+    for (size_t i = 0; i < RayCount; ++i) {
+        const Hit &hr = hits[i];
+        if (hr.is_inside()) {
+            if (hr.distance() > 2 * r_src + sd)
+                hits[i] = Hit(0.0);
+            else {
+                sources[num_recast] = p_src[i] + (hr.distance() + EPSILON) * raydirs[i];
+                raydirs[num_recast] = raydirs[i];
+                recast_idx[num_recast ++] = i;
+            }
+        }
+    }
 
-    execution::for_each(
-        policy, size_t(0), hits.size(),
-        [&mesh, r_src, r_dst, src, dst, &ring, dir, sd, &hits](size_t i) {
-            Hit &hit = hits[i];
-
-            // Point on the circle on the pin sphere
-            Vec3d p_src = ring.get(i, src, r_src + sd);
-            Vec3d p_dst = ring.get(i, dst, r_dst + sd);
-            Vec3d raydir = (p_dst - p_src).normalized();
-
-            auto hr = mesh.query_ray_hit(p_src + r_src * raydir, raydir);
-
-            if (hr.is_inside()) {
-                if (hr.distance() > 2 * r_src + sd)
-                    hit = Hit(0.0);
-                else {
-                    // re-cast the ray from the outside of the object
-                    auto q = p_src + (hr.distance() + EPSILON) * raydir;
-                    hit = mesh.query_ray_hit(q, raydir);
-                }
-            } else
-                hit = hr;
-        }, std::min(execution::max_concurrency(policy), RayCount));
+    if (num_recast > 0) {
+        std::array<Hit, RayCount> recast_hits;
+        query_ray_hit_packets(policy, mesh, sources, raydirs, num_recast, recast_hits);
+        for (size_t i = 0; i < num_recast; ++i)
+            hits[recast_idx[i]] = recast_hits[i];
+    }
 
     return min_hit(hits.begin(), hits.end());
 }
@@ -233,48 +269,52 @@ Hit pinhead_mesh_hit(Ex              ex,
     // of the pinhead robe (side) surface. The result will be the smallest
     // hit distance.
 
-    execution::for_each(
-        ex, size_t(0), hits.size(), [&m, &rings, sd, &hits](size_t i) {
-            // Point on the circle on the pin sphere
-            Vec3d ps = rings.pinring(i);
-            // This is the point on the circle on the back sphere
-            Vec3d p = rings.backring(i);
-
-            auto &hit = hits[i];
-
-               // Point ps is not on mesh but can be inside or
-               // outside as well. This would cause many problems
-               // with ray-casting. To detect the position we will
-               // use the ray-casting result (which has an is_inside
-               // predicate).
-
-            Vec3d n = (p - ps).normalized();
-            auto  q = m.query_ray_hit(ps + sd * n, n);
-
-            if (q.is_inside()) { // the hit is inside the model
-                if (q.distance() > rings.rpin) {
-                    // If we are inside the model and the hit
-                    // distance is bigger than our pin circle
-                    // diameter, it probably indicates that the
-                    // support point was already inside the
-                    // model, or there is really no space
-                    // around the point. We will assign a zero
-                    // hit distance to these cases which will
-                    // enforce the function return value to be
-                    // an invalid ray with zero hit distance.
-                    // (see min_element at the end)
-                    hit = HitResult(0.0);
-                } else {
-                    // re-cast the ray from the outside of the
-                    // object. The starting point has an offset
-                    // of 2*safety_distance because the
-                    // original ray has also had an offset
-                    auto q2 = m.query_ray_hit(ps + (q.distance() + 2 * sd) * n, n);
-                    hit     = q2;
-                }
-            } else
-                hit = q;
-        }, std::min(execution::max_concurrency(ex), SAMPLES));
+    std::array<Vec3d, SAMPLES> p_pin, sources, dirs;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        // Point on the circle on the pin sphere
+        p_pin[i] = rings.pinring(i);
+        // This is the point on the circle on the back sphere
+        Vec3d p = rings.backring(i);
+        dirs[i] = (p - p_pin[i]).normalized();
+        sources[i] = p_pin[i] + sd * dirs[i];
+    }
+
+    // Point ps is not on mesh but can be inside or outside as well. This
+    // would cause many problems with ray-casting. To detect the position we
+    // will use the ray-casting result (which has an is_inside predicate).
+    query_ray_hit_packets(ex, m, sources, dirs, SAMPLES, hits);
+
+    std::array<size_t, SAMPLES> recast_idx;
+    size_t num_recast = 0;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        const HitResult &q = hits[i];
+        if (q.is_inside()) { // the hit is inside the model
+            if (q.distance() > rings.rpin) {
+                // If we are inside the model and the hit distance is bigger
+                // than our pin circle diameter, it probably indicates that the
+                // support point was already inside the model, or there is
+                // really no space around the point. We will assign a zero hit
+                // distance to these cases which will enforce the function
+                // return value to be an invalid ray with zero hit distance.
+                // (see min_element at the end)
+                hits[i] = HitResult(0.0);
+            } else {
+                // re-cast the ray from the outside of the object. The
+                // starting point has an offset of 2*safety_distance because
+                // the original ray has also had an offset
+                sources[num_recast] = p_pin[i] + (q.distance() + 2 * sd) * dirs[i];
+                dirs[num_recast] = dirs[i];
+                recast_idx[num_recast ++] = i;
+            }
+        }
+    }
+
+    if (num_recast > 0) {
+        std::array<HitResult, SAMPLES> recast_hits;
+        query_ray_hit_packets(ex, m, sources, dirs, num_recast, recast_hits);
+        for (size_t i = 0; i < num_recast; ++i)
+            hits[recast_idx[i]] = recast_hits[i];
+    }
 
     return min_hit(hits.begin(), hits.end());
 }
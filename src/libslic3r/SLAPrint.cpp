@@ -706,9 +706,11 @@ std::string SLAPrint::validate(std::vector<std::string>*) const
 
 void SLAPrint::export_print(const std::string &fname, const ThumbnailsList &thumbnails, const std::string &projectname)
 {
-    if (m_archiver)
+    if (m_archiver) {
+        m_archiver->set_export_status([this](int st) { this->set_status(st, _u8L("Exporting layers")); });
+        ScopeGuard reset_status([this]() { m_archiver->set_export_status(nullptr); });
         m_archiver->export_print(fname, *this, thumbnails, projectname);
-    else {
+    } else {
         throw ExportError(format(_u8L("Unknown archive format: %s"), m_printer_config.sla_archive_format.value));
     }
 }
@@ -886,6 +888,7 @@ bool SLAPrint::invalidate_state_by_config_options(const std::vector<t_config_opt
         "display_orientation"sv,
         "sla_archive_format"sv,
         "sla_output_precision"sv,
+        "sla_rasterizer"sv,
         // tilt params
         "delay_before_exposure"sv,
         "delay_after_exposure"sv,
@@ -546,9 +546,28 @@ public:
 
         ExPolygons m_transformed_slices;
 
+        // Hash of m_transformed_slices to quickly tell layers of different geometry apart.
+        size_t m_fingerprint = 0;
+
         template<class Container> void transformed_slices(Container&& c)
         {
             m_transformed_slices = std::forward<Container>(c);
+
+            size_t seed = m_transformed_slices.size();
+            auto hash_polygon = [&seed](const Polygon &poly) {
+                boost::hash_combine(seed, poly.size());
+                for (const Point &pt : poly.points) {
+                    boost::hash_combine(seed, pt.x());
+                    boost::hash_combine(seed, pt.y());
+                }
+            };
+            for (const ExPolygon &expoly : m_transformed_slices) {
+                hash_polygon(expoly.contour);
+                boost::hash_combine(seed, expoly.holes.size());
+                for (const Polygon &hole : expoly.holes)
+                    hash_polygon(hole);
+            }
+            m_fingerprint = seed;
         }
         
         friend class SLAPrint::Steps;
@@ -571,6 +590,13 @@ public:
         const ExPolygons & transformed_slices() const {
             return m_transformed_slices;
         }
+
+        size_t fingerprint() const { return m_fingerprint; }
+
+        // True if both layers would be rasterized into the same image.
+        bool same_geometry(const PrintLayer &other) const {
+            return m_fingerprint == other.m_fingerprint && m_transformed_slices == other.m_transformed_slices;
+        }
     };
 
     // The aggregated and leveled print records from various objects.
@@ -49,10 +49,12 @@
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/PrintBase.hpp"
 #include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/SLA/DefaultSupportTree.hpp"
 #include "libslic3r/SLA/Hollowing.hpp"
 #include "libslic3r/SLA/JobController.hpp"
 #include "libslic3r/SLA/RasterBase.hpp"
 #include "libslic3r/SLA/SupportTree.hpp"
+#include "libslic3r/SLA/SupportTreeBuilder.hpp"
 #include "libslic3r/SLA/SupportTreeStrategies.hpp"
 #include "libslic3r/SLA/SupportIslands/SampleConfigFactory.hpp"
 #include "libslic3r/SLAPrint.hpp"
@@ -106,6 +108,10 @@ std::string PRINT_STEP_LABELS(size_t idx)
     assert(false); return "Out of bounds!";
 }
 
+// Edge length in mm of the tiles the hollowed interior is generated in. With
+// tiling, the peak memory depends on the tile size instead of the model size.
+constexpr double HollowingTileSize = 50.;
+
 using namespace sla;
 
 /// <summary>
@@ -265,13 +271,16 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
 
     bool handled   = false;
 
+    // Shared by the checks and the booleans to convert each part only once
+    csg::CGALMeshCache cgalcache;
+
     if (is_all_positive(r)) {
         m = csgmesh_merge_positive_parts(r);
         handled = true;
-    } else if (csg::check_csgmesh_booleans(r) == r.end()) {
+    } else if (csg::check_csgmesh_booleans(r, cgalcache) == r.end()) {
         MeshBoolean::cgal::CGALMeshPtr cgalmeshptr;
         try {
-            cgalmeshptr = csg::perform_csgmesh_booleans(r);
+            cgalmeshptr = csg::perform_csgmesh_booleans(r, cgalcache);
         } catch (...) {
             // leaves cgalmeshptr as nullptr
         }
@@ -439,6 +448,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     double quality  = po.m_config.hollowing_quality.getFloat();
     double closing_d = po.m_config.hollowing_closing_distance.getFloat();
     sla::HollowingConfig hlwcfg{thickness, quality, closing_d};
+    hlwcfg.tile_size = HollowingTileSize;
     sla::JobController ctl;
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
@@ -860,6 +870,14 @@ void SLAPrint::Steps::support_tree(SLAPrintObject &po)
     po.m_supportdata->input.cfg = make_support_cfg(po.m_config);
     po.m_supportdata->input.pad_cfg = make_pad_cfg(po.m_config);
 
+    // The support data lives as long as the mesh does, the heads and the
+    // default subtrees of the support points not touched since the last run
+    // are reused from the caches.
+    if (!po.m_supportdata->input.pinhead_cache)
+        po.m_supportdata->input.pinhead_cache = std::make_shared<sla::PinheadCache>();
+    if (!po.m_supportdata->input.subtree_cache)
+        po.m_supportdata->input.subtree_cache = std::make_shared<sla::SupportSubtreeCache>();
+
     // scaling for the sub operations
     double d = objectstep_scale * OBJ_STEP_LEVELS[slaposSupportTree] / 100.0;
     double init = current_status();
@@ -1458,6 +1476,38 @@ void SLAPrint::Steps::rasterize()
 {
     if(canceled() || !m_print->m_archiver) return;
 
+    // Layers of the same geometry as the layer below (pads, prismatic bases) are not
+    // rasterized again, the image of the layer below is reused.
+    const std::vector<PrintLayer> &printer_input = m_print->m_printer_input;
+    std::vector<uint8_t> duplicate(printer_input.size(), false);
+    execution::for_each(ex_tbb, size_t(0), printer_input.size(), [&printer_input, &duplicate](size_t idx) {
+        duplicate[idx] = idx > 0 && printer_input[idx].same_geometry(printer_input[idx - 1]);
+    }, execution::max_concurrency(ex_tbb));
+    auto same_as_previous = [&duplicate](size_t idx) { return duplicate[idx] != 0; };
+
+    size_t num_duplicates = std::count(duplicate.begin(), duplicate.end(), uint8_t(true));
+    BOOST_LOG_TRIVIAL(debug) << "SLA rasterization: " << num_duplicates << " of " << printer_input.size()
+                             << " layers reuse the image of the layer below";
+
+    if (m_print->m_archiver->rasterizes_on_export()) {
+        // The archive is written sequentially, thus the layers are rasterized only while exporting,
+        // streaming the encoded layers into the archive instead of holding all of them in memory.
+        // The export may run after the print was invalidated, thus the slices are copied. The slices of
+        // the duplicate layers are not drawn.
+        auto slices = std::make_shared<std::vector<ExPolygons>>(printer_input.size());
+        execution::for_each(ex_tbb, size_t(0), printer_input.size(), [&printer_input, &duplicate, &slices](size_t idx) {
+            if (! duplicate[idx])
+                (*slices)[idx] = printer_input[idx].transformed_slices();
+        }, execution::max_concurrency(ex_tbb));
+        throw_if_canceled();
+
+        m_print->m_archiver->set_layer_drawer(slices->size(),
+            [slices](sla::RasterBase &raster, size_t idx) {
+                raster.draw((*slices)[idx]);
+            }, same_as_previous);
+        return;
+    }
+
     // coefficient to map the rasterization state (0-99) to the allocated
     // portion (slot) of the process state
     double sd = (100 - max_objstatus) / 100.0;
@@ -1468,7 +1518,7 @@ void SLAPrint::Steps::rasterize()
     // pst: previous state
     double pst = current_status();
 
-    double increment = (slot * sd) / m_print->m_printer_input.size();
+    double increment = (slot * sd) / std::max<size_t>(1, printer_input.size() - num_duplicates);
     double dstatus = current_status();
 
     execution::SpinningMutex<ExecutionTBB> slck;
@@ -1481,8 +1531,7 @@ void SLAPrint::Steps::rasterize()
         PrintLayer& printlayer = m_print->m_printer_input[idx];
         if(canceled()) return;
 
-        for (const ExPolygon& poly : printlayer.transformed_slices())
-            raster.draw(poly);
+        raster.draw(printlayer.transformed_slices());
 
         // Status indication guarded with the spinlock
         {
@@ -1500,7 +1549,7 @@ void SLAPrint::Steps::rasterize()
     if(canceled()) return;
 
     // Print all the layers in parallel
-    m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
+    m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn, same_as_previous,
                                     [this]() { return canceled(); }, ex_tbb);
 }
 
@@ -745,8 +745,11 @@ static void organic_smooth_branches_avoid_collisions(
 
     throw_on_cancel();
 
+    // With the distance field backend, the collisions are sampled from the distance fields cached by TreeModelVolumes,
+    // thus only the layer span is needed from layer_collision_cache.
+    const bool use_distance_field = config.settings.collision_backend == CollisionBackend::DistanceField;
     for (LayerIndex layer_idx = 0; layer_idx < LayerIndex(layer_collision_cache.size()); ++layer_idx)
-        if (LayerCollisionCache& l = layer_collision_cache[layer_idx]; !l.min_element_radius_known())
+        if (LayerCollisionCache& l = layer_collision_cache[layer_idx]; !l.min_element_radius_known() || use_distance_field)
             l.min_element_radius = 0;
         else {
             //FIXME
@@ -844,7 +847,7 @@ static void organic_smooth_branches_avoid_collisions(
             collision_sphere.prev_position = collision_sphere.position;
         std::atomic<size_t> num_moved{ 0 };
         tbb::parallel_for(tbb::blocked_range<size_t>(0, collision_spheres.size()),
-            [&collision_spheres, &layer_collision_cache, &slicing_params, &config, &linear_data_layers, &num_moved, &throw_on_cancel](const tbb::blocked_range<size_t> range) {
+            [&collision_spheres, &layer_collision_cache, &volumes, use_distance_field, &slicing_params, &config, &linear_data_layers, &num_moved, &throw_on_cancel](const tbb::blocked_range<size_t> range) {
             for (size_t collision_sphere_id = range.begin(); collision_sphere_id < range.end(); ++ collision_sphere_id)
                 if (CollisionSphere &collision_sphere = collision_spheres[collision_sphere_id]; ! collision_sphere.locked) {
                     // Calculate collision of multiple 2D layers against a collision sphere.
@@ -852,7 +855,20 @@ static void organic_smooth_branches_avoid_collisions(
                     for (uint32_t layer_id = collision_sphere.layer_begin; layer_id != collision_sphere.layer_end; ++ layer_id) {
                         double dz = (layer_id - collision_sphere.element.state.layer_idx) * slicing_params.layer_height;
                         if (double r2 = sqr(collision_sphere.radius) - sqr(dz); r2 > 0) {
-                            if (const LayerCollisionCache &layer_collision_cache_item = layer_collision_cache[layer_id]; ! layer_collision_cache_item.empty()) {
+                            if (use_distance_field) {
+                                Vec2d  gradient;
+                                if (double dist = unscaled<double>(volumes.getCollisionSignedDistance(LayerIndex(layer_id), scaled<coord_t>(to_2d(collision_sphere.position)), &gradient)); 
+                                    dist < sqrt(r2)) {
+                                    double collision_depth = sqrt(r2) - dist;
+                                    if (collision_depth > collision_sphere.last_collision_depth && gradient != Vec2d::Zero()) {
+                                        collision_sphere.last_collision_depth = collision_depth;
+                                        // Approximate closest point on the collision boundary. For a center inside the collision, the point is mirrored
+                                        // so that the nudge below points along the gradient, out of the collision.
+                                        Vec2d closest = to_2d(collision_sphere.position).cast<double>() - gradient * std::max(std::abs(dist), EPSILON);
+                                        collision_sphere.last_collision = to_3d(closest.cast<float>(), float(layer_z(slicing_params, config, layer_id)));
+                                    }
+                                }
+                            } else if (const LayerCollisionCache &layer_collision_cache_item = layer_collision_cache[layer_id]; ! layer_collision_cache_item.empty()) {
                                 size_t hit_idx_out;
                                 Vec2d  hit_point_out;
                                 if (double dist = sqrt(AABBTreeLines::squared_distance_to_indexed_lines(
@@ -111,6 +111,7 @@ TreeModelVolumes::TreeModelVolumes(
         assert(m_current_min_xy_dist_delta >= 0);
         m_increase_until_radius = config.increase_radius_until_radius;
         m_radius_0 = config.getRadius(0);
+        m_use_distance_field = mesh_settings.collision_backend == CollisionBackend::DistanceField;
         m_raft_layers = config.raft_layers;
         m_current_outline_idx = 0;
 
@@ -320,6 +321,81 @@ std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> TreeMo
     return m_collision_cache.get_lower_bound_area({ max_radius, layer_id });
 }
 
+// Exact distance to the edges close to the contour, interpolated from the distance field further away.
+static double sample_signed_distance(const EdgeGrid::Grid &grid, const Point &pt)
+{
+    coordf_t dist;
+    if (! grid.signed_distance(pt, grid.resolution(), dist))
+        dist = grid.signed_distance_bilinear(pt);
+    return dist;
+}
+
+double TreeModelVolumes::getCollisionSignedDistance(LayerIndex layer_idx, const Point &pt, Vec2d *gradient_out) const
+{
+    const EdgeGrid::Grid *grid = m_collision_distance_field_cache.get({ 0, layer_idx }, [this, layer_idx]() -> const Polygons& { return this->getCollision(0, layer_idx, true); });
+    if (grid == nullptr)
+        return std::numeric_limits<double>::max();
+    const double dist = sample_signed_distance(*grid, pt);
+    if (gradient_out) {
+        const coord_t h = grid->resolution() / 2;
+        Vec2d grad(
+            grid->signed_distance_bilinear(pt + Point(h, 0)) - grid->signed_distance_bilinear(pt - Point(h, 0)),
+            grid->signed_distance_bilinear(pt + Point(0, h)) - grid->signed_distance_bilinear(pt - Point(0, h)));
+        double l = grad.norm();
+        *gradient_out = l > EPSILON ? Vec2d(grad / l) : Vec2d::Zero();
+    }
+    return dist;
+}
+
+bool TreeModelVolumes::isInsideCollision(const coord_t radius, LayerIndex layer_idx, bool min_xy_dist, const Point &pt) const
+{
+    if (! m_use_distance_field)
+        return contains(this->getCollision(radius, layer_idx, min_xy_dist), pt);
+    // The collision of a radius is the collision of radius zero offset by the radius, see calculateCollision().
+    return this->collides(layer_idx, pt, this->ceilRadius(radius, min_xy_dist));
+}
+
+bool TreeModelVolumes::isInsideAvoidance(const coord_t orig_radius, LayerIndex layer_idx, AvoidanceType type, bool to_model, bool min_xy_dist, const Point &pt) const
+{
+    if (! m_use_distance_field)
+        return contains(this->getAvoidance(orig_radius, layer_idx, type, to_model, min_xy_dist), pt);
+    if (layer_idx == 0)
+        // Same as getAvoidance().
+        return this->isInsideCollision(orig_radius, layer_idx, min_xy_dist, pt);
+    // The avoidance is propagated from the collisions of all the layers below, it is not an offset of a single area,
+    // thus a distance field is built for each avoidance area queried.
+    const coord_t radius = this->ceilRadius(orig_radius, min_xy_dist);
+    const EdgeGrid::Grid *grid = m_avoidance_distance_field_caches[avoidance_distance_field_cache_idx(type, to_model)].get({ radius, layer_idx }, 
+        [this, orig_radius, layer_idx, type, to_model, min_xy_dist]() -> const Polygons& { return this->getAvoidance(orig_radius, layer_idx, type, to_model, min_xy_dist); });
+    return grid != nullptr && sample_signed_distance(*grid, pt) < 0;
+}
+
+const EdgeGrid::Grid* TreeModelVolumes::RadiusLayerDistanceFieldCache::get(const RadiusLayerPair &key, const std::function<const Polygons&()> &area)
+{
+    assert(key.first >= 0 && key.second >= 0);
+    Data *data;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        std::unique_ptr<Data> &slot = m_data[key];
+        if (! slot)
+            slot = std::make_unique<Data>();
+        data = slot.get();
+    }
+    std::call_once(data->initialized, [data, &area]() {
+        const Polygons &polygons = area();
+        if (polygons.empty())
+            return;
+        BoundingBox bbox = get_extents(polygons);
+        bbox.offset(SUPPORT_TREE_COLLISION_RESOLUTION);
+        bbox.align_to_grid(SUPPORT_TREE_COLLISION_RESOLUTION);
+        data->grid = std::make_unique<EdgeGrid::Grid>();
+        data->grid->set_bbox(bbox);
+        data->grid->create(polygons, SUPPORT_TREE_COLLISION_RESOLUTION);
+        data->grid->calculate_sdf();
+    });
+    return data->grid.get();
+}
+
 // Private. Only called internally by calculateAvoidance() and calculateAvoidanceToModel(), radius is already snapped to grid.
 const Polygons& TreeModelVolumes::getCollisionHolefree(coord_t radius, LayerIndex layer_idx) const
 {
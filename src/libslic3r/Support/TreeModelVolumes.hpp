@@ -19,8 +19,10 @@
 #include <stdint.h>
 #include <mutex>
 #include <unordered_map>
+#include <array>
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -29,6 +31,7 @@
 #include <cstddef>
 
 #include "TreeSupportCommon.hpp"
+#include "../EdgeGrid.hpp"
 #include "../Point.hpp"
 #include "../Polygon.hpp"
 #include "../PrintConfig.hpp"
@@ -68,6 +71,7 @@ public:
     void clear() { 
         this->clear_all_but_object_collision();
         m_collision_cache.clear();
+        m_collision_distance_field_cache.clear();
         m_placeable_areas_cache.clear();
     }
     void clear_all_but_object_collision() { 
@@ -82,6 +86,8 @@ public:
         m_avoidance_cache_holefree_to_model.clear();
         m_wall_restrictions_cache.clear();
         m_wall_restrictions_cache_min.clear();
+        for (RadiusLayerDistanceFieldCache &cache : m_avoidance_distance_field_caches)
+            cache.clear();
     }
 
     enum class AvoidanceType : int8_t
@@ -118,6 +124,40 @@ public:
     // Used for pushing tree supports away from object during the final Organic optimization step.
     std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_collision_lower_bound_area(LayerIndex layer_id, coord_t max_radius) const;
 
+    /*!
+     * \brief Provides the signed distance of a point to the collision area of radius zero (minimum xy distance) at a given layer.
+     *
+     * Answered by sampling a signed distance field, which is built lazily once per layer and shared by all radii,
+     * so that no collision polygons are offset and cached per radius. A node of radius r collides with the model
+     * at a point if the returned distance is lower than r.
+     *
+     * \param layer_idx The layer of interest
+     * \param pt The point of interest
+     * \param gradient_out If not null, receives the normalized gradient of the distance field at pt, pointing away from the collision.
+     * \return Signed distance, negative inside the collision area, std::numeric_limits<double>::max() if there is no collision at this layer.
+     */
+    double getCollisionSignedDistance(LayerIndex layer_idx, const Point &pt, Vec2d *gradient_out = nullptr) const;
+    /*!
+     * \brief Does a node of a given radius placed at a point collide with the model? Sampled from the signed distance field, see getCollisionSignedDistance().
+     */
+    bool collides(LayerIndex layer_idx, const Point &pt, coord_t radius) const 
+        { return this->getCollisionSignedDistance(layer_idx, pt) < double(radius); }
+    /*!
+     * \brief Is a point inside the collision area returned by getCollision() for the same parameters?
+     *
+     * With the distance field collision backend, the point is sampled from the distance field of the collision of radius zero,
+     * see collides(), thus no collision polygons of the given radius are calculated. Otherwise the point is tested against the cached polygons.
+     */
+    bool isInsideCollision(coord_t radius, LayerIndex layer_idx, bool min_xy_dist, const Point &pt) const;
+
+    /*!
+     * \brief Is a point inside the avoidance area returned by getAvoidance() for the same parameters?
+     *
+     * With the distance field collision backend, the point is sampled from a distance field of the avoidance area,
+     * which is built on the first query of the radius and layer. Otherwise the point is tested against the cached polygons.
+     */
+    bool isInsideAvoidance(coord_t radius, LayerIndex layer_idx, AvoidanceType type, bool to_model, bool min_xy_dist, const Point &pt) const;
+
     /*!
      * \brief Provides the areas that have to be avoided by the tree's branches
      * in order to reach the build plate.
@@ -323,6 +363,31 @@ private:
     };
 
 
+    // Signed distance fields of collision or avoidance areas, built lazily on the first query of a radius and layer.
+    class RadiusLayerDistanceFieldCache {
+    public:
+        RadiusLayerDistanceFieldCache() = default;
+        RadiusLayerDistanceFieldCache(RadiusLayerDistanceFieldCache &&rhs) : m_data(std::move(rhs.m_data)) {}
+        RadiusLayerDistanceFieldCache& operator=(RadiusLayerDistanceFieldCache &&rhs) { m_data = std::move(rhs.m_data); return *this; }
+
+        RadiusLayerDistanceFieldCache(const RadiusLayerDistanceFieldCache&) = delete;
+        RadiusLayerDistanceFieldCache& operator=(const RadiusLayerDistanceFieldCache&) = delete;
+
+        // Returns the distance field of a radius and layer, building it from area() if it was not requested yet.
+        // Returns nullptr if the area is empty. Thread safe, the distance field is only built once.
+        const EdgeGrid::Grid* get(const RadiusLayerPair &key, const std::function<const Polygons&()> &area);
+        void clear() { m_data.clear(); }
+
+    private:
+        struct Data {
+            std::once_flag                  initialized;
+            std::unique_ptr<EdgeGrid::Grid> grid;
+        };
+        // Pointers to Data are stable, so that the distance field may be built outside of the lock.
+        std::map<RadiusLayerPair, std::unique_ptr<Data>> m_data;
+        std::mutex                                       m_mutex;
+    };
+
     /*!
      * \brief Provides the areas that have to be avoided by the tree's branches to prevent collision with the model on this layer. Holes are removed.
      *
@@ -462,6 +527,10 @@ private:
      * \brief Does at least one mesh allow support to rest on a model.
      */
     bool m_support_rests_on_model;
+    /*!
+     * \brief Are the point queries answered by sampling distance fields instead of the cached polygons.
+     */
+    bool m_use_distance_field { false };
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     /*!
      * \brief The progress of the precalculate function for communicating it to the progress bar.
@@ -520,6 +589,11 @@ private:
     RadiusLayerPolygonCache     m_avoidance_cache_to_model;
     RadiusLayerPolygonCache     m_avoidance_cache_to_model_slow;
     RadiusLayerPolygonCache     m_placeable_areas_cache;
+    // Signed distance fields of m_collision_cache at radius zero, for sampling collisions of any radius.
+    mutable RadiusLayerDistanceFieldCache m_collision_distance_field_cache;
+    // Signed distance fields of the avoidance caches, indexed by avoidance_distance_field_cache_idx().
+    mutable std::array<RadiusLayerDistanceFieldCache, size_t(AvoidanceType::Count) * 2> m_avoidance_distance_field_caches;
+    static size_t avoidance_distance_field_cache_idx(const AvoidanceType type, const bool to_model) { return size_t(type) * 2 + size_t(to_model); }
 
     /*!
      * \brief Caches to avoid holes smaller than the radius until which the radius is always increased, as they are free of holes. 
@@ -58,6 +58,15 @@ enum class InterfacePreference
     Nothing
 };
 
+// How the final Organic smoothing step queries collisions of the branches with the object.
+enum class CollisionBackend
+{
+    // AABB tree over the lines of the collision polygons, built per layer.
+    PolygonCache,
+    // Signed distance field of the collision area built once per layer, sampled for any branch radius.
+    DistanceField
+};
+
 struct TreeSupportMeshGroupSettings {
     TreeSupportMeshGroupSettings() = default;
     explicit TreeSupportMeshGroupSettings(const PrintObject &print_object);
@@ -221,6 +230,9 @@ struct TreeSupportMeshGroupSettings {
     // minimum: min_wall_line_width, minimum warning: min_wall_line_width+0.05, maximum_value: support_tree_branch_diameter, value: support_line_width
     coord_t                         support_tree_tip_diameter               { scaled<coord_t>(0.4) };
 
+    // Not a Cura setting: Backend used to query collisions of the Organic branches with the object.
+    CollisionBackend                collision_backend                       { CollisionBackend::PolygonCache };
+
     // Support Interface Priority
     // How support interface and support will interact when they overlap. Currently only implemented for support roof.
     //enum                           support_interface_priority { support_lines_overwrite_interface_area };
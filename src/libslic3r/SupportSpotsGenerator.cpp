@@ -9,6 +9,7 @@
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/task_group.h>
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -939,7 +940,7 @@ std::vector<EnitityToCheck> gather_entities_to_check(const Layer* layer) {
 
 LocalSupports compute_local_supports(
     const std::vector<EnitityToCheck>& entities_to_check,
-    const std::optional<Linesf>& previous_layer_boundary,
+    const AABBTreeLines::LinesDistancer<Linef>& prev_layer_boundary_distancer,
     const LD& prev_layer_ext_perim_lines,
     size_t slices_count,
     const Params& params
@@ -947,9 +948,6 @@ LocalSupports compute_local_supports(
     std::vector<tbb::concurrent_vector<ExtrusionLine>> unstable_lines_per_slice(slices_count);
     std::vector<tbb::concurrent_vector<ExtrusionLine>> ext_perim_lines_per_slice(slices_count);
 
-    AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary_distancer =
-        (previous_layer_boundary ? AABBTreeLines::LinesDistancer<Linef>{*previous_layer_boundary} : AABBTreeLines::LinesDistancer<Linef>{});
-
     if constexpr (debug_files) {
         for (const auto &e_to_check : entities_to_check) {
             for (const auto &line : check_extrusion_entity_stability(e_to_check.e, e_to_check.region, prev_layer_ext_perim_lines,
@@ -1132,27 +1130,40 @@ std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject
     SupportGridFilter supports_presence_grid(po, params.min_distance_between_support_points);
     ActiveObjectParts active_object_parts{};
     PartialObjects    partial_objects{};
-    LD                prev_layer_ext_perim_lines;
 
     SliceMappings slice_mappings;
 
+    // The local checks of extrusions of a layer (curling, overhangs) only depend on the external perimeters of the layer below
+    // as estimated by the local checks of that layer, while the stability of the object parts depends on all the layers below.
+    // Thus the local checks of the next layer run concurrently with the stability propagation through the current layer.
+    const auto compute_layer_local_supports = [po, &params](size_t layer_idx, const LD &prev_layer_ext_perim_lines) {
+        const Layer                                *layer = po->get_layer(layer_idx);
+        const AABBTreeLines::LinesDistancer<Linef>  no_prev_layer_boundary;
+        const AABBTreeLines::LinesDistancer<Linef> &prev_layer_boundary = layer->lower_layer != nullptr ?
+                                                                              layer->lower_layer->lslices_distancer() :
+                                                                              no_prev_layer_boundary;
+        return compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params);
+    };
 
+    LocalSupports local_supports = po->layer_count() > 0 ? compute_layer_local_supports(0, LD{}) : LocalSupports{};
     for (size_t layer_idx = 0; layer_idx < po->layer_count(); ++layer_idx) {
         cancel_func();
         const Layer *layer                 = po->get_layer(layer_idx);
         float        bottom_z              = layer->bottom_z();
 
-        slice_mappings = update_active_object_parts(layer, params, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
-
-        std::optional<Linesf> prev_layer_boundary = layer->lower_layer != nullptr ?
-                                                        std::optional{to_unscaled_linesf(layer->lower_layer->lslices)} :
-                                                        std::nullopt;
+        LocalSupports    next_local_supports;
+        tbb::task_group  next_local_supports_task;
+        if (layer_idx + 1 < po->layer_count()) {
+            next_local_supports_task.run([layer_idx, &local_supports, &next_local_supports, &compute_layer_local_supports]() {
+                std::vector<ExtrusionLine> current_layer_ext_perims_lines{};
+                for (const tbb::concurrent_vector<ExtrusionLine> &external_perimeter_lines : local_supports.ext_perim_lines_per_slice)
+                    current_layer_ext_perims_lines.insert(current_layer_ext_perims_lines.end(), external_perimeter_lines.begin(), external_perimeter_lines.end());
+                next_local_supports = compute_layer_local_supports(layer_idx + 1, LD(current_layer_ext_perims_lines));
+            });
+        }
 
-        LocalSupports local_supports{
-            compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
+        slice_mappings = update_active_object_parts(layer, params, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
 
-        std::vector<ExtrusionLine> current_layer_ext_perims_lines{};
-        current_layer_ext_perims_lines.reserve(prev_layer_ext_perim_lines.get_lines().size());
         // All object parts updated, and for each slice we have coresponding weakest connection.
         // We can now check each slice and its corresponding weakest connection and object part for stability.
         for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
@@ -1172,10 +1183,10 @@ std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject
             if (layer_idx > 1) {
                 reckon_global_supports(external_perimeter_lines, bottom_z, params, part, weakest_conn, supp_points, supports_presence_grid);
             }
-
-            current_layer_ext_perims_lines.insert(current_layer_ext_perims_lines.end(), external_perimeter_lines.begin(), external_perimeter_lines.end());
         } // slice iterations
-        prev_layer_ext_perim_lines = LD(current_layer_ext_perims_lines);
+
+        next_local_supports_task.wait();
+        local_supports = std::move(next_local_supports);
     } // layer iterations
 
     for (const auto& active_obj_pair : slice_mappings.index_to_object_part_mapping) {
@@ -1325,8 +1336,9 @@ void estimate_malformations(LayerPtrs &layers, const Params &params)
 
     for (Layer *l : layers) {
         l->curled_lines.clear();
-        std::vector<Linef> boundary_lines = l->lower_layer != nullptr ? to_unscaled_linesf(l->lower_layer->lslices) : std::vector<Linef>();
-        AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary{std::move(boundary_lines)};
+        const AABBTreeLines::LinesDistancer<Linef> no_prev_layer_boundary;
+        const AABBTreeLines::LinesDistancer<Linef> &prev_layer_boundary = l->lower_layer != nullptr ? l->lower_layer->lslices_distancer() :
+                                                                                                     no_prev_layer_boundary;
         std::vector<ExtrusionLine>           current_layer_lines;
         for (const LayerRegion *layer_region : l->regions()) {
             for (const ExtrusionEntity *extrusion : layer_region->perimeters().flatten().entities) {
@@ -26,6 +26,7 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_sort.h>
 #include <cmath>
 #include <vector>
 #include <utility>
@@ -67,7 +68,7 @@ static void fill_initial_stats(const indexed_triangle_set &its, TriangleMeshStat
     out.volume              = its_volume(its);
     update_bounding_box(its, out);
 
-    const std::vector<Vec3i> face_neighbors = its_face_neighbors(its);
+    const std::vector<Vec3i> face_neighbors = its_face_neighbors_par(its);
     out.number_of_parts = its_number_of_patches(its, face_neighbors);
     out.open_edges      = its_num_open_edges(face_neighbors);
 }
@@ -215,37 +216,63 @@ void TriangleMesh::from_facets(std::vector<stl_facet> &&facets, bool repair)
     fill_initial_stats(this->its, this->m_stats);
 }
 
-bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair)
-{ 
-    stl_file stl;
-    if (! stl_open(&stl, input_file))
-        return false;
+// Repair the facets loaded by admesh and index them, filling the statistics including the repaired errors.
+static void trianglemesh_from_stl(stl_file &stl, bool repair, indexed_triangle_set &its, TriangleMeshStats &stats)
+{
     if (repair)
         trianglemesh_repair_on_import(stl);
 
-    m_stats.number_of_facets        = stl.stats.number_of_facets;
-    m_stats.min                     = stl.stats.min;
-    m_stats.max                     = stl.stats.max;
-    m_stats.size                    = stl.stats.size;
-    m_stats.volume                  = stl.stats.volume;
+    stats.number_of_facets        = stl.stats.number_of_facets;
+    stats.min                     = stl.stats.min;
+    stats.max                     = stl.stats.max;
+    stats.size                    = stl.stats.size;
+    stats.volume                  = stl.stats.volume;
 
     auto facets_w_1_bad_edge = stl.stats.connected_facets_2_edge - stl.stats.connected_facets_3_edge;
     auto facets_w_2_bad_edge = stl.stats.connected_facets_1_edge - stl.stats.connected_facets_2_edge;
     auto facets_w_3_bad_edge = stl.stats.number_of_facets - stl.stats.connected_facets_1_edge;
-    m_stats.open_edges              = stl.stats.backwards_edges + facets_w_1_bad_edge + facets_w_2_bad_edge * 2 + facets_w_3_bad_edge * 3;
+    stats.open_edges              = stl.stats.backwards_edges + facets_w_1_bad_edge + facets_w_2_bad_edge * 2 + facets_w_3_bad_edge * 3;
 
-    m_stats.repaired_errors = { stl.stats.edges_fixed,
-                                stl.stats.degenerate_facets,
-                                stl.stats.facets_removed,
-                                stl.stats.facets_reversed,
-                                stl.stats.backwards_edges };
+    stats.repaired_errors = { stl.stats.edges_fixed,
+                              stl.stats.degenerate_facets,
+                              stl.stats.facets_removed,
+                              stl.stats.facets_reversed,
+                              stl.stats.backwards_edges };
 
-    m_stats.number_of_parts         = stl.stats.number_of_parts;
+    stats.number_of_parts         = stl.stats.number_of_parts;
 
-    stl_generate_shared_vertices(&stl, this->its);
+    stl_generate_shared_vertices(&stl, its);
+}
+
+bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair)
+{ 
+    stl_file stl;
+    if (! stl_open(&stl, input_file))
+        return false;
+    trianglemesh_from_stl(stl, repair, this->its, m_stats);
     return true;
 }
 
+void TriangleMesh::from_stl_facets(std::vector<stl_facet> &&facets, bool repair)
+{
+    stl_file stl;
+    stl.stats.type                = inmemory;
+    stl.stats.number_of_facets    = uint32_t(facets.size());
+    stl.stats.original_num_facets = int(stl.stats.number_of_facets);
+
+    stl_allocate(&stl);
+    stl.facet_start               = std::move(facets);
+
+    // The bounding box and the shortest edge are used by the repair, collect them as stl_open() does.
+    bool first = true;
+    for (const stl_facet &facet : stl.facet_start)
+        stl_facet_stats(&stl, facet, first);
+    stl.stats.size              = stl.stats.max - stl.stats.min;
+    stl.stats.bounding_diameter = stl.stats.size.norm();
+
+    trianglemesh_from_stl(stl, repair, this->its, m_stats);
+}
+
 bool TriangleMesh::write_ascii(const char* output_file)
 { 
     return its_write_stl_ascii(output_file, "", this->its);
@@ -725,7 +752,7 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
     auto sorted = reserve_vector<int>(its.vertices.size());
     for (int i = 0; i < int(its.vertices.size()); ++ i)
         sorted.emplace_back(i);
-    std::sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
+    tbb::parallel_sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
         const Vec3f &l = its.vertices[il];
         const Vec3f &r = its.vertices[ir];
         // Sort lexicographically by coordinates AND vertex index.
@@ -734,21 +761,25 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
 
     // 2) Map duplicate vertices to the one with the lowest vertex index.
     // The vertex to stay will have a map_vertices[...] == -1 index assigned, the other vertices will point to it.
+    // Each run of duplicate vertices is processed by the thread owning its first vertex.
     std::vector<int> map_vertices(its.vertices.size(), -1);
-    for (int i = 0; i < int(sorted.size());) {
-        const int    u = sorted[i];
-        const Vec3f &p = its.vertices[u];
-        int j = i;
-        for (++ j; j < int(sorted.size()); ++ j) {
-            const int    v = sorted[j];
-            const Vec3f &q = its.vertices[v];
-            if (p != q)
-                break;
-            assert(v > u);
-            map_vertices[v] = u;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, sorted.size()), [&its, &sorted, &map_vertices](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const int    u = sorted[i];
+            const Vec3f &p = its.vertices[u];
+            if (i > 0 && its.vertices[sorted[i - 1]] == p)
+                // Not the first vertex of a run of duplicates.
+                continue;
+            for (size_t j = i + 1; j < sorted.size(); ++ j) {
+                const int    v = sorted[j];
+                const Vec3f &q = its.vertices[v];
+                if (p != q)
+                    break;
+                assert(v > u);
+                map_vertices[v] = u;
+            }
         }
-        i = j;
-    }
+    });
 
     // 3) Shrink its.vertices, update map_vertices with the new vertex indices.
     int k = 0;
@@ -770,9 +801,11 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
         // Shrink the vertices.
         its.vertices.erase(its.vertices.begin() + k, its.vertices.end());
         // Remap face indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = map_vertices[face(i)];
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()), [&its, &map_vertices](const tbb::blocked_range<size_t> &range) {
+            for (size_t face_idx = range.begin(); face_idx < range.end(); ++ face_idx)
+                for (int i = 0; i < 3; ++ i)
+                    its.indices[face_idx](i) = map_vertices[its.indices[face_idx](i)];
+        });
         // Optionally shrink to fit (reallocate) vertices.
         if (shrink_to_fit)
             its.vertices.shrink_to_fit();
@@ -1690,9 +1723,47 @@ std::vector<Vec3i> its_face_neighbors(const indexed_triangle_set &its)
     return create_face_neighbors_index(ex_seq, its);
 }
 
+// Sort based parallel variant of its_face_neighbors(): Half edges are sorted by their vertex indices,
+// the opposite half edge is then found by a binary search. If more than two faces share an edge, the half edges
+// sorted by their face indices are paired with the opposite half edges in the same order, thus the index stays symmetric.
 std::vector<Vec3i> its_face_neighbors_par(const indexed_triangle_set &its)
 {
-    return create_face_neighbors_index(ex_tbb, its);
+    struct HalfEdge {
+        uint64_t key;
+        // face_idx * 3 + edge_idx
+        int      face_edge;
+        bool operator<(const HalfEdge &rhs) const { return this->key < rhs.key || (this->key == rhs.key && this->face_edge < rhs.face_edge); }
+    };
+    auto half_edge_key = [](int a, int b) { return (uint64_t(uint32_t(a)) << 32) | uint64_t(uint32_t(b)); };
+
+    std::vector<HalfEdge> half_edges(its.indices.size() * 3);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()), [&its, &half_edges, &half_edge_key](const tbb::blocked_range<size_t> &range) {
+        for (size_t face_idx = range.begin(); face_idx < range.end(); ++ face_idx)
+            for (int edge_idx = 0; edge_idx < 3; ++ edge_idx) {
+                const Vec2i edge = its_triangle_edge(its.indices[face_idx], edge_idx);
+                half_edges[face_idx * 3 + edge_idx] = { half_edge_key(edge(0), edge(1)), int(face_idx * 3 + edge_idx) };
+            }
+    });
+    tbb::parallel_sort(half_edges.begin(), half_edges.end());
+
+    std::vector<Vec3i> neighbors(its.indices.size(), Vec3i(-1, -1, -1));
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, half_edges.size()), [&half_edges, &neighbors](const tbb::blocked_range<size_t> &range) {
+        auto key_less = [](const HalfEdge &l, uint64_t key) { return l.key < key; };
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const HalfEdge &half_edge = half_edges[i];
+            if ((half_edge.key >> 32) == (half_edge.key & 0xFFFFFFFFull))
+                // Degenerate edge.
+                continue;
+            // Rank of this half edge among the half edges with the same vertices.
+            const size_t    rank      = i - (std::lower_bound(half_edges.begin(), half_edges.begin() + i, half_edge.key, key_less) - half_edges.begin());
+            const uint64_t  opposite  = (half_edge.key << 32) | (half_edge.key >> 32);
+            auto            it        = std::lower_bound(half_edges.begin(), half_edges.end(), opposite, key_less);
+            if (size_t(half_edges.end() - it) > rank && (it + rank)->key == opposite)
+                // Each half edge only writes its own slot, thus no synchronization is needed.
+                neighbors[half_edge.face_edge / 3][half_edge.face_edge % 3] = (it + rank)->face_edge / 3;
+        }
+    });
+    return neighbors;
 }
 
 std::vector<Vec3f> its_face_normals(const indexed_triangle_set &its) 
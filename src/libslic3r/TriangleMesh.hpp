@@ -142,6 +142,8 @@ public:
     void clear() { this->its.clear(); m_stats.clear(); }
     void from_facets(std::vector<stl_facet> &&facets, bool repair = true);
     bool ReadSTLFile(const char* input_file, bool repair = true);
+    // Repair and index the facets read from an STL file the same way as ReadSTLFile() does.
+    void from_stl_facets(std::vector<stl_facet> &&facets, bool repair = true);
     bool write_ascii(const char* output_file);
     bool write_binary(const char* output_file);
     float volume();
@@ -247,6 +249,8 @@ std::vector<Vec3i> its_face_edge_ids(const indexed_triangle_set &its, std::vecto
 
 // Create index that gives neighbor faces for each face. Ignores face orientations.
 std::vector<Vec3i> its_face_neighbors(const indexed_triangle_set &its);
+// Parallel variant of its_face_neighbors(), sorting the half edges instead of walking the vertex to face index.
+// If more than two faces share an edge, the neighbors may be paired differently than by its_face_neighbors().
 std::vector<Vec3i> its_face_neighbors_par(const indexed_triangle_set &its);
 
 // After applying a transformation with negative determinant, flip the faces to keep the transformed mesh volume positive.
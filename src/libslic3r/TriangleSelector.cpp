@@ -1811,17 +1811,13 @@ TriangleSelector::TriangleSplittingData TriangleSelector::serialize() const {
             int split_sides = tr.number_of_split_sides();
             assert(split_sides >= 0 && split_sides <= 3);
 
-            data.bitstream.push_back(split_sides & 0b01);
-            data.bitstream.push_back(split_sides & 0b10);
-
             if (split_sides) {
                 // If this triangle is split, save which side is split (in case
                 // of one split) or kept (in case of two splits). The value will
                 // be ignored for 3-side split.
                 assert(tr.is_split() && split_sides > 0);
                 assert(tr.special_side() >= 0 && tr.special_side() <= 3);
-                data.bitstream.push_back(tr.special_side() & 0b01);
-                data.bitstream.push_back(tr.special_side() & 0b10);
+                data.bitstream.push_back(uint8_t(split_sides | (tr.special_side() << 2)));
                 // Now save all children.
                 // Serialized in reverse order for compatibility with PrusaSlicer 2.3.1.
                 for (int child_idx = split_sides; child_idx >= 0; -- child_idx)
@@ -1836,16 +1832,13 @@ TriangleSelector::TriangleSplittingData TriangleSelector::serialize() const {
                     assert(n <= 16);
                     if (n <= 16) {
                         // Store "11" plus 4 bits of (n-3).
-                        data.bitstream.insert(data.bitstream.end(), { true, true });
-                        n -= 3;
-                        for (size_t bit_idx = 0; bit_idx < 4; ++bit_idx)
-                            data.bitstream.push_back(n & (uint64_t(0b0001) << bit_idx));
+                        data.bitstream.push_back(0b1100);
+                        data.bitstream.push_back(uint8_t(n - 3));
                     }
                 } else {
                     // Simple case, compatible with PrusaSlicer 2.3.1 and older for storing paint on supports and seams.
                     // Store 2 bits of n.
-                    data.bitstream.push_back(n & 0b01);
-                    data.bitstream.push_back(n & 0b10);
+                    data.bitstream.push_back(uint8_t(n << 2));
                 }
             }
         }
@@ -1854,7 +1847,7 @@ TriangleSelector::TriangleSplittingData TriangleSelector::serialize() const {
     out.data.triangles_to_split.reserve(m_orig_size_indices);
     for (int i=0; i<m_orig_size_indices; ++i)
         if (const Triangle& tr = m_triangles[i]; tr.is_split() || tr.get_state() != TriangleStateType::NONE) {
-            // Store index of the first bit assigned to ith triangle.
+            // Store index of the first nibble assigned to ith triangle.
             out.data.triangles_to_split.emplace_back(i, int(out.data.bitstream.size()));
             // out the triangle bits.
             out.serialize(i);
@@ -1873,9 +1866,9 @@ void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs
     if (needs_reset)
         reset(); // dump any current state
 
-    // Reserve number of triangles as if each triangle was saved with 4 bits.
+    // Reserve number of triangles as if each triangle was saved with a single nibble.
     // With MMU painting this estimate may be somehow low, but better than nothing.
-    m_triangles.reserve(std::max(m_mesh.its.indices.size(), data.bitstream.size() / 4));
+    m_triangles.reserve(std::max(m_mesh.its.indices.size(), data.bitstream.size()));
     // Number of triangles is twice the number of vertices on a large manifold mesh of genus zero.
     // Here the triangles count account for both the nodes and leaves, thus the following line may overestimate.
     m_vertices.reserve(std::max(m_mesh.its.vertices.size(), m_triangles.size() / 2));
@@ -1894,12 +1887,7 @@ void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs
     for (auto [triangle_id, ibit] : data.triangles_to_split) {
         assert(triangle_id < int(m_triangles.size()));
         assert(ibit < int(data.bitstream.size()));
-        auto next_nibble = [&data, &ibit = ibit]() {
-            int n = 0;
-            for (int i = 0; i < 4; ++ i)
-                n |= data.bitstream[ibit ++] << i;
-            return n;
-        };
+        auto next_nibble = [&data, &ibit = ibit]() { return int(data.bitstream[ibit ++]); };
 
         parents.clear();
         while (true) {
@@ -1972,7 +1960,6 @@ void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs
 void TriangleSelector::TriangleSplittingData::update_used_states(const size_t bitstream_start_idx) {
     assert(bitstream_start_idx < this->bitstream.size());
     assert(!this->bitstream.empty() && this->bitstream.size() != bitstream_start_idx);
-    assert((this->bitstream.size() - bitstream_start_idx) % 4 == 0);
 
     if (this->bitstream.empty() || this->bitstream.size() == bitstream_start_idx)
         return;
@@ -1980,11 +1967,8 @@ void TriangleSelector::TriangleSplittingData::update_used_states(const size_t bi
     size_t nibble_idx = bitstream_start_idx;
 
     auto read_next_nibble = [&data_bitstream = std::as_const(this->bitstream), &nibble_idx]() -> uint8_t {
-        assert(nibble_idx + 3 < data_bitstream.size());
-        uint8_t code = 0;
-        for (size_t bit_idx = 0; bit_idx < 4; ++bit_idx)
-            code |= data_bitstream[nibble_idx++] << bit_idx;
-        return code;
+        assert(nibble_idx < data_bitstream.size());
+        return data_bitstream[nibble_idx++];
     };
 
     while (nibble_idx < this->bitstream.size()) {
@@ -2012,12 +1996,7 @@ bool TriangleSelector::has_facets(const TriangleSplittingData &data, const Trian
     for (const TriangleBitStreamMapping &triangle_id_and_ibit : data.triangles_to_split) {
         int ibit = triangle_id_and_ibit.bitstream_start_idx;
         assert(ibit < int(data.bitstream.size()));
-        auto next_nibble = [&data, &ibit = ibit]() {
-            int n = 0;
-            for (int i = 0; i < 4; ++ i)
-                n |= data.bitstream[ibit ++] << i;
-            return n;
-        };
+        auto next_nibble = [&data, &ibit = ibit]() { return int(data.bitstream[ibit ++]); };
         // < 0 -> negative of a number of children
         // >= 0 -> state
         auto num_children_or_state = [&next_nibble]() -> int {
@@ -267,7 +267,7 @@ public:
     {
         // Index of the triangle to which we assign the bitstream containing splitting information.
         int triangle_idx        = -1;
-        // Index of the first bit of the bitstream assigned to this triangle.
+        // Index of the first nibble (4 bit code) of the bitstream assigned to this triangle.
         int bitstream_start_idx = -1;
 
         TriangleBitStreamMapping() = default;
@@ -281,11 +281,44 @@ public:
         template<class Archive> void serialize(Archive &ar) { ar(triangle_idx, bitstream_start_idx); }
     };
 
+    // The splitting information is encoded in 4 bit codes (nibbles), see TriangleSelector::serialize().
+    // Two nibbles are packed into a byte, so that the stream may be read and written a nibble at a time
+    // and stored / copied as a plain byte array, for example onto the Undo / Redo stack.
+    class NibbleStream {
+    public:
+        // Number of nibbles stored.
+        size_t  size() const noexcept { return m_size; }
+        bool    empty() const noexcept { return m_size == 0; }
+        uint8_t operator[](size_t idx) const { assert(idx < m_size); return (m_data[idx >> 1] >> ((idx & 1) << 2)) & 0x0F; }
+
+        void    push_back(uint8_t nibble) {
+            assert(nibble <= 0x0F);
+            if ((m_size & 1) == 0)
+                m_data.emplace_back(nibble);
+            else
+                m_data.back() |= uint8_t(nibble << 4);
+            ++ m_size;
+        }
+        void    reserve(size_t num_nibbles) { m_data.reserve((num_nibbles + 1) / 2); }
+        void    clear() { m_data.clear(); m_size = 0; }
+        void    shrink_to_fit() { m_data.shrink_to_fit(); }
+
+        friend bool operator==(const NibbleStream &lhs, const NibbleStream &rhs) { return lhs.m_size == rhs.m_size && lhs.m_data == rhs.m_data; }
+        friend bool operator!=(const NibbleStream &lhs, const NibbleStream &rhs) { return !(lhs == rhs); }
+
+    private:
+        std::vector<uint8_t> m_data;
+        size_t               m_size { 0 };
+
+        friend class cereal::access;
+        template<class Archive> void serialize(Archive &ar) { ar(m_data, m_size); }
+    };
+
     struct TriangleSplittingData {
         // Vector of triangles and its indexes to the bitstream.
         std::vector<TriangleBitStreamMapping> triangles_to_split;
         // Bit stream containing splitting information.
-        std::vector<bool>                     bitstream;
+        NibbleStream                          bitstream;
         // Array indicating which triangle state types are used (encoded inside bitstream).
         std::vector<bool>                     used_states { std::vector<bool>(static_cast<size_t>(TriangleStateType::Count), false) };
 
@@ -2,7 +2,15 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <algorithm>
+#include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 
 #include "miniz_extension.hpp"
 #include "miniz.h"
@@ -161,4 +169,169 @@ std::string MZ_Archive::get_errorstr(mz_zip_error mz_err)
     return "unknown error";
 }
 
+namespace {
+
+// Combines the Adler-32 checksums of two consecutive blocks, len2 being the length of the second one.
+mz_uint32 adler32_combine(mz_uint32 adler1, mz_uint32 adler2, size_t len2)
+{
+    static constexpr mz_uint64 BASE = 65521;
+    const mz_uint64 rem  = len2 % BASE;
+    mz_uint64       sum1 = adler1 & 0xffff;
+    mz_uint64       sum2 = (rem * sum1) % BASE;
+    sum1 += (adler2 & 0xffff) + BASE - 1;
+    sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + BASE - rem;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+    if (sum2 >= BASE) sum2 -= BASE;
+    return mz_uint32(sum1 | (sum2 << 16));
+}
+
+void put_uint32_be(mz_uint8 *dst, mz_uint32 v)
+{
+    dst[0] = mz_uint8(v >> 24);
+    dst[1] = mz_uint8(v >> 16);
+    dst[2] = mz_uint8(v >> 8);
+    dst[3] = mz_uint8(v);
+}
+
+mz_bool tdefl_vector_putter(const void *buf, int len, void *user)
+{
+    auto *out = static_cast<std::vector<mz_uint8>*>(user);
+    out->insert(out->end(), static_cast<const mz_uint8*>(buf), static_cast<const mz_uint8*>(buf) + len);
+    return MZ_TRUE;
+}
+
+struct PNGBlock {
+    std::vector<mz_uint8> deflated;
+    mz_uint32             adler = MZ_ADLER32_INIT;
+    size_t                raw_size = 0;
+    bool                  failed = false;
+};
+
+} // namespace
+
+void* write_png_to_memory_parallel(const void *image, int w, int h, int num_chans, size_t *len_out, mz_uint level, bool flip)
+{
+    *len_out = 0;
+    if (w <= 0 || h <= 0 || num_chans < 1 || num_chans > 4)
+        return nullptr;
+
+    // Each block of rows is deflated into a raw deflate stream, all but the last one ending with a sync flush,
+    // so that their concatenation is a valid deflate stream. The blocks are large enough for the compression
+    // ratio not to suffer from the dictionary being reset at each block.
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+    const size_t bpl            = size_t(w) * num_chans;
+    const size_t rows_per_block = std::max<size_t>(1, BLOCK_SIZE / (bpl + 1));
+    const size_t num_blocks     = (size_t(h) + rows_per_block - 1) / rows_per_block;
+    const mz_uint8 filter       = num_chans == 1 ? 2 /* up */ : 0 /* none */;
+    const mz_uint comp_flags    = tdefl_create_comp_flags_from_zip_params(int(level), -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+
+    auto image_row = [image, bpl, h, flip](size_t y) {
+        return static_cast<const mz_uint8*>(image) + (flip ? size_t(h) - 1 - y : y) * bpl;
+    };
+
+    std::vector<PNGBlock> blocks(num_blocks);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+        std::vector<mz_uint8> filtered;
+        std::unique_ptr<tdefl_compressor, decltype(&mz_free)> comp(
+            static_cast<tdefl_compressor*>(MZ_MALLOC(sizeof(tdefl_compressor))), &mz_free);
+        for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+            PNGBlock    &block     = blocks[block_idx];
+            const size_t row_begin = block_idx * rows_per_block;
+            const size_t row_end   = std::min(size_t(h), row_begin + rows_per_block);
+            if (! comp) {
+                block.failed = true;
+                continue;
+            }
+
+            filtered.resize((row_end - row_begin) * (bpl + 1));
+            mz_uint8 *dst = filtered.data();
+            for (size_t y = row_begin; y < row_end; ++ y) {
+                const mz_uint8 *row = image_row(y);
+                *dst ++ = filter;
+                if (filter == 2 && y > 0) {
+                    const mz_uint8 *prev = image_row(y - 1);
+                    for (size_t i = 0; i < bpl; ++ i)
+                        dst[i] = mz_uint8(row[i] - prev[i]);
+                } else
+                    memcpy(dst, row, bpl);
+                dst += bpl;
+            }
+
+            block.raw_size = filtered.size();
+            block.adler    = mz_uint32(mz_adler32(MZ_ADLER32_INIT, filtered.data(), filtered.size()));
+            block.deflated.reserve(filtered.size() / 4 + 64);
+            const bool last = block_idx + 1 == num_blocks;
+            block.failed =
+                tdefl_init(comp.get(), tdefl_vector_putter, &block.deflated, int(comp_flags)) != TDEFL_STATUS_OKAY ||
+                tdefl_compress_buffer(comp.get(), filtered.data(), filtered.size(), last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) !=
+                    (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+        }
+    });
+
+    size_t    deflated_size = 0;
+    mz_uint32 adler         = MZ_ADLER32_INIT;
+    for (const PNGBlock &block : blocks) {
+        if (block.failed)
+            return nullptr;
+        deflated_size += block.deflated.size();
+        adler = adler32_combine(adler, block.adler, block.raw_size);
+    }
+
+    // PNG signature, IHDR chunk, IDAT chunk with zlib header and Adler-32 trailer, IEND chunk.
+    const size_t idat_size = 2 + deflated_size + 4;
+    const size_t png_size  = 8 + 25 + 12 + idat_size + 12;
+    if (idat_size > 0x7fffffff)
+        return nullptr;
+    auto *png = static_cast<mz_uint8*>(MZ_MALLOC(png_size));
+    if (png == nullptr)
+        return nullptr;
+
+    static const mz_uint8 signature[8] = { 0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a };
+    static const mz_uint8 color_type[] = { 0x00, 0x00, 0x04, 0x02, 0x06 };
+    mz_uint8 *p = png;
+    memcpy(p, signature, 8);
+    p += 8;
+
+    auto finish_chunk = [](mz_uint8 *chunk, size_t data_len) {
+        put_uint32_be(chunk, mz_uint32(data_len));
+        put_uint32_be(chunk + 8 + data_len, mz_uint32(mz_crc32(MZ_CRC32_INIT, chunk + 4, data_len + 4)));
+        return chunk + 12 + data_len;
+    };
+
+    memcpy(p + 4, "IHDR", 4);
+    put_uint32_be(p + 8, mz_uint32(w));
+    put_uint32_be(p + 12, mz_uint32(h));
+    p[16] = 8; // bit depth
+    p[17] = color_type[num_chans];
+    p[18] = 0; // compression
+    p[19] = 0; // filter
+    p[20] = 0; // interlace
+    p = finish_chunk(p, 13);
+
+    mz_uint8 *idat = p;
+    memcpy(idat + 4, "IDAT", 4);
+    mz_uint8 *q = idat + 8;
+    // zlib header with the compression level hint and the check bits.
+    const mz_uint8 cmf   = 0x78;
+    mz_uint8       flg   = mz_uint8((level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6);
+    flg = mz_uint8(flg + 31 - (cmf * 256 + flg) % 31);
+    *q ++ = cmf;
+    *q ++ = flg;
+    for (const PNGBlock &block : blocks) {
+        memcpy(q, block.deflated.data(), block.deflated.size());
+        q += block.deflated.size();
+    }
+    put_uint32_be(q, adler);
+    p = finish_chunk(idat, idat_size);
+
+    memcpy(p + 4, "IEND", 4);
+    p = finish_chunk(p, 0);
+    assert(size_t(p - png) == png_size);
+
+    *len_out = png_size;
+    return png;
+}
+
 } // namespace Slic3r
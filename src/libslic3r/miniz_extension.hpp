@@ -15,6 +15,13 @@ bool open_zip_writer(mz_zip_archive *zip, const std::string &fname_utf8);
 bool close_zip_reader(mz_zip_archive *zip);
 bool close_zip_writer(mz_zip_archive *zip);
 
+// Replacement of miniz tdefl_write_image_to_png_file_in_memory_ex(), which deflates blocks of image rows
+// in parallel into a single valid zlib stream. Single channel images (SLA masks) are filtered by the "up"
+// PNG filter, which turns the rows identical to the row above into zeros. The returned buffer has to be
+// released by mz_free(), nullptr is returned on error.
+void* write_png_to_memory_parallel(const void *image, int w, int h, int num_chans, size_t *len_out,
+                                   mz_uint level = MZ_DEFAULT_LEVEL, bool flip = false);
+
 class MZ_Archive {
 public:
     mz_zip_archive arch;
@@ -67,6 +67,7 @@ public:
     XLPivots get_xl_alignment() const override { return m_settings_fff.vals.xl_align; }
     GeometryHandling get_geometry_handling() const override { return m_settings_fff.vals.geom_handling; }
     ArrangeStrategy get_arrange_strategy() const override { return m_settings_fff.vals.arr_strategy; }
+    bool is_speculative_packing_enabled() const override { return m_settings_fff.vals.speculative; }
 
     void distance_from_obj_range(float &min, float &max) const override;
     void distance_from_bed_range(float &min, float &max) const override;
@@ -78,6 +79,7 @@ public:
     ArrangeSettingsDb& set_xl_alignment(XLPivots v) override;
     ArrangeSettingsDb& set_geometry_handling(GeometryHandling v) override;
     ArrangeSettingsDb& set_arrange_strategy(ArrangeStrategy v) override;
+    ArrangeSettingsDb& set_speculative_packing(bool v) override;
 
     Values get_defaults() const override { return get_slot(this).defaults; }
 
@@ -39,6 +39,10 @@ public:
     virtual GeometryHandling get_geometry_handling() const = 0;
     virtual ArrangeStrategy  get_arrange_strategy() const  = 0;
 
+    // Pack several items concurrently, the result may differ from the
+    // sequential packing. See firstfit::SpeculativeSelectionStrategy.
+    virtual bool is_speculative_packing_enabled() const { return false; }
+
     static constexpr std::string_view get_label(GeometryHandling v)
     {
         constexpr auto STR = std::array{
@@ -164,12 +168,15 @@ public:
     virtual ArrangeSettingsDb& set_geometry_handling(GeometryHandling v) = 0;
     virtual ArrangeSettingsDb& set_arrange_strategy(ArrangeStrategy v) = 0;
 
+    virtual ArrangeSettingsDb& set_speculative_packing(bool v) = 0;
+
     struct Values {
         float d_obj = 6.f, d_bed = 0.f;
         bool rotations = false;
         XLPivots xl_align = XLPivots::xlpFrontLeft;
         GeometryHandling geom_handling = GeometryHandling::ghConvex;
         ArrangeStrategy  arr_strategy = ArrangeStrategy::asAuto;
+        bool speculative = false;
 
         Values() = default;
         Values(const ArrangeSettingsView &sv)
@@ -180,6 +187,7 @@ public:
             geom_handling = sv.get_geometry_handling();
             rotations = sv.is_rotation_enabled();
             xl_align = sv.get_xl_alignment();
+            speculative = sv.is_speculative_packing_enabled();
         }
     };
 
@@ -193,6 +201,7 @@ public:
         set_geometry_handling(sv.get_geometry_handling());
         set_rotation_enabled(sv.is_rotation_enabled());
         set_xl_alignment(sv.get_xl_alignment());
+        set_speculative_packing(sv.is_speculative_packing_enabled());
 
         return *this;
     }
@@ -218,6 +227,7 @@ public:
     XLPivots get_xl_alignment() const override { return m_v.xl_align; }
     GeometryHandling get_geometry_handling() const override { return m_v.geom_handling; }
     ArrangeStrategy get_arrange_strategy() const override { return m_v.arr_strategy; }
+    bool is_speculative_packing_enabled() const override { return m_v.speculative; }
 
     void distance_from_obj_range(float &min, float &max) const override { min = 0.f; max = 100.f; }
     void distance_from_bed_range(float &min, float &max) const override { min = 0.f; max = 100.f; }
@@ -228,6 +238,7 @@ public:
     ArrangeSettings& set_xl_alignment(XLPivots v) override { m_v.xl_align = v; return *this; }
     ArrangeSettings& set_geometry_handling(GeometryHandling v) override { m_v.geom_handling = v; return *this; }
     ArrangeSettings& set_arrange_strategy(ArrangeStrategy v) override { m_v.arr_strategy = v; return *this; }
+    ArrangeSettings& set_speculative_packing(bool v) override { m_v.speculative = v; return *this; }
 
     auto & values() const { return m_v; }
     auto & values() { return m_v; }
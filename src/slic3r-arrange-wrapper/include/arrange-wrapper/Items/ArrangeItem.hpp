@@ -12,6 +12,7 @@
 #include <optional>
 #include <algorithm>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -30,6 +31,7 @@
 #include <arrange/PackingContext.hpp>
 #include <arrange/NFP/NFPArrangeItemTraits.hpp>
 #include <arrange/NFP/NFP.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeItemTraits.hpp>
 #include <arrange/DataStoreTraits.hpp>
@@ -63,6 +65,7 @@ inline bool check_polygons_are_convex(const Polygons &pp) {
 class DecomposedShape
 {
     Polygons m_shape;
+    uint64_t m_outline_hash = NFPCache::outline_hash({}); // Hash of m_shape
 
     Vec2crd m_translation{0, 0}; // The translation of the poly
     double  m_rotation{0.0};     // The rotation of the poly in radians
@@ -88,6 +91,7 @@ public:
     explicit DecomposedShape(Polygon sh)
     {
         m_shape.emplace_back(std::move(sh));
+        m_outline_hash = NFPCache::outline_hash(m_shape);
         assert(check_polygons_are_convex(m_shape));
     }
 
@@ -95,13 +99,17 @@ public:
         : DecomposedShape(Polygon{pts})
     {}
 
-    explicit DecomposedShape(Polygons sh) : m_shape{std::move(sh)}
+    explicit DecomposedShape(Polygons sh)
+        : m_shape{std::move(sh)}, m_outline_hash{NFPCache::outline_hash(m_shape)}
     {
         assert(check_polygons_are_convex(m_shape));
     }
 
     const Polygons &contours() const { return m_shape; }
 
+    // Hash of the untransformed contours, see NFPCache.
+    uint64_t outline_hash() const { return m_outline_hash; }
+
     const Vec2crd &translation() const { return m_translation; }
     double         rotation() const { return m_rotation; }
 
@@ -273,6 +281,11 @@ template<> struct ArrangeItemTraits_<ArrangeItem>
     }
 };
 
+template<> struct ItemCacheTraits_<ArrangeItem>
+{
+    static void update_caches(const ArrangeItem &itm) { itm.update_caches(); }
+};
+
 // Some items can be containers of arbitrary data stored under string keys.
 template<> struct DataStoreTraits_<ArrangeItem>
 {
@@ -310,11 +323,52 @@ template<> struct WritableDataStoreTraits_<ArrangeItem>
     }
 };
 
+// The no-fit polygon of the envelope of an item around the shape of a fixed
+// item, it is the union of the no-fit polygons of all the pairs of their
+// convex parts.
+inline Polygons calculate_pair_nfp(const ArrangeItem &item, const ArrangeItem &fixed)
+{
+    const Polygons &item_outlines = item.envelope().transformed_outline();
+
+    // fixed_polys should already be a set of strictly convex polygons,
+    // as ArrangeItem stores convex-decomposed polygons
+    const Polygons & fixed_polys = fixed.shape().transformed_outline();
+
+    auto nfps = reserve_polygons(fixed_polys.size() * item_outlines.size());
+
+    Vec2crd ref_whole = item.envelope().reference_vertex();
+    Polygon subnfp;
+
+    for (const Polygon &fixed_poly : fixed_polys) {
+        Point max_fixed = Slic3r::reference_vertex(fixed_poly);
+        for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
+            const Polygon &movable = item_outlines[mi];
+            const Vec2crd &mref = item.envelope().reference_vertex(mi);
+            subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+
+            Vec2crd min_movable = item.envelope().min_vertex(mi);
+
+            Vec2crd dtouch = max_fixed - min_movable;
+            Vec2crd top_other = mref + dtouch;
+            Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
+            auto dnfp = top_other - max_nfp;
+
+            auto d = ref_whole - mref + dnfp;
+            subnfp.translate(d);
+            nfps.emplace_back(subnfp);
+        }
+    }
+
+    return union_(nfps);
+}
+
 template<class FixedIt, class StopCond = DefaultStopCondition>
 static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
                                            const Range<FixedIt> &fixed_items,
                                            StopCond &&stop_cond = {})
 {
+    NFPCache &cache = NFPCache::instance();
+
     size_t cap = 0;
 
     for (const ArrangeItem &fixitem : fixed_items) {
@@ -322,50 +376,38 @@ static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
         cap += outlines.size();
     }
 
-    const Polygons &item_outlines = item.envelope().transformed_outline();
-
-    auto nfps = reserve_polygons(cap * item_outlines.size());
-
-    Vec2crd ref_whole = item.envelope().reference_vertex();
-    Polygon subnfp;
+    auto nfps = reserve_polygons(cap);
 
+    Polygons pair_nfp;
     for (const ArrangeItem &fixed : fixed_items) {
-        // fixed_polys should already be a set of strictly convex polygons,
-        // as ArrangeItem stores convex-decomposed polygons
-        const Polygons & fixed_polys = fixed.shape().transformed_outline();
-
-        for (const Polygon &fixed_poly : fixed_polys) {
-            Point max_fixed = Slic3r::reference_vertex(fixed_poly);
-            for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
-                const Polygon &movable = item_outlines[mi];
-                const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
-
-                Vec2crd min_movable = item.envelope().min_vertex(mi);
-
-                Vec2crd dtouch = max_fixed - min_movable;
-                Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
-                auto dnfp = top_other - max_nfp;
-
-                auto d = ref_whole - mref + dnfp;
-                subnfp.translate(d);
-                nfps.emplace_back(subnfp);
+        // The no-fit polygon of a pair does not depend on the translation of
+        // the item and it moves with the fixed item.
+        NFPCache::Key key{fixed.shape().outline_hash(), fixed.rotation(),
+                          item.envelope().outline_hash(), item.rotation()};
+
+        if (cache.enabled() && cache.find(key, pair_nfp)) {
+            for (Polygon &p : pair_nfp)
+                p.translate(fixed.translation());
+        } else {
+            pair_nfp = calculate_pair_nfp(item, fixed);
+            if (cache.enabled()) {
+                Polygons normalized = pair_nfp;
+                for (Polygon &p : normalized)
+                    p.translate(-fixed.translation());
+                cache.insert(key, std::move(normalized));
             }
-
-            if (stop_cond())
-                break;
-
-            nfps = union_(nfps);
         }
 
+        std::move(pair_nfp.begin(), pair_nfp.end(), std::back_inserter(nfps));
+        pair_nfp.clear();
+
         if (stop_cond()) {
             nfps.clear();
             break;
         }
     }
 
-    return nfps;
+    return union_(nfps);
 }
 
 template<> struct NFPArrangeItemTraits_<ArrangeItem> {
@@ -13,6 +13,7 @@
 
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeFirstFit.hpp>
+#include <arrange/ArrangeFirstFitSpeculative.hpp>
 #include <arrange/NFP/PackStrategyNFP.hpp>
 #include <arrange/NFP/Kernels/TMArrangeKernel.hpp>
 #include <arrange/NFP/Kernels/GravityKernel.hpp>
@@ -289,8 +290,6 @@ class DefaultArranger: public Arranger<ArrItem> {
 
         auto stop_cond = [&ctl] { return ctl.was_canceled(); };
 
-        firstfit::SelectionStrategy sel{cmpfn, on_arranged, stop_cond};
-
         constexpr auto ep = ex_tbb;
 
         VariantKernel basekernel;
@@ -325,19 +324,29 @@ class DefaultArranger: public Arranger<ArrItem> {
         // With rectange bed, and no fixed items, let's use an infinite bed
         // with RectangleOverfitKernelWrapper. It produces better results than
         // a pure RectangleBed with inner-fit polygon calculation.
-        if (!with_wipe_tower &&
-            m_settings.get_arrange_strategy() == ArrangeSettingsView::asAuto &&
-            IsRectangular<Bed>) {
-            PackStrategyNFP base_strategy{std::move(kernel), ep, Accuracy, stop_cond};
+        auto arrange_with = [&](auto &&sel, auto &&packing_kernel) {
+            if (!with_wipe_tower &&
+                m_settings.get_arrange_strategy() == ArrangeSettingsView::asAuto &&
+                IsRectangular<Bed>) {
+                PackStrategyNFP base_strategy{std::move(packing_kernel), ep, Accuracy, stop_cond};
 
-            RectangleOverfitPackingStrategy final_strategy{std::move(base_strategy)};
+                RectangleOverfitPackingStrategy final_strategy{std::move(base_strategy)};
 
-            arr2::arrange(sel, final_strategy, items, fixed, bed);
-        } else {
-            PackStrategyNFP ps{std::move(kernel), ep, Accuracy, stop_cond};
+                arr2::arrange(sel, final_strategy, items, fixed, bed);
+            } else {
+                PackStrategyNFP ps{std::move(packing_kernel), ep, Accuracy, stop_cond};
 
-            arr2::arrange(sel, ps, items, fixed, bed);
-        }
+                arr2::arrange(sel, ps, items, fixed, bed);
+            }
+        };
+
+        // The speculative selection packs with copies of the kernel, the debug
+        // output wrapper refers to a single one.
+        if (m_settings.is_speculative_packing_enabled())
+            arrange_with(firstfit::SpeculativeSelectionStrategy{cmpfn, on_arranged, stop_cond, ep},
+                         basekernel);
+        else
+            arrange_with(firstfit::SelectionStrategy{cmpfn, on_arranged, stop_cond}, kernel);
     }
 
 public:
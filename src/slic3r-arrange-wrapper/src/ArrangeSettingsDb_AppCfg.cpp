@@ -58,6 +58,9 @@ void ArrangeSettingsDb_AppCfg::sync()
     std::string strategy_str =
         m_appcfg->get("arrange", "arrange_strategy");
 
+    std::string speculative_str =
+        m_appcfg->get("arrange", "speculative_packing");
+
     if (!dist_fff_str.empty())
         m_settings_fff.vals.d_obj = string_to_float_decimal_point(dist_fff_str);
     else
@@ -122,6 +125,14 @@ void ArrangeSettingsDb_AppCfg::sync()
     m_settings_sla.vals.arr_strategy = arr_strategy;
     m_settings_fff.vals.arr_strategy = arr_strategy;
     m_settings_fff_seq.vals.arr_strategy = arr_strategy;
+
+    bool speculative = m_settings_fff.defaults.speculative;
+    if (!speculative_str.empty())
+        speculative = (speculative_str == "1" || speculative_str == "yes");
+
+    m_settings_sla.vals.speculative = speculative;
+    m_settings_fff.vals.speculative = speculative;
+    m_settings_fff_seq.vals.speculative = speculative;
 }
 
 void ArrangeSettingsDb_AppCfg::distance_from_obj_range(float &min,
@@ -191,4 +202,12 @@ arr2::ArrangeSettingsDb& ArrangeSettingsDb_AppCfg::set_arrange_strategy(ArrangeS
     return *this;
 }
 
+arr2::ArrangeSettingsDb& ArrangeSettingsDb_AppCfg::set_speculative_packing(bool v)
+{
+    m_settings_fff.vals.speculative = v;
+    m_appcfg->set("arrange", "speculative_packing", v ? "1" : "0");
+
+    return *this;
+}
+
 } // namespace Slic3r
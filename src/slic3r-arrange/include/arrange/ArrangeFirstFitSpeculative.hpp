@@ -0,0 +1,337 @@
+#ifndef ARRANGEFIRSTFITSPECULATIVE_HPP
+#define ARRANGEFIRSTFITSPECULATIVE_HPP
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
+
+#include <arrange/ArrangeFirstFit.hpp>
+#include <arrange/NFP/NFPArrangeItemTraits.hpp>
+#include <arrange/NFP/RectangleOverfitPackingStrategy.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+// Decides if a placement calculated by pack() against an older state of the
+// packing context is still valid in the current state of the context.
+// new_items are the items packed into the context since then. Can be
+// specialized by packing strategies.
+template<class PackStrategy, class En = void>
+struct SpeculativePackTraits_ {
+    template<class ArrItem, class Bed, class Context, class It>
+    static bool is_placement_valid(const PackStrategy & /*ps*/,
+                                   const Bed & /*bed*/,
+                                   const ArrItem &item,
+                                   const Context & /*packing_context*/,
+                                   const Range<It> &new_items)
+    {
+        BoundingBox bb = envelope_bounding_box(item);
+
+        for (const auto &other : new_items) {
+            if (!bb.overlap(fixed_bounding_box(other)))
+                continue;
+
+            // The no-fit polygons let the items touch each other.
+            Polygons other_outline = offset(fixed_outline(other),
+                                            -float(SCALED_EPSILON));
+
+            if (!intersection(envelope_outline(item), other_outline).empty())
+                return false;
+        }
+
+        return true;
+    }
+};
+
+// Without fixed items, the whole pile has to fit into the bed, see
+// RectangleOverfitKernelWrapper.
+template<class... Args>
+struct SpeculativePackTraits_<RectangleOverfitPackingStrategy<Args...>> {
+    template<class ArrItem, class Bed, class Context, class It>
+    static bool is_placement_valid(const RectangleOverfitPackingStrategy<Args...> &ps,
+                                   const Bed &bed,
+                                   const ArrItem &item,
+                                   const Context &packing_context,
+                                   const Range<It> &new_items)
+    {
+        bool ret = SpeculativePackTraits_<PackStrategyNFP<Args...>>::is_placement_valid(
+            ps.base_strategy, bed, item, packing_context, new_items);
+
+        if (ret && fixed_items_range(packing_context).empty()) {
+            BoundingBox pilebb = envelope_bounding_box(item);
+            for (const auto &itm : all_items_range(packing_context))
+                pilebb.merge(fixed_bounding_box(itm));
+
+            auto pilesz = pilebb.size();
+            auto limsz  = packing_context.limits.size();
+
+            ret = pilesz.x() <= limsz.x() + SCALED_EPSILON &&
+                  pilesz.y() <= limsz.y() + SCALED_EPSILON;
+        }
+
+        return ret;
+    }
+};
+
+template<class PackStrategy, class Bed, class ArrItem, class Context, class It>
+bool is_speculative_placement_valid(const PackStrategy &ps,
+                                    const Bed &bed,
+                                    const ArrItem &item,
+                                    const Context &packing_context,
+                                    const Range<It> &new_items)
+{
+    return SpeculativePackTraits_<StripCVRef<PackStrategy>>::is_placement_valid(
+        ps, bed, item, packing_context, new_items);
+}
+
+namespace firstfit {
+
+struct SpeculativeSelectionTag {};
+
+// First fit selection packing a batch of the upcoming items concurrently,
+// each against the state of the packing contexts before the batch. The
+// placements are then committed in order. A placement is accepted if it is
+// still valid with the items committed before it from the same batch,
+// otherwise the rest of the batch is packed again in the next round. The
+// batch size follows the rate of accepted placements: it is doubled after
+// a fully accepted batch and reduced to the accepted count otherwise.
+//
+// The result is a valid arrangement, but it may differ from the one of
+// SelectionStrategy as a speculative placement is not optimized for the
+// items committed before it.
+template<class CompareFn     = DefaultItemCompareFn,
+         class OnArrangedFn  = DefaultOnArrangedFn,
+         class StopCondition = DefaultStopCondition,
+         class ExecPolicy    = ExecutionTBB>
+struct SpeculativeSelectionStrategy
+    : public SelectionStrategy<CompareFn, OnArrangedFn, StopCondition>
+{
+    ExecPolicy ep;
+
+    // The maximum number of items packed at once, zero means the concurrency
+    // of the execution policy.
+    size_t max_batch_size = 0;
+
+    SpeculativeSelectionStrategy(CompareFn     cmp         = {},
+                                 OnArrangedFn  on_arranged = {},
+                                 StopCondition stopcond    = {},
+                                 ExecPolicy    execpolicy  = {},
+                                 size_t        max_batch   = 0)
+        : SelectionStrategy<CompareFn, OnArrangedFn, StopCondition>{cmp,
+                                                                    std::move(on_arranged),
+                                                                    std::move(stopcond)}
+        , ep{std::move(execpolicy)}
+        , max_batch_size{max_batch}
+    {}
+};
+
+} // namespace firstfit
+
+template<class... Args>
+struct SelStrategyTag_<firstfit::SpeculativeSelectionStrategy<Args...>> {
+    using Tag = firstfit::SpeculativeSelectionTag;
+};
+
+template<class It,
+         class ConstIt,
+         class TBed,
+         class SelStrategy,
+         class PackStrategy>
+void arrange(
+    SelStrategy &&sel,
+    PackStrategy &&ps,
+    const Range<It> &items,
+    const Range<ConstIt> &fixed,
+    const TBed &bed,
+    const firstfit::SpeculativeSelectionTag &)
+{
+    using ArrItem = typename std::iterator_traits<It>::value_type;
+    using ArrItemRef = std::reference_wrapper<ArrItem>;
+    using Strategy = StripCVRef<PackStrategy>;
+
+    auto sorted_items = reserve_vector<ArrItemRef>(items.size());
+
+    for (auto &itm : items) {
+        set_bed_index(itm, Unarranged);
+        sorted_items.emplace_back(itm);
+    }
+
+    using Context = PackStrategyContext<PackStrategy, ArrItem>;
+
+    std::map<int, Context> bed_contexts;
+    auto get_or_init_context = [&ps, &bed, &bed_contexts](int bedidx) -> Context& {
+        auto ctx_it = bed_contexts.find(bedidx);
+        if (ctx_it == bed_contexts.end()) {
+            auto res = bed_contexts.emplace(
+                bedidx, create_context<ArrItem>(ps, bed, bedidx));
+
+            assert(res.second);
+
+            ctx_it = res.first;
+        }
+
+        return ctx_it->second;
+    };
+
+    for (auto &itm : fixed) {
+        auto bedidx = get_bed_index(itm);
+        if (bedidx >= 0) {
+            Context &ctx = get_or_init_context(bedidx);
+            add_fixed_item(ctx, itm);
+        }
+    }
+
+    if constexpr (!std::is_null_pointer_v<decltype(sel.cmpfn)>) {
+        std::stable_sort(sorted_items.begin(), sorted_items.end(), sel.cmpfn);
+    }
+
+    auto is_cancelled = [&sel]() {
+        return sel.cancel_fn();
+    };
+
+    remove_unpackable_items(ps, sorted_items, bed, [&is_cancelled]() {
+        return is_cancelled();
+    });
+
+    size_t max_batch = sel.max_batch_size > 0 ?
+                           sel.max_batch_size :
+                           execution::max_concurrency(sel.ep);
+    max_batch = std::max(max_batch, size_t(1));
+
+    // The kernels of the strategies are stateful, each concurrently packed
+    // item needs its own copy.
+    std::vector<Strategy> strategies(max_batch, ps);
+
+    struct Placement
+    {
+        ArrItem item;          // Copy of the item packed speculatively
+        bool    done   = false; // Packed or left out of its enforced bed
+        bool    packed = false;
+    };
+
+    std::vector<Placement> placements;
+    placements.reserve(max_batch);
+
+    // The first item packed onto each bed. Contexts may translate their
+    // packed items (see RectangleOverfitPackingContext) and the speculative
+    // placements have to follow them.
+    std::map<int, const ArrItem *> pile_refs;
+
+    using SConstIt = typename std::vector<ArrItemRef>::const_iterator;
+
+    size_t batch = max_batch;
+    auto it = sorted_items.begin();
+
+    while (it != sorted_items.end() && !is_cancelled()) {
+        size_t n = std::min(batch, size_t(std::distance(it, sorted_items.end())));
+
+        // The items in the contexts are read concurrently.
+        for (auto &[bedidx, ctx] : bed_contexts)
+            for (const auto &itm : all_items_range(ctx))
+                update_caches(itm);
+
+        placements.clear();
+        for (size_t j = 0; j < n; ++j)
+            placements.emplace_back(Placement{ArrItem(it[j].get())});
+
+        std::map<int, Vec2crd> pile_ref_tr;
+        for (auto &[bedidx, ref] : pile_refs)
+            pile_ref_tr[bedidx] = get_translation(*ref);
+
+        execution::for_each(sel.ep, size_t(0), n, [&](size_t j) {
+            Placement &pl = placements[j];
+
+            const std::optional<int> bed_constraint{get_bed_constraint(pl.item)};
+            auto remaining = Range{std::next(static_cast<SConstIt>(it + j)),
+                                   sorted_items.cend()};
+
+            for (int bedidx = 0; !pl.done && !is_cancelled(); bedidx++) {
+                if (bed_constraint && bedidx != *bed_constraint)
+                    continue;
+
+                set_bed_index(pl.item, bedidx);
+
+                // No context is created here, the map is read concurrently.
+                auto ctx_it = bed_contexts.find(bedidx);
+                if (ctx_it != bed_contexts.end()) {
+                    pl.packed = pack(strategies[j], bed, pl.item, ctx_it->second,
+                                     remaining);
+                } else {
+                    Context empty_ctx = create_context<ArrItem>(strategies[j], bed, bedidx);
+                    pl.packed = pack(strategies[j], bed, pl.item, empty_ctx, remaining);
+                }
+
+                if (pl.packed) {
+                    pl.done = true;
+                } else {
+                    set_bed_index(pl.item, Unarranged);
+
+                    // Leave the item as is as it does not fit on the enforced bed.
+                    pl.done = bed_constraint && bedidx == *bed_constraint;
+                }
+            }
+        }, 1);
+
+        // Items committed in this round, per bed.
+        std::map<int, std::vector<ArrItemRef>> committed_items;
+
+        size_t committed = 0;
+        for (; committed < n && !is_cancelled(); ++committed) {
+            Placement &pl = placements[committed];
+            if (!pl.done)
+                break;
+
+            auto itm_it = it + committed;
+            ArrItem &itm = *itm_it;
+
+            auto remaining = Range{std::next(static_cast<SConstIt>(itm_it)),
+                                   sorted_items.cend()};
+            auto packed_range = Range{sorted_items.cbegin(),
+                                      static_cast<SConstIt>(itm_it)};
+
+            if (pl.packed) {
+                int bedidx = get_bed_index(pl.item);
+
+                if (auto ref = pile_refs.find(bedidx); ref != pile_refs.end())
+                    translate(pl.item, get_translation(*ref->second) - pile_ref_tr[bedidx]);
+
+                Context &ctx = get_or_init_context(bedidx);
+
+                // The first placement of the batch was calculated against the
+                // current state of the contexts.
+                if (committed > 0 &&
+                    !is_speculative_placement_valid(ps, bed, pl.item, ctx,
+                                                    crange(committed_items[bedidx])))
+                    break;
+
+                set_translation(itm, get_translation(pl.item));
+                set_rotation(itm, get_rotation(pl.item));
+                set_bed_index(itm, bedidx);
+
+                if (pile_refs.find(bedidx) == pile_refs.end()) {
+                    pile_refs[bedidx]   = &itm;
+                    pile_ref_tr[bedidx] = get_translation(itm);
+                }
+
+                add_packed_item(ctx, itm);
+                committed_items[bedidx].emplace_back(itm);
+            } else {
+                set_bed_index(itm, Unarranged);
+            }
+
+            sel.on_arranged_fn(itm, bed, packed_range, remaining);
+        }
+
+        it += committed;
+
+        batch = committed == n ? std::min(2 * batch, max_batch) :
+                                 std::max(committed, size_t(1));
+    }
+}
+
+}} // namespace Slic3r::arr2
+
+#endif // ARRANGEFIRSTFITSPECULATIVE_HPP
@@ -106,6 +106,17 @@ template<class T> void set_bed_constraint(T &itm, std::optional<int> v)
     ArrangeItemTraits<T>::set_bed_constraint(itm, v);
 }
 
+// Items caching their transformed geometry lazily (not thread safe) can
+// specialize this to fill the caches before being read by multiple threads.
+template<class ArrItem, class En = void> struct ItemCacheTraits_ {
+    static void update_caches(const ArrItem &) {}
+};
+
+template<class T> void update_caches(const T &itm)
+{
+    ItemCacheTraits_<StripCVRef<T>>::update_caches(itm);
+}
+
 // Helper functions for arrange items
 template<class ArrItem> bool is_arranged(const ArrItem &ap)
 {
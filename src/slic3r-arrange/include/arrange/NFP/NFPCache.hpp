@@ -0,0 +1,96 @@
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <libslic3r/Polygon.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+// Content addressed store of the no-fit polygons of pairs of item outlines.
+//
+// The no-fit polygon of a movable outline around a fixed one only depends on
+// the two outlines and their rotations: translating the fixed outline
+// translates the no-fit polygon, translating the movable outline does not
+// change it at all. The no-fit polygons are thus stored for the fixed outline
+// at zero translation, keyed by the hashes of the untransformed outlines and
+// the rotations. Inflated envelopes have different outlines, so they have
+// their own entries.
+//
+// Arranging the same parts again reuses the no-fit polygons calculated by the
+// previous arrangements of the process. The store can also be saved into a
+// file and loaded by another process.
+class NFPCache
+{
+public:
+    struct Key
+    {
+        uint64_t fixed_hash       = 0;
+        double   fixed_rotation   = 0.;
+        uint64_t movable_hash     = 0;
+        double   movable_rotation = 0.;
+
+        bool operator==(const Key &k) const
+        {
+            return fixed_hash == k.fixed_hash && fixed_rotation == k.fixed_rotation &&
+                   movable_hash == k.movable_hash && movable_rotation == k.movable_rotation;
+        }
+    };
+
+    // The cache shared by all the arrangements of the process.
+    static NFPCache &instance();
+
+    // Hash of an untransformed outline, stable across processes.
+    static uint64_t outline_hash(const Polygons &outline);
+
+    bool enabled() const { return m_enabled; }
+    void enabled(bool v) { m_enabled = v; }
+
+    // Copy the no-fit polygon of the key into nfp. Returns false if it is not
+    // stored. Thread safe.
+    bool find(const Key &key, Polygons &nfp) const;
+
+    // Store the no-fit polygon of the fixed outline at zero translation.
+    // Thread safe.
+    void insert(const Key &key, Polygons nfp);
+
+    void   clear();
+    size_t size() const;
+
+    // The number of stored no-fit polygons above which the cache is cleared.
+    void   max_size(size_t v) { m_max_size = v; }
+    size_t max_size() const { return m_max_size; }
+
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+    void   reset_statistics() { m_hits = 0; m_misses = 0; }
+
+    // Add the no-fit polygons stored by save() to the cache. Returns false if
+    // the file does not exist or is not a valid cache file of this version,
+    // the cache is unchanged then.
+    bool load(const std::string &path);
+
+    // Store the content of the cache into a file.
+    // Throws Slic3r::FileIOError if the file could not be written.
+    void save(const std::string &path) const;
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const noexcept;
+    };
+
+    mutable std::mutex                          m_mutex;
+    std::unordered_map<Key, Polygons, KeyHash> m_nfps;
+    size_t                                      m_max_size = 20000;
+    std::atomic<bool>                           m_enabled{true};
+    mutable std::atomic<size_t>                 m_hits{0}, m_misses{0};
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // NFPCACHE_HPP
@@ -0,0 +1,202 @@
+#include <arrange/NFP/NFPCache.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <libslic3r/Exception.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+namespace {
+
+// FNV-1a, the hashes are stored into the cache files, thus they have to be
+// the same in all processes.
+constexpr uint64_t FNVOffset = 14695981039346656037ull;
+constexpr uint64_t FNVPrime  = 1099511628211ull;
+
+inline uint64_t hash_bytes(uint64_t h, const void *data, size_t size)
+{
+    auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++ i)
+        h = (h ^ bytes[i]) * FNVPrime;
+
+    return h;
+}
+
+inline uint64_t hash_value(uint64_t h, int64_t v) { return hash_bytes(h, &v, sizeof(v)); }
+
+constexpr char     CacheFileMagic[4] = {'N', 'F', 'P', 'C'};
+constexpr uint32_t CacheFileVersion  = 1;
+// Sanity limit of the polygon size read from a file.
+constexpr uint64_t MaxPolygonSize    = 1 << 24;
+
+template<class T> void write_value(std::ostream &out, const T &v)
+{
+    out.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+template<class T> bool read_value(std::istream &in, T &v)
+{
+    return bool(in.read(reinterpret_cast<char *>(&v), sizeof(T)));
+}
+
+} // namespace
+
+NFPCache &NFPCache::instance()
+{
+    static NFPCache cache;
+
+    return cache;
+}
+
+uint64_t NFPCache::outline_hash(const Polygons &outline)
+{
+    uint64_t h = hash_value(FNVOffset, int64_t(outline.size()));
+    for (const Polygon &poly : outline) {
+        h = hash_value(h, int64_t(poly.size()));
+        for (const Point &p : poly.points) {
+            h = hash_value(h, int64_t(p.x()));
+            h = hash_value(h, int64_t(p.y()));
+        }
+    }
+
+    return h;
+}
+
+size_t NFPCache::KeyHash::operator()(const Key &k) const noexcept
+{
+    uint64_t h = hash_value(FNVOffset, int64_t(k.fixed_hash));
+    h = hash_bytes(h, &k.fixed_rotation, sizeof(double));
+    h = hash_value(h, int64_t(k.movable_hash));
+    h = hash_bytes(h, &k.movable_rotation, sizeof(double));
+
+    return size_t(h);
+}
+
+bool NFPCache::find(const Key &key, Polygons &nfp) const
+{
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_nfps.find(key);
+        if (it != m_nfps.end()) {
+            nfp = it->second;
+            ++ m_hits;
+            return true;
+        }
+    }
+
+    ++ m_misses;
+
+    return false;
+}
+
+void NFPCache::insert(const Key &key, Polygons nfp)
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_nfps.size() >= m_max_size) {
+        BOOST_LOG_TRIVIAL(debug) << "NFP cache is full, clearing " << m_nfps.size() << " entries";
+        m_nfps.clear();
+    }
+
+    m_nfps.insert_or_assign(key, std::move(nfp));
+}
+
+void NFPCache::clear()
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_nfps.clear();
+}
+
+size_t NFPCache::size() const
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_nfps.size();
+}
+
+bool NFPCache::load(const std::string &path)
+{
+    boost::nowide::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    char     magic[sizeof(CacheFileMagic)];
+    uint32_t version = 0;
+    uint64_t count   = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CacheFileMagic, sizeof(magic)) != 0 ||
+        !read_value(in, version) || version != CacheFileVersion || !read_value(in, count)) {
+        BOOST_LOG_TRIVIAL(warning) << "Not a valid NFP cache file: " << path;
+        return false;
+    }
+
+    std::vector<std::pair<Key, Polygons>> entries;
+    entries.reserve(size_t(std::min<uint64_t>(count, m_max_size)));
+    for (uint64_t i = 0; i < count; ++ i) {
+        Key      key;
+        uint64_t num_polys = 0;
+        if (!read_value(in, key.fixed_hash) || !read_value(in, key.fixed_rotation) ||
+            !read_value(in, key.movable_hash) || !read_value(in, key.movable_rotation) ||
+            !read_value(in, num_polys)) {
+            BOOST_LOG_TRIVIAL(warning) << "Truncated NFP cache file: " << path;
+            return false;
+        }
+
+        Polygons nfp;
+        for (uint64_t j = 0; j < num_polys; ++ j) {
+            uint64_t num_points = 0;
+            if (!read_value(in, num_points) || num_points > MaxPolygonSize) {
+                BOOST_LOG_TRIVIAL(warning) << "Corrupted NFP cache file: " << path;
+                return false;
+            }
+
+            Polygon &poly = nfp.emplace_back();
+            poly.points.resize(size_t(num_points));
+            if (!in.read(reinterpret_cast<char *>(poly.points.data()), std::streamsize(num_points * sizeof(Point)))) {
+                BOOST_LOG_TRIVIAL(warning) << "Truncated NFP cache file: " << path;
+                return false;
+            }
+        }
+
+        entries.emplace_back(key, std::move(nfp));
+    }
+
+    for (auto &[key, nfp] : entries)
+        insert(key, std::move(nfp));
+
+    BOOST_LOG_TRIVIAL(info) << "Loaded " << entries.size() << " no-fit polygons from " << path;
+
+    return true;
+}
+
+void NFPCache::save(const std::string &path) const
+{
+    boost::nowide::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw Slic3r::FileIOError(std::string("Cannot open the NFP cache file for writing: ") + path);
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+
+    out.write(CacheFileMagic, sizeof(CacheFileMagic));
+    write_value(out, CacheFileVersion);
+    write_value(out, uint64_t(m_nfps.size()));
+    for (const auto &[key, nfp] : m_nfps) {
+        write_value(out, key.fixed_hash);
+        write_value(out, key.fixed_rotation);
+        write_value(out, key.movable_hash);
+        write_value(out, key.movable_rotation);
+        write_value(out, uint64_t(nfp.size()));
+        for (const Polygon &poly : nfp) {
+            write_value(out, uint64_t(poly.size()));
+            out.write(reinterpret_cast<const char *>(poly.points.data()), std::streamsize(poly.size() * sizeof(Point)));
+        }
+    }
+
+    out.close();
+    if (!out)
+        throw Slic3r::FileIOError(std::string("Failed to write the NFP cache file: ") + path);
+}
+
+}} // namespace Slic3r::arr2
@@ -21,6 +21,7 @@ struct Settings {
     int   xl_align;
     int   geom_handling;
     int   arr_strategy;
+    bool  speculative;
 };
 
 static void read_settings(Settings &s, const arr2::ArrangeSettingsDb *db)
@@ -32,6 +33,7 @@ static void read_settings(Settings &s, const arr2::ArrangeSettingsDb *db)
     s.xl_align  = db->get_xl_alignment();
     s.geom_handling = db->get_geometry_handling();
     s.arr_strategy = db->get_arrange_strategy();
+    s.speculative = db->is_speculative_packing_enabled();
 }
 
 ArrangeSettingsDialogImgui::ArrangeSettingsDialogImgui(
@@ -118,6 +120,11 @@ void ArrangeSettingsDialogImgui::render(float pos_x, float pos_y, bool current_b
                         settings.geom_handling));
         }
 
+        // TRN ArrangeDialog: Objects are placed concurrently, the result may differ from the sequential placement.
+        if (ImGuiPureWrap::checkbox(_u8L("Parallel packing"), settings.speculative)) {
+            m_db->set_speculative_packing(settings.speculative);
+        }
+
         ImGui::Separator();
 
         if (ImGuiPureWrap::button(_u8L("Reset defaults"))) {
@@ -130,6 +137,7 @@ void ArrangeSettingsDialogImgui::render(float pos_x, float pos_y, bool current_b
 
             m_db->set_geometry_handling(df.geom_handling);
             m_db->set_arrange_strategy(df.arr_strategy);
+            m_db->set_speculative_packing(df.speculative);
 
             if (m_on_reset_btn)
                 m_on_reset_btn();
@@ -56,6 +56,7 @@ public:
     XLPivots get_xl_alignment() const override { return m_db->get_xl_alignment(); }
     GeometryHandling get_geometry_handling() const override { return m_db->get_geometry_handling(); }
     ArrangeStrategy get_arrange_strategy() const override { return arr2::ArrangeSettingsView::asAuto; }
+    bool is_speculative_packing_enabled() const override { return m_db->is_speculative_packing_enabled(); }
 };
 
 }} // namespace Slic3r::GUI
@@ -368,7 +368,8 @@ void ConfigManipulation::toggle_print_fff_options(DynamicPrintConfig* config)
                                       config->opt_int("support_material_enforce_layers") > 0);
     for (const std::string& key : { "support_tree_angle", "support_tree_angle_slow", "support_tree_branch_diameter",
                                     "support_tree_branch_diameter_angle", "support_tree_branch_diameter_double_wall", 
-                                    "support_tree_tip_diameter", "support_tree_branch_distance", "support_tree_top_rate" })
+                                    "support_tree_tip_diameter", "support_tree_branch_distance", "support_tree_top_rate",
+                                    "support_tree_collision_backend" })
         toggle_field(key, has_organic_supports);
 
     for (auto el : { "support_material_bottom_interface_layers", "support_material_interface_spacing", "support_material_interface_extruder",
@@ -6035,11 +6035,12 @@ void Plater::export_stl_obj(bool extended, bool selection_only)
                               csg::mpartsPositive | csg::mpartsNegative | csg::mpartsDoSplits);
 
         auto csgrange = range(csgmesh);
+        csg::CGALMeshCache cgalcache;
         if (csg::is_all_positive(csgrange)) {
             mesh = TriangleMesh{csg::csgmesh_merge_positive_parts(csgrange)};
-        } else if (csg::check_csgmesh_booleans(csgrange) == csgrange.end()) {
+        } else if (csg::check_csgmesh_booleans(csgrange, cgalcache) == csgrange.end()) {
             try {
-                auto cgalm = csg::perform_csgmesh_booleans(csgrange);
+                auto cgalm = csg::perform_csgmesh_booleans(csgrange, cgalcache);
                 mesh = MeshBoolean::cgal::cgal_to_triangle_mesh(*cgalm);
             } catch (...) {}
         }
@@ -6310,13 +6311,15 @@ bool Plater::export_3mf(const boost::filesystem::path& output_path)
     const std::string path_u8 = into_u8(path);
     wxBusyCursor wait;
     bool full_pathnames = wxGetApp().app_config->get_bool("export_sources_full_pathnames");
+    ThreeMFCompression compression = ThreeMFCompression::Default;
+    ConfigOptionEnum<ThreeMFCompression>::from_string(wxGetApp().app_config->get("export_3mf_compression"), compression);
     ThumbnailData thumbnail_data;
     ThumbnailsParams thumbnail_params = { {}, false, true, true, true };
     p->generate_thumbnail(thumbnail_data, THUMBNAIL_SIZE_3MF.first, THUMBNAIL_SIZE_3MF.second, thumbnail_params, Camera::EType::Ortho);
     bool ret = false;
     try
     {
-        ret = Slic3r::store_3mf(path_u8.c_str(), &p->model, export_config ? &cfg : nullptr, full_pathnames, &thumbnail_data);
+        ret = Slic3r::store_3mf(path_u8.c_str(), &p->model, export_config ? &cfg : nullptr, full_pathnames, &thumbnail_data, true, compression);
     }
     catch (boost::filesystem::filesystem_error& e)
     {
@@ -14,6 +14,7 @@
 #include "I18N.hpp"
 #include "format.hpp"
 #include "libslic3r/AppConfig.hpp"
+#include "libslic3r/Format/3mf.hpp"
 #include <wx/notebook.h>
 #include "Notebook.hpp"
 #include "ButtonsDescription.hpp"
@@ -127,6 +128,11 @@ void PreferencesDialog::show(const std::string& highlight_opt_key /*= std::strin
 		boost::any val = s_keys_map_NotifyReleaseMode.at(wxGetApp().app_config->get("notify_release"));
 		m_optgroup_gui->get_field("notify_release")->set_value(val, false);
 	}
+	// set Field for export_3mf_compression to its value
+	if (m_optgroup_general && m_optgroup_general->get_field("export_3mf_compression") != nullptr) {
+		boost::any val = ConfigOptionEnum<ThreeMFCompression>::get_enum_values().at(wxGetApp().app_config->get("export_3mf_compression"));
+		m_optgroup_general->get_field("export_3mf_compression")->set_value(val, false);
+	}
 	
 
 	if (wxGetApp().is_editor()) {
@@ -282,6 +288,15 @@ void PreferencesDialog::build()
 	// Add "General" tab
 	m_optgroup_general = create_options_tab(L("General"), tabs);
 	m_optgroup_general->on_change = [this](t_config_option_key opt_key, boost::any value) {
+		if (opt_key == "export_3mf_compression") {
+			int val_int = boost::any_cast<int>(value);
+			for (const auto& item : ConfigOptionEnum<ThreeMFCompression>::get_enum_values()) {
+				if (item.second == val_int) {
+					m_values[opt_key] = item.first;
+					return;
+				}
+			}
+		}
 		if (auto it = m_values.find(opt_key); it != m_values.end()) {
 			m_values.erase(it); // we shouldn't change value, if some of those parameters were selected, and then deselected
 			return;
@@ -324,6 +339,18 @@ void PreferencesDialog::build()
 			L("If enabled, allows the Reload from disk command to automatically find and load the files when invoked."),
 			app_config->get_bool("export_sources_full_pathnames"));
 
+		append_enum_option<ThreeMFCompression>(m_optgroup_general, "export_3mf_compression",
+			L("Compression of the saved projects"),
+			L("Compression of the files stored into 3mf projects. Store = no compression, the fastest save. "
+			  "Best = the smallest file, the slowest save."),
+			new ConfigOptionEnum<ThreeMFCompression>(static_cast<ThreeMFCompression>(
+				ConfigOptionEnum<ThreeMFCompression>::get_enum_values().at(app_config->get("export_3mf_compression")))),
+			{ { "store", L("Store") },
+			  { "fast", L("Fast") },
+			  { "default", L("Default") },
+			  { "best", L("Best") }
+			});
+
 #ifdef _WIN32
 		// Please keep in sync with ConfigWizard
 		append_bool_option(m_optgroup_general, "associate_3mf",
@@ -458,6 +485,12 @@ void PreferencesDialog::build()
 
 	activate_options_tab(m_optgroup_general);
 
+	if (is_editor) {
+		// set Field for export_3mf_compression to its value to activate the object
+		boost::any val = ConfigOptionEnum<ThreeMFCompression>::get_enum_values().at(app_config->get("export_3mf_compression"));
+		m_optgroup_general->get_field("export_3mf_compression")->set_value(val, false);
+	}
+
 	// Add "Camera" tab
 	m_optgroup_camera = create_options_tab(L("Camera"), tabs);
 	m_optgroup_camera->on_change = [this](t_config_option_key opt_key, boost::any value) {
@@ -859,6 +892,10 @@ void PreferencesDialog::revert(wxEvent&)
 			m_optgroup_gui->set_value(key, s_keys_map_NotifyReleaseMode.at(app_config->get(key)));
 			continue;
 		}
+		if (key == "export_3mf_compression") {
+			m_optgroup_general->set_value(key, ConfigOptionEnum<ThreeMFCompression>::get_enum_values().at(app_config->get(key)));
+			continue;
+		}
 		if (key == "old_settings_layout_mode") {
 			m_rb_old_settings_layout_mode->SetValue(app_config->get_bool(key));
 			m_settings_layout_changed = false;
@@ -1580,6 +1580,7 @@ void TabPrint::build()
         optgroup->append_single_option_line("support_tree_tip_diameter", path);
         optgroup->append_single_option_line("support_tree_branch_distance", path);
         optgroup->append_single_option_line("support_tree_top_rate", path);
+        optgroup->append_single_option_line("support_tree_collision_backend", path);
 
     page = add_options_page(L("Speed"), "time");
         optgroup = page->new_optgroup(L("Speed for print moves"));
@@ -3019,6 +3020,7 @@ void TabPrinter::build_sla()
     optgroup = page->new_optgroup(L("Output"));
     optgroup->append_single_option_line("sla_archive_format");
     optgroup->append_single_option_line("sla_output_precision");
+    optgroup->append_single_option_line("sla_rasterizer");
 
     build_print_host_upload_group(page.get());
 
@@ -1,18 +1,22 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 #include "test_utils.hpp"
 
 #include <libslic3r/Execution/ExecutionSeq.hpp>
 
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeFirstFit.hpp>
+#include <arrange/ArrangeFirstFitSpeculative.hpp>
 #include <arrange/NFP/PackStrategyNFP.hpp>
 #include <arrange/NFP/RectangleOverfitPackingStrategy.hpp>
 #include <arrange/NFP/Kernels/GravityKernel.hpp>
 #include <arrange/NFP/Kernels/TMArrangeKernel.hpp>
 #include <arrange/NFP/NFPConcave_Tesselate.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 
 #include <arrange-wrapper/Items/SimpleArrangeItem.hpp>
 #include <arrange-wrapper/Items/ArrangeItem.hpp>
@@ -548,6 +552,98 @@ TEMPLATE_TEST_CASE("NFP algorithm test", "[arrange2][Slow]",
     }
 }
 
+static double xor_area(const Slic3r::ExPolygons &a, const Slic3r::ExPolygons &b)
+{
+    using namespace Slic3r;
+
+    double ret = 0.;
+    for (const ExPolygon &p : diff_ex(a, b))
+        ret += p.area();
+    for (const ExPolygon &p : diff_ex(b, a))
+        ret += p.area();
+
+    return ret;
+}
+
+TEST_CASE("Cached NFPs should be the same as the calculated ones", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::NFPCache &cache = arr2::NFPCache::instance();
+    cache.clear();
+    cache.reset_statistics();
+
+    arr2::InfiniteBed bed;
+    auto parts = prusa_parts_ex();
+    parts.resize(std::min(parts.size(), size_t(6)));
+
+    auto nfp_of = [&bed, &cache](const ArrangeItem &orbiter, const ArrangeItem &fixed, bool use_cache) {
+        std::array<std::reference_wrapper<const ArrangeItem>, 1> fixed_items = {{fixed}};
+        cache.enabled(use_cache);
+        auto nfp = arr2::calculate_nfp(orbiter, arr2::default_context(fixed_items), bed);
+        cache.enabled(true);
+
+        return nfp;
+    };
+
+    // Allow one unit of rounding per vertex of the no-fit polygon.
+    auto tolerance = [](const ExPolygons &nfp) {
+        double len = 0.;
+        for (const ExPolygon &p : nfp)
+            len += p.contour.length();
+        return len;
+    };
+
+    for (size_t i = 0; i < parts.size(); ++i)
+        for (size_t j = 0; j < parts.size(); ++j) {
+            ArrangeItem fixed = parts[i], orbiter = parts[j];
+            fixed.rotation(PI / 3.);
+            orbiter.rotation(PI / 4.);
+
+            fixed.translation(scaled(Vec2d{10., -20.}));
+            ExPolygons nfp_calc = nfp_of(orbiter, fixed, false);
+            ExPolygons nfp_miss = nfp_of(orbiter, fixed, true);
+            REQUIRE(xor_area(nfp_calc, nfp_miss) <= tolerance(nfp_calc));
+
+            // The cached no-fit polygon is reused for the other positions.
+            fixed.translation(scaled(Vec2d{-35., 50.}));
+            orbiter.translation(scaled(Vec2d{100., 100.}));
+            nfp_calc = nfp_of(orbiter, fixed, false);
+            ExPolygons nfp_hit = nfp_of(orbiter, fixed, true);
+            REQUIRE(xor_area(nfp_calc, nfp_hit) <= tolerance(nfp_calc));
+        }
+
+    // Every pair is calculated at most once, identical parts share the entries.
+    const size_t num_pairs = parts.size() * parts.size();
+    REQUIRE(cache.size() == cache.misses());
+    REQUIRE(cache.misses() <= num_pairs);
+    REQUIRE(cache.hits() + cache.misses() == 2 * num_pairs);
+    const size_t num_cached = cache.size();
+
+    SECTION("Cache survives saving and loading") {
+        auto path = boost::filesystem::temp_directory_path() /
+                    boost::filesystem::unique_path("nfpcache-%%%%-%%%%.bin");
+
+        cache.save(path.string());
+        cache.clear();
+        REQUIRE(cache.load(path.string()));
+        boost::filesystem::remove(path);
+
+        REQUIRE(cache.size() == num_cached);
+
+        ArrangeItem fixed = parts[0], orbiter = parts[1];
+        fixed.rotation(PI / 3.);
+        orbiter.rotation(PI / 4.);
+
+        cache.reset_statistics();
+        ExPolygons nfp_hit = nfp_of(orbiter, fixed, true);
+        REQUIRE(cache.hits() == 1);
+        REQUIRE(xor_area(nfp_of(orbiter, fixed, false), nfp_hit) <= tolerance(nfp_hit));
+    }
+
+    cache.clear();
+    cache.reset_statistics();
+}
+
 TEST_CASE("EdgeCache tests", "[arrange2]") {
     using namespace Slic3r;
 
@@ -1046,6 +1142,102 @@ TEMPLATE_TEST_CASE("RectangleOverfitPackingStrategy test", "[arrange2]",
     }
 }
 
+TEST_CASE("Speculative first fit selection should produce a valid arrangement", "[arrange2]")
+{
+    using namespace Slic3r;
+    using arr2::ArrangeItem;
+
+    namespace firstfit = arr2::firstfit;
+
+    auto bed = arr2::RectangleBed{scaled(100.), scaled(100.)};
+    auto bedbb = bounding_box(bed);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(5, 30);
+
+    auto items = reserve_vector<ArrangeItem>(60);
+    std::generate_n(std::back_inserter(items), 60, [&rng, &dist] {
+        BoundingBox bb{{0, 0}, {scaled(double(dist(rng))), scaled(double(dist(rng)))}};
+        return ArrangeItem{arr2::to_rectangle(bb)};
+    });
+
+    std::vector<ArrangeItem> fixed = {ArrangeItem{arr2::to_rectangle(
+        BoundingBox{{0, 0}, {scaled(50.), scaled(50.)}})}};
+    arr2::set_bed_index(fixed.front(), 1);
+
+    // Force speculation regardless of the number of available threads.
+    firstfit::SpeculativeSelectionStrategy sel{firstfit::DefaultItemCompareFn{},
+                                               firstfit::DefaultOnArrangedFn{},
+                                               arr2::DefaultStopCondition{},
+                                               ex_tbb, size_t(4)};
+
+    bool rectangle_overfit = GENERATE(false, true);
+    if (rectangle_overfit) {
+        arr2::RectangleOverfitPackingStrategy ps{arr2::PackStrategyNFP{arr2::GravityKernel{}}};
+        arr2::arrange(sel, ps, range(items), crange(fixed), bed);
+    } else {
+        arr2::PackStrategyNFP ps{arr2::GravityKernel{}};
+        arr2::arrange(sel, ps, range(items), crange(fixed), bed);
+    }
+
+    INFO("rectangle overfit = " << rectangle_overfit);
+
+    REQUIRE(std::all_of(items.begin(), items.end(), [](const ArrangeItem &itm) {
+        return arr2::is_arranged(itm);
+    }));
+
+    for (const ArrangeItem &itm : items) {
+        BoundingBox bb = arr2::fixed_bounding_box(itm);
+        bb.offset(-SCALED_EPSILON);
+        REQUIRE(bedbb.contains(bb));
+    }
+
+    auto all_items = items;
+    std::copy(fixed.begin(), fixed.end(), std::back_inserter(all_items));
+
+    for (size_t i = 0; i < all_items.size(); ++i)
+        for (size_t j = i + 1; j < all_items.size(); ++j) {
+            if (arr2::get_bed_index(all_items[i]) != arr2::get_bed_index(all_items[j]))
+                continue;
+
+            Polygons isect = intersection(arr2::fixed_outline(all_items[i]),
+                                          arr2::fixed_outline(all_items[j]));
+
+            REQUIRE(area(isect) < scaled<double>(0.01) * scaled<double>(1.));
+        }
+}
+
+TEST_CASE("Sequential and speculative first fit selection on many items", "[arrange2][.Benchmarks]")
+{
+    using namespace Slic3r;
+    using arr2::ArrangeItem;
+
+    namespace firstfit = arr2::firstfit;
+
+    size_t count = GENERATE(100, 500, 1000);
+
+    auto bed = arr2::RectangleBed{scaled(250.), scaled(210.)};
+    auto blueprint = reserve_vector<ArrangeItem>(count);
+    std::generate_n(std::back_inserter(blueprint), count, [] {
+        return ArrangeItem{arr2::to_rectangle(
+            BoundingBox{{0, 0}, {scaled(10.), scaled(10.)}})};
+    });
+
+    arr2::PackStrategyNFP ps{arr2::GravityKernel{}};
+
+    BENCHMARK("sequential " + std::to_string(count)) {
+        auto items = blueprint;
+        arr2::arrange(firstfit::SelectionStrategy{}, ps, range(items), bed);
+        return items.size();
+    };
+
+    BENCHMARK("speculative " + std::to_string(count)) {
+        auto items = blueprint;
+        arr2::arrange(firstfit::SpeculativeSelectionStrategy{}, ps, range(items), bed);
+        return items.size();
+    };
+}
+
 TEMPLATE_TEST_CASE("Test if allowed item rotations are considered", "[arrange2]",
                    Slic3r::arr2::ArrangeItem)
 {
@@ -63,3 +63,42 @@ SCENARIO("Model construction", "[Model]") {
         }
     }
 }
+
+SCENARIO("Transformed bounding data of model volumes are cached", "[Model]") {
+    GIVEN("A model object with two instances of a cube") {
+        Model model;
+        ModelObject *model_object = model.add_object();
+        ModelVolume *volume = model_object->add_volume(make_cube(20., 20., 20.));
+        model_object->add_instance()->set_offset(Vec3d(10., 10., 10.));
+        model_object->add_instance()->set_offset(Vec3d(50., 10., 10.));
+
+        ModelVolume::reset_transformed_cache_statistics();
+
+        WHEN("The instance bounding boxes are requested twice") {
+            BoundingBoxf3 bb1 = model_object->instance_bounding_box(1);
+            BoundingBoxf3 bb2 = model_object->instance_bounding_box(1);
+            THEN("The second one is taken from the cache") {
+                REQUIRE(ModelVolume::transformed_cache_misses() == 1);
+                REQUIRE(ModelVolume::transformed_cache_hits() == 1);
+                REQUIRE(bb1.min.isApprox(bb2.min));
+                REQUIRE(bb1.max.isApprox(bb2.max));
+            }
+            THEN("The instances have their own entries") {
+                BoundingBoxf3 bb0 = model_object->instance_bounding_box(0);
+                REQUIRE(ModelVolume::transformed_cache_misses() == 2);
+                REQUIRE(std::abs(bb1.min.x() - bb0.min.x() - 40.) < EPSILON);
+            }
+        }
+        WHEN("The mesh of the volume is replaced") {
+            BoundingBoxf3 bb_old = model_object->instance_bounding_box(0);
+            volume->set_mesh(make_cube(10., 10., 10.));
+            volume->calculate_convex_hull();
+            BoundingBoxf3 bb_new = model_object->instance_bounding_box(0);
+            THEN("The cached bounding box is not used") {
+                REQUIRE(ModelVolume::transformed_cache_hits() == 0);
+                REQUIRE(std::abs(bb_old.size().x() - 20.) < EPSILON);
+                REQUIRE(std::abs(bb_new.size().x() - 10.) < EPSILON);
+            }
+        }
+    }
+}
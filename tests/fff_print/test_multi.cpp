@@ -6,7 +6,10 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/MultiMaterialSegmentation.hpp"
 #include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleSelector.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include "test_data.hpp"
@@ -269,3 +272,67 @@ SCENARIO("Stacked cubes", "[Multi]")
         }
     }
 }
+
+SCENARIO("Painted segmentation in slabs", "[Multi]")
+{
+    GIVEN("A cube with painted top, bottom and side faces") {
+        auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+            { "nozzle_diameter",        "0.4, 0.4, 0.4" },
+            { "layer_height",           0.2 },
+            { "first_layer_height",     0.2 },
+            { "top_solid_layers",       5 },
+            { "bottom_solid_layers",    5 }
+        });
+
+        Print print;
+        Model model;
+        Test::init_print({ Test::TestMesh::cube_20x20x20 }, print, model, config);
+
+        // The top face is propagated down into the top solid layers, the bottom face up into the bottom solid layers,
+        // one triangle of a side face crosses all the layers diagonally.
+        ModelVolume            *volume = model.objects.front()->volumes.front();
+        const TriangleMesh     &mesh   = volume->mesh();
+        TriangleSelector        selector(mesh);
+        bool                    side_painted = false;
+        for (int facet_idx = 0; facet_idx < int(mesh.its.indices.size()); ++ facet_idx) {
+            const Vec3f normal = its_face_normal(mesh.its, facet_idx);
+            if (normal.z() > 0.5f)
+                selector.set_facet(facet_idx, TriangleStateType::Extruder2);
+            else if (normal.z() < -0.5f)
+                selector.set_facet(facet_idx, TriangleStateType::Extruder3);
+            else if (normal.x() > 0.5f && ! side_painted) {
+                selector.set_facet(facet_idx, TriangleStateType::Extruder2);
+                side_painted = true;
+            }
+        }
+        volume->mm_segmentation_facets.set(selector);
+        print.apply(model, config);
+        print.process();
+
+        const PrintObject &print_object      = *print.objects().front();
+        const size_t       num_layers        = print_object.layers().size();
+        const size_t       num_facets_states = 4;
+        const auto segment = [&print_object, num_facets_states](size_t max_layers_per_slab) {
+            return segmentation_by_painting(print_object, [](const ModelVolume &mv) -> ModelVolumeFacetsInfo {
+                return { mv.mm_segmentation_facets, mv.is_mm_painted(), false };
+            }, num_facets_states, 0.f, 0.f, false, IncludeTopAndBottomLayers::Yes, []() {}, max_layers_per_slab);
+        };
+
+        const std::vector<std::vector<ExPolygons>> at_once = segment(num_layers);
+        REQUIRE(num_layers == 100);
+        REQUIRE(at_once.size() == num_layers);
+        REQUIRE(! at_once[num_layers - 3][size_t(TriangleStateType::Extruder2)].empty());
+        REQUIRE(! at_once[2][size_t(TriangleStateType::Extruder3)].empty());
+
+        WHEN("The layers are segmented in slabs, which split the top and bottom solid layers") {
+            // Slabs of 3 layers split both the bottom and the top solid layers, the last slab of 97 layers
+            // splits the top solid layers only.
+            THEN("The segmentation is the same as when segmenting all the layers at once") {
+                for (size_t max_layers_per_slab : { size_t(3), size_t(97) }) {
+                    INFO("max_layers_per_slab = " << max_layers_per_slab);
+                    REQUIRE(segment(max_layers_per_slab) == at_once);
+                }
+            }
+        }
+    }
+}
@@ -3,6 +3,9 @@
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/PrintSnapshot.hpp"
+
+#include <boost/filesystem.hpp>
 
 #include "test_data.hpp"
 
@@ -185,3 +188,54 @@ SCENARIO("Ported from Perl", "[Print]") {
         }
     }
 }
+
+SCENARIO("Print: Snapshot", "[Print]") {
+    // Strip the header line with the time stamp.
+    auto strip_header = [](std::string gcode) { return gcode.substr(gcode.find('\n') + 1); };
+
+    GIVEN("Overhang with supports, sliced and stored into a snapshot") {
+        Print print;
+        Model model;
+        Slic3r::Test::init_print({ TestMesh::overhang }, print, model, {
+            { "support_material", true },
+            { "skirts",           1 }
+        });
+        const std::string gcode = strip_header(Slic3r::Test::gcode(print));
+        boost::filesystem::path path = boost::filesystem::unique_path();
+        PrintSnapshot::save(print, path.string());
+
+        WHEN("the snapshot is loaded with the same configuration") {
+            Print print2;
+            PrintSnapshot::load(path.string(), print2, model, print.full_print_config());
+            THEN("the object steps are not recalculated") {
+                REQUIRE(print2.objects().front()->is_step_done(posSupportMaterial));
+                REQUIRE(print2.objects().front()->layers().size() == print.objects().front()->layers().size());
+                REQUIRE(print2.objects().front()->support_layers().size() == print.objects().front()->support_layers().size());
+            }
+            THEN("the same G-code is exported") {
+                REQUIRE(strip_header(Slic3r::Test::gcode(print2)) == gcode);
+            }
+        }
+        WHEN("the snapshot is loaded with a changed start G-code") {
+            DynamicPrintConfig config = print.full_print_config();
+            config.set_deserialize_strict("start_gcode", "; start of the snapshot print");
+            Print print2;
+            PrintSnapshot::load(path.string(), print2, model, config);
+            THEN("the object steps are not recalculated") {
+                REQUIRE(print2.objects().front()->is_step_done(posInfill));
+            }
+            THEN("the changed start G-code is exported") {
+                REQUIRE(Slic3r::Test::contains(Slic3r::Test::gcode(print2), "; start of the snapshot print"));
+            }
+        }
+        WHEN("the snapshot is loaded for a different model") {
+            Model model2(model);
+            model2.objects.front()->scale(1.1);
+            Print print2;
+            THEN("loading fails") {
+                REQUIRE_THROWS_AS(PrintSnapshot::load(path.string(), print2, model2, print.full_print_config()), Slic3r::RuntimeError);
+            }
+        }
+        boost::filesystem::remove(path);
+    }
+}
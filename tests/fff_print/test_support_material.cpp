@@ -1,7 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 
+#include "libslic3r/BuildVolume.hpp"
 #include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/Support/TreeModelVolumes.hpp"
 
 #include "test_data.hpp" // get access to init_print, etc
 
@@ -495,3 +498,172 @@ Old Perl tests, which were disabled by Vojtech at the time of first Support Gene
 }
 
 */
+
+TEST_CASE("SupportMaterial: tree support collision distance field matches collision polygons", "[SupportMaterial]")
+{
+    using namespace Slic3r::FFFTreeSupport;
+    Slic3r::Print print;
+    Slic3r::Test::init_and_process_print({ TestMesh::overhang }, print, {
+        { "support_material",       1 },
+        { "support_material_style", "organic" }
+    });
+    const PrintObject &print_object = *print.objects().front();
+    TreeSupportMeshGroupSettings mesh_settings(print_object);
+    const TreeSupportSettings config{ mesh_settings, print_object.slicing_parameters() };
+    const BuildVolume build_volume(Pointfs{ Vec2d{ -300., -300. }, Vec2d{ -300., +300. }, Vec2d{ +300., +300. }, Vec2d{ +300., -300. } }, 0.);
+    TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, 0 };
+
+    const LayerIndex layer_idx    = LayerIndex(print_object.layer_count() / 2);
+    const coord_t    radius       = volumes.ceilRadius(scaled<coord_t>(0.4), true);
+    const Polygons  &collision    = volumes.getCollision(radius, layer_idx, true);
+    const double     tolerance    = scaled<double>(0.1);
+    REQUIRE(! collision.empty());
+
+    BoundingBox bbox = get_extents(collision);
+    bbox.offset(scaled<coord_t>(2.));
+    const coord_t step = scaled<coord_t>(0.25);
+    size_t num_inside = 0;
+    size_t num_mismatched = 0;
+    for (coord_t y = bbox.min.y(); y < bbox.max.y(); y += step)
+        for (coord_t x = bbox.min.x(); x < bbox.max.x(); x += step) {
+            const Point  pt{ x, y };
+            const double dist = volumes.getCollisionSignedDistance(layer_idx, pt);
+            // Skip samples close to the boundary, where polygon simplification and the distance field interpolation differ.
+            if (std::abs(dist - double(radius)) < tolerance)
+                continue;
+            const bool inside = contains(collision, pt);
+            num_inside += inside;
+            if (inside != volumes.collides(layer_idx, pt, radius))
+                ++ num_mismatched;
+        }
+    REQUIRE(num_inside > 0);
+    REQUIRE(num_mismatched == 0);
+}
+
+TEST_CASE("SupportMaterial: tree support point queries through distance fields match polygons", "[SupportMaterial]")
+{
+    using namespace Slic3r::FFFTreeSupport;
+    Slic3r::Print print;
+    Slic3r::Test::init_and_process_print({ TestMesh::overhang }, print, {
+        { "support_material",               1 },
+        { "support_material_style",         "organic" },
+        { "support_tree_collision_backend", "distance_field" }
+    });
+    const PrintObject &print_object = *print.objects().front();
+    TreeSupportMeshGroupSettings mesh_settings(print_object);
+    const TreeSupportSettings config{ mesh_settings, print_object.slicing_parameters() };
+    const BuildVolume build_volume(Pointfs{ Vec2d{ -300., -300. }, Vec2d{ -300., +300. }, Vec2d{ +300., +300. }, Vec2d{ +300., -300. } }, 0.);
+    TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, 0 };
+
+    const LayerIndex layer_idx = LayerIndex(print_object.layer_count() / 2);
+    const coord_t    radius    = config.getRadius(0);
+    const float      tolerance = scaled<float>(0.1);
+
+    // Count the samples, for which the point query does not match the polygons. Samples close to the boundary are skipped,
+    // as there the polygon simplification and the distance field interpolation differ.
+    auto num_mismatched = [tolerance](const Polygons &area, std::function<bool(const Point&)> is_inside) {
+        REQUIRE(! area.empty());
+        const Polygons outer = offset(area, tolerance);
+        const Polygons inner = offset(area, - tolerance);
+        BoundingBox bbox = get_extents(area);
+        bbox.offset(scaled<coord_t>(2.));
+        const coord_t step = scaled<coord_t>(0.25);
+        size_t num_inside = 0;
+        size_t num_mismatched = 0;
+        for (coord_t y = bbox.min.y(); y < bbox.max.y(); y += step)
+            for (coord_t x = bbox.min.x(); x < bbox.max.x(); x += step)
+                if (const Point pt{ x, y }; contains(outer, pt) == contains(inner, pt)) {
+                    const bool inside = contains(area, pt);
+                    num_inside += inside;
+                    if (inside != is_inside(pt))
+                        ++ num_mismatched;
+                }
+        REQUIRE(num_inside > 0);
+        return num_mismatched;
+    };
+
+    SECTION("collision") {
+        for (bool min_xy_dist : { false, true }) {
+            INFO("min_xy_dist " << min_xy_dist);
+            CHECK(num_mismatched(volumes.getCollision(radius, layer_idx, min_xy_dist), 
+                [&](const Point &pt) { return volumes.isInsideCollision(radius, layer_idx, min_xy_dist, pt); }) == 0);
+        }
+    }
+    SECTION("avoidance") {
+        using AvoidanceType = TreeModelVolumes::AvoidanceType;
+        for (AvoidanceType type : { AvoidanceType::Fast, AvoidanceType::FastSafe, AvoidanceType::Slow }) {
+            INFO("avoidance type " << int(type));
+            CHECK(num_mismatched(volumes.getAvoidance(radius, layer_idx, type, false, true), 
+                [&](const Point &pt) { return volumes.isInsideAvoidance(radius, layer_idx, type, false, true, pt); }) == 0);
+        }
+    }
+}
+
+TEST_CASE("SupportMaterial: tree support collision backends benchmark", "[SupportMaterial][.Benchmarks]")
+{
+    using namespace Slic3r::FFFTreeSupport;
+    Slic3r::Print print;
+    Slic3r::Test::init_and_process_print({ TestMesh::ipadstand }, print, {
+        { "support_material",       1 },
+        { "support_material_style", "organic" }
+    });
+    const PrintObject &print_object = *print.objects().front();
+    TreeSupportMeshGroupSettings mesh_settings(print_object);
+    const TreeSupportSettings config{ mesh_settings, print_object.slicing_parameters() };
+    const BuildVolume build_volume(Pointfs{ Vec2d{ -300., -300. }, Vec2d{ -300., +300. }, Vec2d{ +300., +300. }, Vec2d{ +300., -300. } }, 0.);
+
+    // Many distinct branch radii queried at every layer, as done by the Organic smoothing.
+    std::vector<coord_t> radii;
+    for (double r = 0.2; r < 5.; r += 0.1)
+        radii.emplace_back(scaled<coord_t>(r));
+    const LayerIndex num_layers = LayerIndex(print_object.layer_count());
+    const BoundingBox bbox = get_extents(print_object.layers()[num_layers / 2]->lslices);
+    std::vector<Point> samples;
+    for (coord_t y = bbox.min.y(); y < bbox.max.y(); y += scaled<coord_t>(1.))
+        for (coord_t x = bbox.min.x(); x < bbox.max.x(); x += scaled<coord_t>(1.))
+            samples.emplace_back(x, y);
+
+    BENCHMARK("Polygon caches") {
+        TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, 0 };
+        size_t num_collisions = 0;
+        for (LayerIndex layer_idx = 0; layer_idx < num_layers; ++ layer_idx)
+            for (coord_t radius : radii) {
+                const Polygons &collision = volumes.getCollision(radius, layer_idx, true);
+                for (const Point &pt : samples)
+                    num_collisions += contains(collision, pt);
+            }
+        return num_collisions;
+    };
+
+    BENCHMARK("Distance field") {
+        TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, 0 };
+        size_t num_collisions = 0;
+        for (LayerIndex layer_idx = 0; layer_idx < num_layers; ++ layer_idx)
+            for (coord_t radius : radii)
+                for (const Point &pt : samples)
+                    num_collisions += volumes.collides(layer_idx, pt, radius);
+        return num_collisions;
+    };
+}
+
+TEST_CASE("SupportMaterial: organic support collision backends benchmark", "[SupportMaterial][.Benchmarks]")
+{
+    // The lower half of the sphere is supported by a dense forest of branches.
+    auto generate = [](const char *backend) {
+        Slic3r::Print print;
+        Slic3r::Test::init_and_process_print({ TestMesh::sphere_50mm }, print, {
+            { "support_material",               1 },
+            { "support_material_style",         "organic" },
+            { "support_tree_collision_backend", backend }
+        });
+        return print.objects().front()->support_layers().size();
+    };
+
+    BENCHMARK("Polygon caches") {
+        return generate("polygons");
+    };
+
+    BENCHMARK("Distance field") {
+        return generate("distance_field");
+    };
+}
@@ -1,4 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/3mf.hpp"
@@ -133,3 +135,145 @@ SCENARIO("2D convex hull of sinking object", "[3mf]") {
     }
 }
 
+
+SCENARIO("Painted facets string encoding cycle", "[3mf]") {
+    GIVEN("a sphere painted with all the facet states") {
+        Model model;
+        ModelObject *object = model.add_object();
+        ModelVolume *src    = object->add_volume(make_sphere(10., 2. * PI / 32.));
+        ModelVolume *dst    = object->add_volume(src->mesh());
+
+        TriangleSelector selector(src->mesh());
+        const int num_facets = int(src->mesh().its.indices.size());
+        for (int facet_idx = 0; facet_idx < num_facets; ++ facet_idx)
+            selector.set_facet(facet_idx, TriangleStateType(facet_idx % int(TriangleStateType::Count)));
+        src->mm_segmentation_facets.set(selector);
+
+        WHEN("facets are converted to strings as for 3MF export and read back") {
+            dst->mm_segmentation_facets.reserve(num_facets);
+            for (int facet_idx = 0; facet_idx < num_facets; ++ facet_idx)
+                dst->mm_segmentation_facets.set_triangle_from_string(facet_idx, src->mm_segmentation_facets.get_triangle_as_string(facet_idx));
+            dst->mm_segmentation_facets.shrink_to_fit();
+
+            THEN("the splitting data are identical") {
+                REQUIRE(dst->mm_segmentation_facets.get_data() == src->mm_segmentation_facets.get_data());
+            }
+            THEN("the deserialized selector reproduces the painting") {
+                TriangleSelector loaded(dst->mesh());
+                loaded.deserialize(dst->mm_segmentation_facets.get_data());
+                for (int state = 0; state < int(TriangleStateType::Count); ++ state)
+                    REQUIRE(loaded.num_facets(TriangleStateType(state)) == selector.num_facets(TriangleStateType(state)));
+            }
+        }
+    }
+}
+
+// Model of multiple painted objects, each of them being loaded into its own volume by the 3MF importer.
+static Model make_painted_objects_model(int num_objects, double angle_step)
+{
+    Model model;
+    for (int object_idx = 0; object_idx < num_objects; ++ object_idx) {
+        ModelObject *object = model.add_object();
+        object->name = "sphere_" + std::to_string(object_idx);
+        ModelVolume *volume = object->add_volume(make_sphere(5. + object_idx, angle_step));
+        TriangleSelector selector(volume->mesh());
+        const int num_facets = int(volume->mesh().its.indices.size());
+        for (int facet_idx = object_idx % 3; facet_idx < num_facets; facet_idx += 3)
+            selector.set_facet(facet_idx, TriangleStateType::ENFORCER);
+        volume->supported_facets.set(selector);
+        object->add_instance()->set_offset(Vec3d(30. * object_idx, 0., 0.));
+    }
+    return model;
+}
+
+SCENARIO("Export+Import of multiple painted objects to/from 3mf file cycle", "[3mf]") {
+    GIVEN("a model of painted objects") {
+        Model src_model = make_painted_objects_model(6, 2. * PI / 24.);
+
+        WHEN("model is saved+loaded to/from 3mf file") {
+            std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/painted_objects.3mf";
+            store_3mf(test_file.c_str(), &src_model, nullptr, false);
+
+            Model dst_model;
+            DynamicPrintConfig dst_config;
+            bool loaded;
+            {
+                ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+                boost::optional<Semver> version;
+                loaded = load_3mf(test_file.c_str(), dst_config, ctxt, &dst_model, false, version);
+            }
+            boost::filesystem::remove(test_file);
+
+            THEN("all the objects are loaded in their order with their meshes and painting") {
+                REQUIRE(loaded);
+                REQUIRE(dst_model.objects.size() == src_model.objects.size());
+                for (size_t object_idx = 0; object_idx < src_model.objects.size(); ++ object_idx) {
+                    const ModelObject &src_object = *src_model.objects[object_idx];
+                    const ModelObject &dst_object = *dst_model.objects[object_idx];
+                    REQUIRE(dst_object.name == src_object.name);
+                    REQUIRE(dst_object.volumes.size() == 1);
+                    const ModelVolume &src_volume = *src_object.volumes.front();
+                    const ModelVolume &dst_volume = *dst_object.volumes.front();
+                    REQUIRE(dst_volume.mesh().its.indices == src_volume.mesh().its.indices);
+                    REQUIRE(dst_volume.supported_facets.get_data() == src_volume.supported_facets.get_data());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Export+Import of large painted meshes with all compression levels", "[3mf]") {
+    GIVEN("a model of painted objects, which are exported in multiple chunks") {
+        Model src_model = make_painted_objects_model(2, 2. * PI / 360.);
+        const ThreeMFCompression compression = GENERATE(ThreeMFCompression::Store, ThreeMFCompression::Fast, ThreeMFCompression::Default, ThreeMFCompression::Best);
+
+        WHEN("model is saved+loaded to/from 3mf file") {
+            std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/large_painted_objects.3mf";
+            bool stored = store_3mf(test_file.c_str(), &src_model, nullptr, false, nullptr, true, compression);
+
+            Model dst_model;
+            DynamicPrintConfig dst_config;
+            bool loaded;
+            {
+                ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+                boost::optional<Semver> version;
+                loaded = load_3mf(test_file.c_str(), dst_config, ctxt, &dst_model, false, version);
+            }
+            boost::filesystem::remove(test_file);
+
+            THEN("the meshes and painting are identical") {
+                REQUIRE(stored);
+                REQUIRE(loaded);
+                REQUIRE(dst_model.objects.size() == src_model.objects.size());
+                for (size_t object_idx = 0; object_idx < src_model.objects.size(); ++ object_idx) {
+                    const ModelVolume &src_volume = *src_model.objects[object_idx]->volumes.front();
+                    const ModelVolume &dst_volume = *dst_model.objects[object_idx]->volumes.front();
+                    const indexed_triangle_set &src_its = src_volume.mesh().its;
+                    const indexed_triangle_set &dst_its = dst_volume.mesh().its;
+                    REQUIRE(dst_its.indices == src_its.indices);
+                    REQUIRE(dst_its.vertices.size() == src_its.vertices.size());
+                    for (size_t i = 0; i < src_its.vertices.size(); ++ i)
+                        REQUIRE(dst_its.vertices[i] == src_its.vertices[i]);
+                    REQUIRE(dst_volume.supported_facets.get_data() == src_volume.supported_facets.get_data());
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("3MF loading", "[3mf][.Benchmarks]") {
+    Model src_model = make_painted_objects_model(16, 2. * PI / 360.);
+    const std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/painted_objects_benchmark.3mf";
+    store_3mf(test_file.c_str(), &src_model, nullptr, false);
+
+    BENCHMARK("16 painted spheres") {
+        Model model;
+        DynamicPrintConfig config;
+        ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+        boost::optional<Semver> version;
+        load_3mf(test_file.c_str(), config, ctxt, &model, false, version);
+        return model.objects.size();
+    };
+
+    boost::filesystem::remove(test_file);
+}
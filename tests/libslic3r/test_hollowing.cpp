@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include "libslic3r/SLA/Hollowing.hpp"
 
@@ -19,3 +20,67 @@ TEST_CASE("Hollow two overlapping spheres") {
     sphere1.WriteOBJFile("twospheres.obj");
 }
 
+TEST_CASE("Tiled hollowing matches hollowing at once") {
+    using namespace Slic3r;
+
+    indexed_triangle_set cube = its_make_cube(40., 40., 40.);
+
+    sla::HollowingConfig hcfg;
+    sla::InteriorPtr interior = sla::generate_interior(cube, hcfg);
+    REQUIRE(interior);
+
+    hcfg.tile_size = 15.;
+    sla::InteriorPtr interior_tiled = sla::generate_interior(cube, hcfg);
+    REQUIRE(interior_tiled);
+
+    const indexed_triangle_set &its       = sla::get_mesh(*interior);
+    const indexed_triangle_set &its_tiled = sla::get_mesh(*interior_tiled);
+
+    // The tile meshes are stitched together on their boundaries.
+    REQUIRE(its_num_open_edges(its_tiled) == 0);
+    REQUIRE(its_volume(its_tiled) == Catch::Approx(its_volume(its)).epsilon(0.01));
+
+    BoundingBoxf3 bb = bounding_box(its), bb_tiled = bounding_box(its_tiled);
+    REQUIRE((bb.min - bb_tiled.min).norm() < 0.1);
+    REQUIRE((bb.max - bb_tiled.max).norm() < 0.1);
+}
+
+TEST_CASE("Tiled hollowing of a large part keeps the walls and bounds the memory") {
+    using namespace Slic3r;
+
+    constexpr double a = 120.;
+    indexed_triangle_set cube = its_make_cube(a, a, a);
+    double vol = its_volume(cube);
+
+    // Without tiling, the voxel scale is reduced for a part of this size.
+    sla::HollowingConfig hcfg, hcfg_tiled;
+    hcfg_tiled.tile_size = 30.;
+    REQUIRE(sla::get_voxel_scale(vol, hcfg_tiled) > sla::get_voxel_scale(vol, hcfg));
+
+    // The lowest quality gives the same voxel scale to both, so that the
+    // memory is compared for the same grid resolution.
+    hcfg.quality = hcfg_tiled.quality = 0.;
+    hcfg_tiled.max_parallel_tiles = 2;
+    double voxel = 1. / sla::get_voxel_scale(vol, hcfg_tiled);
+
+    sla::InteriorPtr interior = sla::generate_interior(cube, hcfg);
+    REQUIRE(interior);
+
+    sla::InteriorPtr interior_tiled = sla::generate_interior(cube, hcfg_tiled);
+    REQUIRE(interior_tiled);
+
+    const indexed_triangle_set &its_tiled = sla::get_mesh(*interior_tiled);
+    REQUIRE(its_num_open_edges(its_tiled) == 0);
+
+    double t = hcfg_tiled.min_thickness;
+    BoundingBoxf3 bb_tiled = bounding_box(its_tiled);
+    for (int i = 0; i < 3; ++i) {
+        CHECK(bb_tiled.min(i) == Catch::Approx(t).margin(voxel));
+        CHECK(bb_tiled.max(i) == Catch::Approx(a - t).margin(voxel));
+    }
+
+    CHECK(its_volume(its_tiled) == Catch::Approx(std::pow(a - 2. * t, 3)).epsilon(0.02));
+
+    CHECK(sla::get_peak_grid_memory(*interior_tiled) <
+          sla::get_peak_grid_memory(*interior) / 2);
+}
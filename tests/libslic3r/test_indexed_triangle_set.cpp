@@ -2,6 +2,7 @@
 #include <fstream>
 #include <random>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 
 #include "libslic3r/TriangleMesh.hpp"
 
@@ -29,6 +30,59 @@ TEST_CASE("Split simple mesh consisting of one part", "[its_split][its]") {
     REQUIRE(res.front().vertices.size() == cube.vertices.size());
 }
 
+// Triangle soup: Each face references its own three vertices.
+static indexed_triangle_set its_to_triangle_soup(const indexed_triangle_set &its)
+{
+    indexed_triangle_set out;
+    out.vertices.reserve(its.indices.size() * 3);
+    for (const stl_triangle_vertex_indices &face : its.indices) {
+        out.indices.emplace_back(int(out.vertices.size()), int(out.vertices.size()) + 1, int(out.vertices.size()) + 2);
+        for (int i = 0; i < 3; ++ i)
+            out.vertices.emplace_back(its.vertices[face(i)]);
+    }
+    return out;
+}
+
+TEST_CASE("Merge vertices of a triangle soup", "[its]") {
+    const indexed_triangle_set sphere = its_make_sphere(10., 2 * PI / 100.);
+    indexed_triangle_set       soup   = its_to_triangle_soup(sphere);
+
+    CHECK(its_merge_vertices(soup) == int(sphere.indices.size() * 3 - sphere.vertices.size()));
+    CHECK(soup.vertices.size() == sphere.vertices.size());
+    CHECK(its_num_open_edges(soup) == 0);
+}
+
+TEST_CASE("Parallel face neighbors match the sequential ones", "[its]") {
+    indexed_triangle_set its = its_make_sphere(10., 2 * PI / 100.);
+    CHECK(its_face_neighbors_par(its) == its_face_neighbors(its));
+
+    // Open mesh.
+    its.indices.pop_back();
+    const std::vector<Vec3i> neighbors = its_face_neighbors_par(its);
+    CHECK(neighbors == its_face_neighbors(its));
+    CHECK(its_num_open_edges(neighbors) == 3);
+}
+
+TEST_CASE("Vertex welding and face neighbors", "[its][.Benchmarks]") {
+    // Several millions of faces.
+    const indexed_triangle_set sphere = its_make_sphere(10., 2 * PI / 2000.);
+    const indexed_triangle_set soup   = its_to_triangle_soup(sphere);
+
+    BENCHMARK("its_merge_vertices") {
+        indexed_triangle_set its = soup;
+        return its_merge_vertices(its);
+    };
+    BENCHMARK("its_face_neighbors") {
+        return its_face_neighbors(sphere);
+    };
+    BENCHMARK("its_face_neighbors_par") {
+        return its_face_neighbors_par(sphere);
+    };
+    BENCHMARK("TriangleMesh construction") {
+        return TriangleMesh(sphere);
+    };
+}
+
 void debug_write_obj(const std::vector<indexed_triangle_set> &res, const std::string &name)
 {
 #ifndef NDEBUG
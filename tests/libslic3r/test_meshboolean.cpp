@@ -4,6 +4,7 @@
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/MeshBoolean.hpp>
+#include <libslic3r/CSGMesh/PerformCSGMeshBooleans.hpp>
 
 using namespace Slic3r;
 using namespace Catch;
@@ -51,3 +52,54 @@ TEST_CASE("Add TriangleMeshes", "[MeshBoolean]")
     //its_write_obj(tm1.its, "test_add.obj");
     CHECK(tm1.its.indices.size() > init_size);
 }
+
+TEST_CASE("Batched CSG booleans reuse the checked CGAL meshes", "[MeshBoolean]")
+{
+    indexed_triangle_set body = its_make_cube(20., 20., 20.);
+
+    indexed_triangle_set corner = its_make_cube(10., 10., 10.);
+    its_translate(corner, Vec3f{15.f, 15.f, 15.f});
+
+    indexed_triangle_set opposite_corner = its_make_cube(10., 10., 10.);
+    its_translate(opposite_corner, Vec3f{-5.f, -5.f, -5.f});
+
+    // Does not overlap the body, the difference is skipped.
+    indexed_triangle_set faraway = its_make_cube(10., 10., 10.);
+    its_translate(faraway, Vec3f{100.f, 100.f, 100.f});
+
+    std::vector<csg::CSGPart> parts;
+    parts.emplace_back(&body);
+    parts.emplace_back(&corner, csg::CSGType::Difference);
+    parts.emplace_back(&faraway, csg::CSGType::Difference);
+
+    // body - corner - faraway - (opposite_corner)
+    csg::CSGPart group_begin{{}, csg::CSGType::Difference};
+    group_begin.stack_operation = csg::CSGStackOp::Push;
+    parts.emplace_back(std::move(group_begin));
+    parts.emplace_back(&opposite_corner);
+    csg::CSGPart group_end{{}};
+    group_end.stack_operation = csg::CSGStackOp::Pop;
+    parts.emplace_back(std::move(group_end));
+
+    auto csgrange = range(parts);
+
+    csg::CGALMeshCache cache;
+    REQUIRE(csg::check_csgmesh_booleans(csgrange, cache) == csgrange.end());
+
+    // The push and pop parts without a mesh are not checked
+    REQUIRE(cache.size() == 4);
+    REQUIRE(cache.hits() == 0);
+    REQUIRE(cache.misses() == 4);
+
+    MeshBoolean::cgal::CGALMeshPtr cgalm = csg::perform_csgmesh_booleans(csgrange, cache);
+    REQUIRE(cgalm);
+
+    // Neither are they looked up by the booleans, all the parts with a mesh
+    // are found in the cache.
+    CHECK(cache.size() == 4);
+    CHECK(cache.hits() == 4);
+    CHECK(cache.misses() == 4);
+
+    indexed_triangle_set result = MeshBoolean::cgal::cgal_to_indexed_triangle_set(*cgalm);
+    CHECK(its_volume(result) == Approx(8000. - 125. - 125.));
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Format/OBJ.hpp"
+#include "libslic3r/Format/objparser.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+
+using namespace Slic3r;
+
+// Writes a mesh into an OBJ file, which is large enough to be parsed in multiple chunks.
+// Every other face references its vertices relative to the end of the vertex list,
+// the faces are interleaved with material and group records.
+static std::string write_large_obj(const indexed_triangle_set &its, const char *name)
+{
+    std::string path = std::string(TEST_DATA_DIR) + "/" + name;
+    boost::nowide::ofstream out(path);
+    out << "# large OBJ file\n";
+    for (const Vec3f &v : its.vertices)
+        out << "v " << v.x() << " " << v.y() << " " << v.z() << "\n";
+    const int num_vertices = int(its.vertices.size());
+    for (size_t i = 0; i < its.indices.size(); ++ i) {
+        const Vec3i &face = its.indices[i];
+        if (i % 10000 == 0)
+            out << "usemtl material_" << i << "\ng group_" << i << "\n";
+        if (i % 2 == 0)
+            out << "f " << face.x() + 1 << " " << face.y() + 1 << " " << face.z() + 1 << "\n";
+        else
+            out << "f " << face.x() - num_vertices << " " << face.y() - num_vertices << " " << face.z() - num_vertices << "\r\n";
+    }
+    return path;
+}
+
+TEST_CASE("Chunked OBJ parser matches the stream parser", "[obj]") {
+    const indexed_triangle_set sphere = its_make_sphere(10., 2. * PI / 720.);
+    const std::string path = write_large_obj(sphere, "large_sphere.obj");
+
+    ObjParser::ObjData chunked;
+    ObjParser::ObjData streamed;
+    REQUIRE(ObjParser::objparse(path.c_str(), chunked));
+    {
+        boost::nowide::ifstream in(path, std::ios::binary);
+        REQUIRE(ObjParser::objparse(in, streamed));
+    }
+    REQUIRE(chunked.coordinates.size() == sphere.vertices.size() * 4);
+    REQUIRE(ObjParser::objequal(chunked, streamed));
+
+    TriangleMesh mesh;
+    REQUIRE(load_obj(path.c_str(), &mesh));
+    REQUIRE(mesh.its.indices.size() == sphere.indices.size());
+    REQUIRE(mesh.its.vertices.size() == sphere.vertices.size());
+    bool same_faces = true;
+    for (size_t i = 0; i < sphere.indices.size(); ++ i)
+        same_faces &= mesh.its.indices[i] == sphere.indices[i];
+    REQUIRE(same_faces);
+
+    boost::filesystem::remove(path);
+}
+
+TEST_CASE("OBJ loading", "[obj][.Benchmarks]") {
+    const std::string path = write_large_obj(its_make_sphere(10., 2. * PI / 2000.), "large_sphere_benchmark.obj");
+
+    BENCHMARK("chunked") {
+        ObjParser::ObjData data;
+        ObjParser::objparse(path.c_str(), data);
+        return data.vertices.size();
+    };
+    BENCHMARK("stream") {
+        ObjParser::ObjData data;
+        boost::nowide::ifstream in(path, std::ios::binary);
+        ObjParser::objparse(in, data);
+        return data.vertices.size();
+    };
+
+    boost::filesystem::remove(path);
+}
@@ -7,6 +7,7 @@
 #include <numeric>
 
 #include "libslic3r/PNGReadWrite.hpp"
+#include "libslic3r/miniz_extension.hpp"
 #include "libslic3r/SLA/AGGRaster.hpp"
 #include "libslic3r/BoundingBox.hpp"
 
@@ -56,3 +57,49 @@ TEST_CASE("PNG read", "[PNG]") {
         REQUIRE(sum == rstsum);
     }
 }
+
+TEST_CASE("PNG deflated in parallel blocks", "[PNG]") {
+    // Large enough to be split into multiple blocks of rows.
+    const size_t w = 2000, h = 1200;
+
+    SECTION("Greyscale mask decodes to the original image") {
+        std::vector<uint8_t> mask(w * h);
+        for (size_t r = 0; r < h; ++r)
+            for (size_t c = 0; c < w; ++c)
+                mask[r * w + c] = (c / 7 + r / 5) % 3 == 0 ? 255 : uint8_t((c * r) % 251);
+
+        size_t png_size = 0;
+        void  *png_data = write_png_to_memory_parallel(mask.data(), int(w), int(h), 1, &png_size);
+        REQUIRE(png_data != nullptr);
+
+        png::ImageGreyscale img;
+        REQUIRE(png::decode_png({png_data, png_size}, img));
+        mz_free(png_data);
+
+        REQUIRE(img.rows == h);
+        REQUIRE(img.cols == w);
+        REQUIRE(img.buf == mask);
+    }
+
+    SECTION("Flipped RGBA thumbnail decodes to the original image") {
+        std::vector<uint8_t> rgba(w * h * 4);
+        for (size_t i = 0; i < rgba.size(); ++i)
+            rgba[i] = uint8_t((i * 31) % 256);
+
+        size_t png_size = 0;
+        void  *png_data = write_png_to_memory_parallel(rgba.data(), int(w), int(h), 4, &png_size, MZ_DEFAULT_LEVEL, true);
+        REQUIRE(png_data != nullptr);
+
+        std::vector<unsigned char> decoded;
+        unsigned decoded_w = 0, decoded_h = 0;
+        REQUIRE(png::decode_png(std::string(static_cast<const char*>(png_data), png_size), decoded, decoded_w, decoded_h));
+        mz_free(png_data);
+
+        REQUIRE(decoded_w == w);
+        REQUIRE(decoded_h == h);
+        bool same = true;
+        for (size_t r = 0; r < h; ++r)
+            same &= std::equal(decoded.begin() + r * w * 4, decoded.begin() + (r + 1) * w * 4, rgba.begin() + (h - 1 - r) * w * 4);
+        REQUIRE(same);
+    }
+}
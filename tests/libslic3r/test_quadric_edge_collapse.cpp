@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <igl/qslim.h>
 #include <test_utils.hpp>
 
@@ -302,3 +303,63 @@ TEST_CASE("Simplified cube should not be empty.", "[its]")
     its_quadric_edge_collapse(its, wanted_count, &max_error);
     CHECK(!its.indices.empty());
 }
+
+TEST_CASE("Simplify frog_legs.obj to 5% by parallel Quadric edge collapse", "[its][quadric_edge_collapse]")
+{
+    TriangleMesh mesh         = load_model("frog_legs.obj");
+    uint32_t     wanted_count = mesh.its.indices.size() * 0.05;
+    REQUIRE_FALSE(mesh.empty());
+    indexed_triangle_set its_sequential = mesh.its; // copy
+    its_quadric_edge_collapse(its_sequential, wanted_count);
+
+    // split to 4 partitions
+    uint32_t triangles_per_partition = mesh.its.indices.size() / 4;
+    indexed_triangle_set its = mesh.its; // copy
+    float max_error = std::numeric_limits<float>::max();
+    its_quadric_edge_collapse_parallel(its, wanted_count, &max_error, nullptr, nullptr, triangles_per_partition);
+    CHECK(its.indices.size() == its_sequential.indices.size());
+    CHECK(!Private::exist_triangle_with_twice_vertices(its.indices));
+
+    // error is bounded similarly to the sequential algorithm
+    Private::Similarity sequential = Private::get_similarity(mesh.its, its_sequential);
+    Private::Similarity sequential_back = Private::get_similarity(its_sequential, mesh.its);
+    Private::Similarity limit(1.25f * std::max(sequential.max_distance, sequential_back.max_distance),
+                              1.25f * std::max(sequential.average_distance, sequential_back.average_distance));
+    Private::is_better_similarity(mesh.its, its, limit);
+}
+
+TEST_CASE("Simplify frog_legs.obj by maximal error by parallel Quadric edge collapse", "[its][quadric_edge_collapse]")
+{
+    TriangleMesh mesh = load_model("frog_legs.obj");
+    REQUIRE_FALSE(mesh.empty());
+    const float max_error = 0.01f;
+
+    indexed_triangle_set its_sequential = mesh.its; // copy
+    float sequential_error = max_error;
+    its_quadric_edge_collapse(its_sequential, 0, &sequential_error);
+
+    indexed_triangle_set its = mesh.its; // copy
+    float error = max_error;
+    its_quadric_edge_collapse_parallel(its, 0, &error, nullptr, nullptr, mesh.its.indices.size() / 4);
+    CHECK(error <= max_error);
+    CHECK(!Private::exist_triangle_with_twice_vertices(its.indices));
+    // same amount of edges is bellow the error
+    CHECK(std::abs(double(its.indices.size()) - double(its_sequential.indices.size())) < 0.05 * its_sequential.indices.size());
+}
+
+TEST_CASE("Quadric edge collapse speed", "[its][quadric_edge_collapse][.Benchmarks]")
+{
+    indexed_triangle_set sphere = its_make_sphere(10., 2. * PI / 1000.);
+    uint32_t wanted_count = sphere.indices.size() / 20;
+
+    BENCHMARK("sequential") {
+        indexed_triangle_set its = sphere;
+        its_quadric_edge_collapse(its, wanted_count);
+        return its.indices.size();
+    };
+    BENCHMARK("parallel") {
+        indexed_triangle_set its = sphere;
+        its_quadric_edge_collapse_parallel(its, wanted_count);
+        return its.indices.size();
+    };
+}
@@ -1,6 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include "libslic3r/Model.hpp"
+#include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/Format/STL.hpp"
 
 using namespace Slic3r;
@@ -55,3 +60,72 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+TEST_CASE("Memory mapped STL reader matches admesh", "[stl]") {
+	for (const char *path : { "Geräte/20mmbox-čřšřěá.stl", "ASCII/20mmbox-LF.stl", "ASCII/20mmbox-CRLF.stl", "ASCII/20mmbox-nonstandard.stl" }) {
+		SECTION(path) {
+			TriangleMesh admesh_mesh;
+			REQUIRE(admesh_mesh.ReadSTLFile(stl_path(path).c_str()));
+
+			indexed_triangle_set its;
+			REQUIRE(Slic3r::read_stl(stl_path(path).c_str(), its));
+			TriangleMesh mesh(std::move(its));
+			CHECK(mesh.facets_count() == admesh_mesh.facets_count());
+			CHECK(mesh.its.vertices.size() == admesh_mesh.its.vertices.size());
+			CHECK(mesh.stats().open_edges == 0);
+			CHECK(is_approx(mesh.bounding_box().min, admesh_mesh.bounding_box().min));
+			CHECK(is_approx(mesh.bounding_box().max, admesh_mesh.bounding_box().max));
+			CHECK(std::abs(mesh.volume() - admesh_mesh.volume()) < 1e-3);
+		}
+	}
+}
+
+TEST_CASE("STL loading", "[stl][.Benchmarks]") {
+	const std::string path = stl_path("ASCII/20mmbox-LF.stl");
+	BENCHMARK("admesh") {
+		TriangleMesh mesh;
+		mesh.ReadSTLFile(path.c_str());
+		return mesh;
+	};
+	BENCHMARK("memory mapped") {
+		indexed_triangle_set its;
+		Slic3r::read_stl(path.c_str(), its);
+		return its;
+	};
+}
+
+TEST_CASE("Memory mapped STL reader repairs defects like admesh", "[stl]") {
+	// A cube with a missing facet and a flipped one.
+	indexed_triangle_set cube = its_make_cube(20., 20., 20.);
+	cube.indices.pop_back();
+	std::swap(cube.indices.front()(1), cube.indices.front()(2));
+
+	for (bool binary : { false, true }) {
+		SECTION(binary ? "binary" : "ASCII") {
+			boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("stl-repair-%%%%-%%%%.stl");
+			if (binary)
+				REQUIRE(its_write_stl_binary(path.string().c_str(), "cube", cube));
+			else
+				REQUIRE(its_write_stl_ascii(path.string().c_str(), "cube", cube));
+
+			Slic3r::Model admesh_model;
+			TriangleMesh  admesh_mesh;
+			REQUIRE(admesh_mesh.ReadSTLFile(path.string().c_str()));
+			admesh_model.add_object("cube", path.string().c_str(), std::move(admesh_mesh));
+
+			Slic3r::Model model;
+			REQUIRE(Slic3r::load_stl(path.string().c_str(), &model));
+			boost::filesystem::remove(path);
+
+			const TriangleMesh &expected = admesh_model.objects.front()->volumes.front()->mesh();
+			const TriangleMesh &mesh     = model.objects.front()->volumes.front()->mesh();
+			CHECK(mesh.its.vertices == expected.its.vertices);
+			CHECK(mesh.its.indices == expected.its.indices);
+			CHECK(mesh.stats().open_edges == expected.stats().open_edges);
+			CHECK(mesh.stats().repaired_errors.edges_fixed == expected.stats().repaired_errors.edges_fixed);
+			CHECK(mesh.stats().repaired_errors.facets_removed == expected.stats().repaired_errors.facets_removed);
+			CHECK(mesh.stats().repaired_errors.facets_reversed == expected.stats().repaired_errors.facets_reversed);
+			CHECK(mesh.stats().repaired_errors.backwards_edges == expected.stats().repaired_errors.backwards_edges);
+		}
+	}
+}
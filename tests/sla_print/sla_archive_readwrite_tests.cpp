@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <test_utils.hpp>
 
 #include "libslic3r/SLAPrint.hpp"
@@ -10,6 +11,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <fstream>
+
 using namespace Slic3r;
 
 TEST_CASE("Archive export test", "[sla_archives]") {
@@ -69,3 +72,125 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         }
     }
 }
+
+static void process_padded_cube(SLAPrint &print, const char *archive_format)
+{
+    auto m = FileReader::load_model(TEST_DATA_DIR PATH_SEPARATOR "20mm_cube.obj");
+
+    SLAFullPrintConfig fullcfg;
+    fullcfg.printer_technology.setInt(ptSLA);
+    fullcfg.set("sla_archive_format", archive_format);
+    fullcfg.set("supports_enable", false);
+    fullcfg.set("pad_enable", true);
+    fullcfg.set("pad_around_object", true);
+
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+    print.apply(m, cfg);
+    print.process();
+}
+
+// Offset and size of the image of each layer, read from the layer table of an Anycubic archive.
+static std::vector<std::pair<uint32_t, uint32_t>> anycubic_layer_images(const std::string &fname)
+{
+    std::ifstream in(fname, std::ios::binary);
+    auto read_uint32 = [&in](std::streamoff pos) {
+        unsigned char buf[4];
+        in.seekg(pos);
+        in.read(reinterpret_cast<char*>(buf), 4);
+        return uint32_t(buf[0]) | (uint32_t(buf[1]) << 8) | (uint32_t(buf[2]) << 16) | (uint32_t(buf[3]) << 24);
+    };
+    // The intro is a 12 byte tag followed by 32 bit values, the 7th of them is the offset of the layer table.
+    const uint32_t layer_data_offset = read_uint32(12 + 6 * 4);
+    // The layer table starts with a 12 byte tag, payload size and layer count, followed by 32 byte layer records.
+    const uint32_t layer_count = read_uint32(layer_data_offset + 16);
+    std::vector<std::pair<uint32_t, uint32_t>> out;
+    for (uint32_t i = 0; i < layer_count; ++ i) {
+        const std::streamoff record = layer_data_offset + 20 + 32 * std::streamoff(i);
+        out.emplace_back(read_uint32(record), read_uint32(record + 4));
+    }
+    REQUIRE(in.good());
+    return out;
+}
+
+TEST_CASE("Identical layers are exported only once", "[sla_archives]") {
+    SLAPrint print;
+    process_padded_cube(print, "SL1");
+
+    // Apart from the transitions between the pad and the cube, all the layers of a cube standing on a pad
+    // are identical to the layer below.
+    const auto &layers = print.print_layers();
+    REQUIRE(layers.size() > 10);
+    std::vector<bool> duplicate(layers.size(), false);
+    for (size_t i = 1; i < layers.size(); ++ i)
+        duplicate[i] = layers[i].same_geometry(layers[i - 1]);
+    REQUIRE(size_t(std::count(duplicate.begin(), duplicate.end(), true)) > layers.size() / 2);
+
+    ThumbnailsList thumbnails;
+
+    SECTION("SL1 reads back the duplicate layers") {
+        std::string outputfname = "output_padded_cube.sl1";
+        print.export_print(outputfname, thumbnails, "padded_cube");
+        REQUIRE(boost::filesystem::exists(outputfname));
+
+        indexed_triangle_set its;
+        DynamicPrintConfig cfg;
+        import_sla_archive(outputfname, "", its, cfg);
+
+        // The pad is wider than the cube, thus more than the cube has to be read back.
+        REQUIRE(its_volume(its) > 20. * 20. * 20.);
+        boost::filesystem::remove(outputfname);
+    }
+
+    SECTION("Anycubic duplicate layers share the image of the layer below") {
+        SLAPrint padded;
+        process_padded_cube(padded, "pwmx");
+        REQUIRE(padded.print_layers().size() == layers.size());
+
+        std::string outputfname = "output_padded_cube.pwmx";
+        padded.export_print(outputfname, thumbnails, "padded_cube");
+        REQUIRE(boost::filesystem::exists(outputfname));
+
+        const std::vector<std::pair<uint32_t, uint32_t>> images = anycubic_layer_images(outputfname);
+        REQUIRE(images.size() == layers.size());
+        for (size_t i = 1; i < images.size(); ++ i) {
+            INFO("layer " << i);
+            if (duplicate[i])
+                REQUIRE(images[i] == images[i - 1]);
+            else
+                REQUIRE(images[i].first >= images[i - 1].first + images[i - 1].second);
+        }
+
+        // The same layers exported by an archiver, which is not told about the duplicate layers.
+        std::string outputfname_all = "output_padded_cube_all_layers.pwmx";
+        {
+            const auto &padded_layers = padded.print_layers();
+            auto archiver = SLAArchiveWriter::create("pwmx", padded.printer_config());
+            archiver->draw_layers(padded_layers.size(), 
+                [&padded_layers](sla::RasterBase &raster, size_t idx) { raster.draw(padded_layers[idx].transformed_slices()); },
+                nullptr, []() { return false; });
+            archiver->export_print(outputfname_all, padded, thumbnails, "padded_cube");
+        }
+        const std::vector<std::pair<uint32_t, uint32_t>> images_all = anycubic_layer_images(outputfname_all);
+        REQUIRE(images_all.size() == images.size());
+        for (size_t i = 1; i < images_all.size(); ++ i)
+            REQUIRE(images_all[i].first > images_all[i - 1].first);
+
+        REQUIRE(boost::filesystem::file_size(outputfname) < boost::filesystem::file_size(outputfname_all));
+        boost::filesystem::remove(outputfname);
+        boost::filesystem::remove(outputfname_all);
+    }
+}
+
+TEST_CASE("SLA archive export", "[sla_archives][.Benchmarks]") {
+    SLAPrint print;
+    process_padded_cube(print, "SL1");
+
+    ThumbnailsList thumbnails;
+    BENCHMARK("padded cube") {
+        print.export_print("output_padded_cube_benchmark.sl1", thumbnails, "padded_cube");
+    };
+    boost::filesystem::remove("output_padded_cube_benchmark.sl1");
+}
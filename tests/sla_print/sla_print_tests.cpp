@@ -7,7 +7,15 @@
 
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
+#include <libslic3r/SLA/SupportTreeUtils.hpp>
+#include <libslic3r/SLA/DefaultSupportTree.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/SLA/Rotfinder.hpp>
+#include <libslic3r/SLA/ScanlineRaster.hpp>
+#include <libslic3r/Subdivide.hpp>
+#include <libslic3r/Model.hpp>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 
 namespace {
 
@@ -140,6 +148,111 @@ TEST_CASE("BranchingSupports::FloorSupportsDoNotPierceModel", "[SLASupportGenera
         test_support_model_collision(fname, supportcfg);
 }
 
+TEST_CASE("BranchingSupports::PinheadCacheMatchesFullRebuild", "[SLASupportGeneration][Branching]") {
+    TriangleMesh mesh = load_model("A_upsidedown.obj");
+
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.tree_type = sla::SupportTreeType::Branching;
+
+    sla::SupportableMesh sm{mesh.its, calc_support_pts(mesh), supportcfg};
+    REQUIRE(sm.pts.size() > 2);
+    sm.pinhead_cache = std::make_shared<sla::PinheadCache>();
+
+    sla::create_support_tree(sm, {});
+    REQUIRE(sm.pinhead_cache->size() > 0);
+
+    // Edit the support points as the user would: remove one and move another.
+    sla::SupportPoint removed = sm.pts.back();
+    sm.pts.pop_back();
+    sm.pts.front().pos.z() += 0.5f;
+
+    sla::create_support_tree(sm, {});
+
+    REQUIRE(sm.pinhead_cache->find(removed) == nullptr);
+
+    size_t num_cached = 0;
+    for (size_t i = 0; i < sm.pts.size(); ++i) {
+        const std::optional<sla::Head> *cached = sm.pinhead_cache->find(sm.pts[i]);
+        if (!cached)
+            continue;
+
+        ++num_cached;
+        std::optional<sla::Head> head = sla::calculate_pinhead_placement(ex_seq, sm, i);
+        REQUIRE(cached->has_value() == head.has_value());
+        if (head) {
+            REQUIRE((*cached)->dir == head->dir);
+            REQUIRE((*cached)->pos == head->pos);
+            REQUIRE((*cached)->width_mm == head->width_mm);
+            REQUIRE((*cached)->r_back_mm == head->r_back_mm);
+        }
+    }
+
+    REQUIRE(num_cached > 0);
+}
+
+TEST_CASE("DefaultSupports::SubtreeCacheMatchesFullRebuild", "[SLASupportGeneration]") {
+    // Three cubes far enough from each other to get separate subtrees.
+    TriangleMesh mesh;
+    for (double x : {0., 100., 200.}) {
+        TriangleMesh cube = load_model("20mm_cube.obj");
+        cube.translate(float(x), 0.f, 0.f);
+        mesh.merge(cube);
+    }
+
+    sla::SupportTreeConfig supportcfg;
+    // The model facing routes are built in parallel, the rest of the tree
+    // is deterministic and can be compared exactly.
+    supportcfg.ground_facing_only = true;
+    REQUIRE(sla::SupportSubtreeCache::separation_distance(supportcfg) < 80.);
+
+    sla::SupportableMesh sm{mesh.its, calc_support_pts(mesh), supportcfg};
+    auto cache = std::make_shared<sla::SupportSubtreeCache>();
+    sm.subtree_cache = cache;
+
+    sla::create_support_tree(sm, {});
+    REQUIRE(cache->subtrees().size() == 3);
+    REQUIRE(cache->built_count() == 3);
+    for (const auto &subtree : cache->subtrees())
+        REQUIRE(subtree->pillar_index.size() > 0);
+
+    // Only the subtree of the edited cube is built again and the result is
+    // the same as the one of a build from scratch.
+    auto check_rebuild = [&sm, &cache] {
+        sm.subtree_cache = cache;
+        indexed_triangle_set incremental = sla::create_support_tree(sm, {});
+        REQUIRE(cache->subtrees().size() == 3);
+        REQUIRE(cache->built_count() == 1);
+
+        sm.subtree_cache = std::make_shared<sla::SupportSubtreeCache>();
+        indexed_triangle_set full = sla::create_support_tree(sm, {});
+        REQUIRE(sm.subtree_cache->built_count() == 3);
+
+        REQUIRE_FALSE(full.empty());
+        REQUIRE(incremental.vertices == full.vertices);
+        REQUIRE(incremental.indices == full.indices);
+    };
+
+    auto point_of_cube = [&sm](float x) {
+        auto it = std::find_if(sm.pts.begin(), sm.pts.end(), [x](const sla::SupportPoint &sp) {
+            return sp.pos.x() >= x && sp.pos.x() <= x + 20.f;
+        });
+        REQUIRE(it != sm.pts.end());
+        return it;
+    };
+
+    sla::SupportPoint added = *point_of_cube(0.f);
+    added.pos = Vec3f{10.5f, 10.5f, 0.f};
+    sm.pts.emplace_back(added);
+    check_rebuild();
+
+    auto moved = point_of_cube(100.f);
+    moved->pos.x() += moved->pos.x() < 110.f ? 0.5f : -0.5f;
+    check_rebuild();
+
+    sm.pts.erase(point_of_cube(200.f));
+    check_rebuild();
+}
+
 TEST_CASE("InitializedRasterShouldBeNONEmpty", "[SLARasterOutput]") {
     // Default Prusa SL1 display parameters
     sla::Resolution res{2560, 1440};
@@ -205,6 +318,98 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
     REQUIRE(raster_pxsum(raster0) == 0);
 }
 
+// A layer of disjoint polygons: squares with holes and ellipses of various sizes.
+static ExPolygons scanline_test_layer(const BoundingBox &bb)
+{
+    ExPolygons layer;
+    for (int i = 0; i < 6; ++ i)
+        for (int j = 0; j < 4; ++ j) {
+            ExPolygon poly;
+            if ((i + j) % 2 == 0) {
+                poly = square_with_hole(4. + i + j);
+            } else {
+                const size_t n = 16 + 40 * j;
+                for (size_t k = 0; k < n; ++ k) {
+                    double a = 2. * PI * k / n;
+                    poly.contour.points.emplace_back(scaled(3. * std::cos(a)), scaled((1.5 + 0.3 * i) * std::sin(a)));
+                }
+            }
+            poly.translate(bb.min.x() + scaled(10. + 18. * i), bb.min.y() + scaled(10. + 15. * j));
+            poly.rotate(0.1 * (i + j), bb.center());
+            layer.emplace_back(std::move(poly));
+        }
+    return layer;
+}
+
+TEST_CASE("ScanlineRasterShouldMatchAGG", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+    ExPolygons layer = scanline_test_layer(bb);
+
+    for (double gamma : {1., 0.})
+        for (auto orientation : {sla::RasterBase::roLandscape, sla::RasterBase::roPortrait}) {
+            sla::Resolution r = res;
+            sla::PixelDim   pd = pixdim;
+            if (orientation == sla::RasterBase::roPortrait) {
+                std::swap(r.width_px, r.height_px);
+                std::swap(pd.w_mm, pd.h_mm);
+            }
+            sla::RasterBase::Trafo trafo{orientation, sla::RasterBase::MirrorX};
+
+            auto agg = sla::create_raster_grayscale_aa(r, pd, gamma, trafo, sla::RasterBackend::AGG);
+            auto scanline = sla::create_raster_grayscale_aa(r, pd, gamma, trafo, sla::RasterBackend::Scanline);
+            agg->draw(layer);
+            scanline->draw(layer);
+
+            auto &agg_rst = dynamic_cast<const sla::RasterGrayscaleAA &>(*agg);
+            auto &scanline_rst = dynamic_cast<const sla::ScanlineRaster &>(*scanline);
+
+            long   agg_sum = 0, scanline_sum = 0;
+            size_t num_white = 0, num_different = 0;
+            int    max_diff = 0;
+            for (size_t row = 0; row < r.height_px; ++ row)
+                for (size_t col = 0; col < r.width_px; ++ col) {
+                    int a = agg_rst.read_pixel(col, row);
+                    int b = scanline_rst.read_pixel(col, row);
+                    agg_sum += a;
+                    scanline_sum += b;
+                    num_white += a == FullWhite;
+                    num_different += a != b;
+                    max_diff = std::max(max_diff, std::abs(a - b));
+                }
+
+            INFO("gamma " << gamma << ", orientation " << orientation);
+            REQUIRE(num_white > 0);
+            REQUIRE(std::abs(agg_sum - scanline_sum) <= 0.001 * agg_sum);
+            if (gamma > 0)
+                // Anti-aliased edges differ just slightly.
+                REQUIRE(max_diff <= 16);
+            else
+                // Thresholded pixels may flip where the coverage is very close to one half.
+                REQUIRE(num_different <= num_white / 1000);
+        }
+}
+
+TEST_CASE("SLA layer rasterization", "[SLARasterOutput][.Benchmarks]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+    ExPolygons layer = scanline_test_layer(bb);
+
+    BENCHMARK("AGG") {
+        auto rst = sla::create_raster_grayscale_aa(res, pixdim, 1., {}, sla::RasterBackend::AGG);
+        rst->draw(layer);
+        return rst;
+    };
+    BENCHMARK("Scanline") {
+        auto rst = sla::create_raster_grayscale_aa(res, pixdim, 1., {}, sla::RasterBackend::Scanline);
+        rst->draw(layer);
+        return rst;
+    };
+}
 
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
@@ -225,3 +430,42 @@ TEST_CASE("Test concurrency")
 
     REQUIRE(s == Approx(ref));
 }
+
+TEST_CASE("Rotation scored on a decimated proxy matches the full search", "[SLARotfinder]")
+{
+    Model model;
+    ModelObject *mo = model.add_object();
+    mo->add_volume(TriangleMesh{its_subdivide(its_make_cube(10., 20., 40.), 2.f)});
+    mo->add_instance();
+
+    const size_t proxy_facecount = 100;
+    const indexed_triangle_set its = mo->raw_mesh().its;
+    REQUIRE(its.indices.size() > proxy_facecount);
+
+    // The area weighted misalignment of the faces with the axes, which is
+    // maximized by find_best_misalignment_rotation(). Symmetric rotations of
+    // the box are equally good, thus the scores are compared, not the
+    // rotations.
+    auto misalignment = [&its](const Vec2d &rot) {
+        Transform3d tr = Transform3d::Identity();
+        tr.rotate(Eigen::AngleAxisd(rot.y(), Vec3d::UnitY()));
+        tr.rotate(Eigen::AngleAxisd(rot.x(), Vec3d::UnitX()));
+
+        double score = 0.;
+        for (const stl_triangle_vertex_indices &face : its.indices) {
+            Vec3d p0 = tr * its.vertices[face(0)].cast<double>();
+            Vec3d p1 = tr * its.vertices[face(1)].cast<double>();
+            Vec3d p2 = tr * its.vertices[face(2)].cast<double>();
+            Vec3d n  = (p1 - p0).cross(p2 - p0);
+            score += n.norm() / 2. * n.normalized().lpNorm<1>();
+        }
+
+        return score;
+    };
+
+    Vec2d rot_full  = sla::find_best_misalignment_rotation(*mo, sla::RotOptimizeParams{}.proxy_facecount(0));
+    Vec2d rot_proxy = sla::find_best_misalignment_rotation(*mo, sla::RotOptimizeParams{}.proxy_facecount(proxy_facecount));
+
+    INFO("full: " << rot_full.transpose() << ", proxy: " << rot_proxy.transpose());
+    REQUIRE(misalignment(rot_proxy) == Approx(misalignment(rot_full)).epsilon(1e-6));
+}
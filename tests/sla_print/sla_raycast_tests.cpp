@@ -1,7 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <test_utils.hpp>
 
+#include <random>
+
 #include <libslic3r/AABBMesh.hpp>
 #include <libslic3r/SLA/Hollowing.hpp>
 
@@ -41,6 +44,80 @@ TEST_CASE("Raycaster - find intersections of a line and cylinder")
     REQUIRE(std::abs(out[1].first - std::sqrt(72.f)) < 0.001f);
 }
 
+// Coherent rays in packets: Rays of each packet start around a random point
+// outside or inside of the mesh and point in similar directions.
+static void random_ray_packets(const TriangleMesh &mesh, size_t num_packets,
+                               std::vector<Vec3d> &sources, std::vector<Vec3d> &dirs)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(-1., 1.);
+    auto rand_vec = [&rng, &unit]() { return Vec3d(unit(rng), unit(rng), unit(rng)); };
+
+    BoundingBoxf3 bb     = mesh.bounding_box();
+    Vec3d         center = bb.center();
+    double        r      = bb.size().norm();
+    for (size_t packet_idx = 0; packet_idx < num_packets; ++ packet_idx) {
+        Vec3d src = center + rand_vec().cwiseProduct(packet_idx % 2 ? bb.size() / 2 : Vec3d(r, r, r));
+        Vec3d dir = (center + rand_vec().cwiseProduct(bb.size() / 2) - src).normalized();
+        for (size_t i = 0; i < AABBMesh::RayPacketSize; ++ i) {
+            sources.emplace_back(src + 0.01 * r * rand_vec());
+            dirs.emplace_back((dir + 0.05 * rand_vec()).normalized());
+        }
+    }
+    // An incomplete packet at the end.
+    sources.emplace_back(center);
+    dirs.emplace_back(Vec3d::UnitZ());
+}
+
+TEST_CASE("Raycaster - batched queries give the same hits as single ones", "[sla_raycast]")
+{
+    TriangleMesh mesh = load_model("extruder_idler.obj");
+    AABBMesh     emesh{mesh};
+
+    std::vector<Vec3d> sources, dirs;
+    random_ray_packets(mesh, 1000, sources, dirs);
+
+    std::vector<AABBMesh::hit_result> hits = emesh.query_ray_hit_batch(sources, dirs);
+    REQUIRE(hits.size() == sources.size());
+
+    size_t num_hits = 0;
+    for (size_t i = 0; i < sources.size(); ++ i) {
+        AABBMesh::hit_result hit = emesh.query_ray_hit(sources[i], dirs[i]);
+        INFO("ray " << i);
+        REQUIRE(hits[i].is_hit() == hit.is_hit());
+        REQUIRE(hits[i].face() == hit.face());
+        REQUIRE(hits[i].distance() == hit.distance());
+        REQUIRE(hits[i].is_inside() == hit.is_inside());
+        REQUIRE(hits[i].source() == sources[i]);
+        REQUIRE(hits[i].direction() == dirs[i]);
+        if (hit.is_hit())
+            ++ num_hits;
+    }
+    // Both hits and misses are tested.
+    REQUIRE(num_hits > 0);
+    REQUIRE(num_hits < sources.size());
+}
+
+TEST_CASE("Raycaster - batched queries throughput", "[sla_raycast][.Benchmarks]")
+{
+    TriangleMesh mesh = load_model("extruder_idler.obj");
+    AABBMesh     emesh{mesh};
+
+    std::vector<Vec3d> sources, dirs;
+    random_ray_packets(mesh, 10000, sources, dirs);
+    std::vector<AABBMesh::hit_result> hits(sources.size());
+
+    BENCHMARK("Single rays") {
+        for (size_t i = 0; i < sources.size(); ++ i)
+            hits[i] = emesh.query_ray_hit(sources[i], dirs[i]);
+        return hits.front().distance();
+    };
+    BENCHMARK("Ray packets") {
+        emesh.query_ray_hit_batch(sources.data(), dirs.data(), sources.size(), hits.data());
+        return hits.front().distance();
+    };
+}
+
 #ifdef SLIC3R_HOLE_RAYCASTER
 // Create a simple scene with a 20mm cube and a big hole in the front wall 
 // with 5mm radius. Then shoot rays from interesting positions and see where